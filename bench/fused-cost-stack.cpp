@@ -0,0 +1,70 @@
+/// @file
+/// @brief Compare CostStack and FusedCostStack on a stage with many quadratic
+/// residual costs.
+
+#include "aligator/modelling/costs/fused-cost-stack.hpp"
+#include "aligator/modelling/costs/quad-state-cost.hpp"
+#include "aligator/modelling/linear-function.hpp"
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace aligator;
+
+using T = double;
+using context::MatrixXs;
+using context::VectorXs;
+using CostStack = CostStackTpl<T>;
+using FusedCostStack = FusedCostStackTpl<T>;
+
+/// 10 state costs, 3 control costs and 2 general residual costs.
+template <typename Stack> Stack define_stack(const int ndx, const int nu) {
+  auto space = std::make_shared<proxsuite::nlp::VectorSpaceTpl<T>>(ndx);
+  auto random_spd = [](int n) -> MatrixXs {
+    MatrixXs A = MatrixXs::Random(n, n);
+    return A * A.transpose() + MatrixXs::Identity(n, n);
+  };
+  std::vector<shared_ptr<CostAbstractTpl<T>>> comps;
+  for (int k = 0; k < 10; k++)
+    comps.push_back(std::make_shared<QuadraticStateCostTpl<T>>(
+        space, nu, VectorXs::Random(ndx), random_spd(ndx)));
+  for (int k = 0; k < 3; k++)
+    comps.push_back(std::make_shared<QuadraticControlCostTpl<T>>(
+        space, VectorXs::Random(nu), random_spd(nu)));
+  const int nr = 6;
+  for (int k = 0; k < 2; k++) {
+    auto lin = std::make_shared<LinearFunctionTpl<T>>(
+        MatrixXs::Random(nr, ndx), MatrixXs::Random(nr, nu),
+        MatrixXs::Zero(nr, ndx), VectorXs::Random(nr));
+    comps.push_back(std::make_shared<QuadraticResidualCostTpl<T>>(
+        space, lin, random_spd(nr)));
+  }
+  std::vector<T> weights(comps.size(), 1.);
+  return Stack(space, nu, comps, weights);
+}
+
+template <typename Stack> static void BM_cost_stack(benchmark::State &state) {
+  const int ndx = int(state.range(0));
+  const int nu = ndx / 2;
+  const Stack stack = define_stack<Stack>(ndx, nu);
+  auto data = stack.createData();
+  const VectorXs x0 = VectorXs::Random(ndx);
+  const VectorXs u0 = VectorXs::Random(nu);
+
+  for (auto _ : state) {
+    stack.evaluate(x0, u0, *data);
+    stack.computeGradients(x0, u0, *data);
+    stack.computeHessians(x0, u0, *data);
+    benchmark::DoNotOptimize(data->hess_.data());
+  }
+}
+
+static void Args(benchmark::internal::Benchmark *bench) {
+  bench->ArgName("ndx")->Arg(12)->Arg(36)->Arg(72)->Unit(
+      benchmark::kMicrosecond);
+}
+
+BENCHMARK_TEMPLATE(BM_cost_stack, CostStack)->Apply(Args);
+BENCHMARK_TEMPLATE(BM_cost_stack, FusedCostStack)->Apply(Args);
+
+BENCHMARK_MAIN();
@@ -5,11 +5,13 @@
 #include <benchmark/benchmark.h>
 
 #include "aligator/gar/riccati-impl.hpp"
+#include "aligator/gar/block-tridiagonal.hpp"
 #include "aligator/threads.hpp"
 
 #include "../tests/gar/test_util.hpp"
 
 using namespace aligator::gar;
+using aligator::BlkMatrix;
 
 static void BM_riccati_impl(benchmark::State &state) {
   const uint horz = (uint)state.range(0);
@@ -26,6 +28,77 @@ static void BM_riccati_impl(benchmark::State &state) {
 
 BENCHMARK(BM_riccati_impl);
 
+/// A symmetric indefinite block-tridiagonal system, similar to the condensed
+/// KKT system of the parallel Riccati solver.
+struct condensed_system {
+  std::vector<long> dims;
+  std::vector<MatrixXs> sub, diag, sup;
+  BlkMatrix<VectorXs, -1, 1> rhs;
+
+  condensed_system(uint nblocks, uint nx) : dims(nblocks, nx), rhs(dims) {
+    for (uint i = 0; i < nblocks; i++) {
+      MatrixXs d = sampleWishartDistributedMatrix(nx, nx + 1);
+      diag.push_back(i % 2 == 0 ? MatrixXs(-d) : d);
+    }
+    for (uint i = 0; i + 1 < nblocks; i++) {
+      sup.push_back(MatrixXs::NullaryExpr(nx, nx, normal_unary_op{}));
+      sub.push_back(sup.back().transpose());
+    }
+    rhs.matrix().setRandom();
+  }
+
+  /// Infinity-norm of the residual of a solution.
+  double residual(const BlkMatrix<VectorXs, -1, 1> &sol) const {
+    BlkMatrix<VectorXs, -1, 1> res = rhs;
+    blockTridiagMatMul(sub, diag, sup, sol, res, -1.0);
+    return infty_norm(res.matrix());
+  }
+};
+
+const uint nx_condensed = 36;
+
+static void BM_condensed_sequential(benchmark::State &state) {
+  const condensed_system sys((uint)state.range(0), nx_condensed);
+  using Dec = Eigen::BunchKaufman<MatrixXs>;
+  std::vector<Dec> facs;
+  for (long d : sys.dims)
+    facs.emplace_back(d);
+  std::vector<MatrixXs> sub, diag;
+  BlkMatrix<VectorXs, -1, 1> sol = sys.rhs;
+  for (auto _ : state) {
+    sub = sys.sub;
+    diag = sys.diag;
+    sol = sys.rhs.matrix();
+    symmetricBlockTridiagSolve(sub, diag, sys.sup, sol, facs);
+  }
+  state.counters["residual"] = sys.residual(sol);
+}
+
+static void BM_condensed_cyclic_reduction(benchmark::State &state) {
+  const uint num_threads = (uint)state.range(1);
+  const condensed_system sys((uint)state.range(0), nx_condensed);
+  BlockTridiagCyclicReduction<MatrixXs, Eigen::BunchKaufman<MatrixXs>> solver(
+      sys.dims);
+  aligator::ThreadPool pool(num_threads);
+  BlkMatrix<VectorXs, -1, 1> sol = sys.rhs;
+  for (auto _ : state) {
+    sol = sys.rhs.matrix();
+    solver.factorize(sys.diag, sys.sup, &pool, num_threads);
+    solver.solveInPlace(sol, &pool, num_threads);
+  }
+  state.counters["residual"] = sys.residual(sol);
+}
+
+// the condensed system has two blocks per leg
+BENCHMARK(BM_condensed_sequential)
+    ->RangeMultiplier(2)
+    ->Range(8, 128)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_condensed_cyclic_reduction)
+    ->ArgsProduct({{8, 16, 32, 64, 128}, {1, 4, 8, 16}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
 int main(int argc, char **argv) {
   aligator::omp::set_default_options(aligator::omp::get_available_threads());
 
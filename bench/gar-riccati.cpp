@@ -7,6 +7,11 @@
 #include "aligator/gar/proximal-riccati.hpp"
 #include "aligator/gar/parallel-solver.hpp"
 #include "aligator/gar/dense-riccati.hpp"
+#include "aligator/gar/fixed-size-riccati.hpp"
+#include "aligator/gar/mixed-precision-riccati.hpp"
+#include "aligator/gar/batched-riccati.hpp"
+#include "aligator/gar/cholmod-solver.hpp"
+#include "aligator/gar/banded-ldlt.hpp"
 #include "aligator/gar/utils.hpp"
 
 #include "aligator/threads.hpp"
@@ -31,6 +36,31 @@ static void BM_serial(benchmark::State &state) {
   }
 }
 
+/// Same as BM_serial, with each knot in its own allocation instead of the
+/// problem arena, to measure the gain of the contiguous storage.
+static void BM_serial_scattered(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  LQRProblemTpl<double> problem = generate_problem(x0, horz, nx, nu);
+  // interleave unrelated allocations so the knots are not adjacent
+  std::vector<VectorXs> spacers;
+  for (auto &knot : problem.stages) {
+    spacers.emplace_back(4096);
+    knot = LQRKnotTpl<double>(knot);
+  }
+  if (problem.isContiguous()) {
+    state.SkipWithError("knots are still in the arena");
+    return;
+  }
+  ProximalRiccatiSolver<double> solver(problem);
+  const double mu = 1e-11;
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  for (auto _ : state) {
+    solver.backward(mu, mu);
+    solver.forward(xs, us, vs, lbdas);
+  }
+}
+
 #ifdef ALIGATOR_MULTITHREADING
 template <uint NPROC> static void BM_parallel(benchmark::State &state) {
   uint horz = (uint)state.range(0);
@@ -59,6 +89,202 @@ static void BM_stagedense(benchmark::State &state) {
   }
 }
 
+static void BM_mixed_precision(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  const LQRProblemTpl<double> problem = generate_problem(x0, horz, nx, nu);
+  MixedPrecisionRiccatiSolver<double, float> solver(problem);
+  const double mu = 1e-11;
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  for (auto _ : state) {
+    solver.backward(mu, mu);
+    solver.forward(xs, us, vs, lbdas);
+  }
+  state.counters["refinement_steps"] = solver.numRefinementSteps;
+  state.counters["kkt_residual"] = solver.kktResidual;
+}
+
+static void BM_banded(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  const LQRProblemTpl<double> problem = generate_problem(x0, horz, nx, nu);
+  BandedLDLTSolver<double> solver(problem);
+  const double mu = 1e-11;
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  for (auto _ : state) {
+    solver.backward(mu, mu);
+    solver.forward(xs, us, vs, lbdas);
+  }
+  state.counters["bandwidth"] = double(solver.bandwidth());
+  state.counters["kkt_residual"] = solver.computeResidual();
+}
+
+#ifdef ALIGATOR_WITH_CHOLMOD
+template <CholmodFactorization Fact>
+static void BM_cholmod(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  const LQRProblemTpl<double> problem = generate_problem(x0, horz, nx, nu);
+  // the symbolic analysis is done once, outside of the timed loop
+  CholmodLqSolver<double> solver(problem, 1, Fact);
+  const double mu = 1e-11;
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  for (auto _ : state) {
+    solver.backward(mu, mu);
+    solver.forward(xs, us, vs, lbdas);
+  }
+  state.counters["kkt_residual"] = solver.computeSparseResidual();
+}
+#endif
+
+/// Small problem dimensions, for comparing dynamic and fixed-size kernels.
+const uint nx_small = 12;
+const uint nu_small = 4;
+
+static void BM_serial_small(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  VectorXs x0 = VectorXs::NullaryExpr(nx_small, normal_unary_op{});
+  const LQRProblemTpl<double> problem =
+      generate_problem(x0, horz, nx_small, nu_small);
+  ProximalRiccatiSolver<double> solver(problem);
+  const double mu = 1e-11;
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  for (auto _ : state) {
+    solver.backward(mu, mu);
+    solver.forward(xs, us, vs, lbdas);
+  }
+}
+
+static void BM_serial_small_fixed(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  VectorXs x0 = VectorXs::NullaryExpr(nx_small, normal_unary_op{});
+  const LQRProblemTpl<double> problem =
+      generate_problem(x0, horz, nx_small, nu_small);
+  ProximalRiccatiSolverFixed<double, nx_small, nu_small, 0> solver(problem);
+  const double mu = 1e-11;
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  for (auto _ : state) {
+    solver.backward(mu, mu);
+    solver.forward(xs, us, vs, lbdas);
+  }
+}
+
+/// Batch of small problems with dynamics E = -I, for comparing the batched
+/// solver to a loop of serial solvers.
+const uint batch_size = 64;
+
+static std::vector<LQRProblemTpl<double>> generate_batch(uint horz) {
+  std::vector<LQRProblemTpl<double>> problems;
+  for (uint i = 0; i < batch_size; i++) {
+    VectorXs x0 = VectorXs::NullaryExpr(nx_small, normal_unary_op{});
+    problems.push_back(generate_problem(x0, horz, nx_small, nu_small));
+    for (auto &knot : problems.back().stages) {
+      knot.E.setIdentity();
+      knot.E *= -1;
+    }
+  }
+  return problems;
+}
+
+static void BM_batch_serial(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  const auto problems = generate_batch(horz);
+  std::vector<std::unique_ptr<ProximalRiccatiSolver<double>>> solvers;
+  for (const auto &problem : problems)
+    solvers.push_back(
+        std::make_unique<ProximalRiccatiSolver<double>>(problem));
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problems[0]);
+  const double mu = 1e-11;
+  for (auto _ : state) {
+    for (auto &solver : solvers) {
+      solver->backward(mu, mu);
+      solver->forward(xs, us, vs, lbdas);
+    }
+  }
+}
+
+template <int Width> static void BM_batch_simd(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  const auto problems = generate_batch(horz);
+  std::vector<const LQRProblemTpl<double> *> ptrs;
+  for (const auto &problem : problems)
+    ptrs.push_back(&problem);
+  BatchedRiccatiSolver<double, Width> solver(ptrs);
+  const double mu = 1e-11;
+  for (auto _ : state) {
+    solver.backward(mu, mu);
+    solver.forward();
+  }
+}
+
+#ifdef ALIGATOR_MULTITHREADING
+/// Multi-phase problem: the first third of the knots carry constraints (e.g.
+/// contacts), the rest have none.
+static LQRProblemTpl<double> generate_multiphase_problem(uint horz) {
+  const uint nc = 24;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  LQRProblemTpl<double> problem = generate_problem(x0, horz, nx, nu);
+  for (uint t = 0; t < horz / 3; t++) {
+    const LQRKnotTpl<double> &kn = problem.stages[t];
+    LQRKnotTpl<double> ck(kn.nx, kn.nu, nc, kn.nx2, kn.nth);
+    ck.Q = kn.Q;
+    ck.S = kn.S;
+    ck.R = kn.R;
+    ck.q = kn.q;
+    ck.r = kn.r;
+    ck.A = kn.A;
+    ck.B = kn.B;
+    ck.E = kn.E;
+    ck.f = kn.f;
+    ck.C.setRandom();
+    ck.D.setRandom();
+    ck.d.setRandom();
+    problem.stages[t] = std::move(ck);
+  }
+  problem.makeContiguous();
+  return problem;
+}
+
+/// Ratio of the largest estimated leg cost to the mean. As in
+/// ParallelRiccatiSolver, the knots of all legs but the last one are
+/// parameterized by the initial state of their leg. The cost model is given
+/// explicitly, since the solver parameterizes the knots of its own legs.
+static double leg_imbalance(const LQRProblemTpl<double> &problem,
+                            const std::vector<workrange_t> &legs) {
+  double total = 0., max_leg = 0.;
+  for (std::size_t i = 0; i < legs.size(); i++) {
+    const bool last = i + 1 == legs.size();
+    double c = 0.;
+    for (uint t = legs[i].beg; t < legs[i].end; t++) {
+      const auto &knot = problem.stages[t];
+      c += estimate_knot_cost(knot, last ? 0. : double(knot.nx));
+    }
+    total += c;
+    max_leg = std::max(max_leg, c);
+  }
+  return max_leg * double(legs.size()) / total;
+}
+
+template <uint NPROC>
+static void BM_parallel_multiphase(benchmark::State &state) {
+  uint horz = (uint)state.range(0);
+  LQRProblemTpl<double> problem = generate_multiphase_problem(horz);
+  std::vector<workrange_t> uniform_legs;
+  for (uint i = 0; i < NPROC; i++)
+    uniform_legs.push_back(get_work(horz, i, NPROC));
+
+  ParallelRiccatiSolver<double> solver(problem, NPROC);
+  const double mu = 1e-11;
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  for (auto _ : state) {
+    solver.backward(mu, mu);
+    solver.forward(xs, us, vs, lbdas);
+  }
+  state.counters["imbalance"] = leg_imbalance(problem, solver.legs);
+  state.counters["imbalance_uniform"] = leg_imbalance(problem, uniform_legs);
+}
+#endif
+
 static void customArgs(benchmark::internal::Benchmark *b) {
   for (uint e = 4; e <= 10; e++) {
     b->Arg(1 << e);
@@ -68,12 +294,28 @@ static void customArgs(benchmark::internal::Benchmark *b) {
 }
 
 BENCHMARK(BM_serial)->Apply(customArgs);
+BENCHMARK(BM_serial_scattered)->Apply(customArgs);
 BENCHMARK(BM_stagedense)->Apply(customArgs);
+BENCHMARK(BM_mixed_precision)->Apply(customArgs);
+BENCHMARK(BM_banded)->Apply(customArgs);
+#ifdef ALIGATOR_WITH_CHOLMOD
+BENCHMARK_TEMPLATE(BM_cholmod, CholmodFactorization::SIMPLICIAL_LDLT)
+    ->Apply(customArgs);
+BENCHMARK_TEMPLATE(BM_cholmod, CholmodFactorization::SUPERNODAL_LLT)
+    ->Apply(customArgs);
+#endif
+BENCHMARK(BM_serial_small)->Apply(customArgs);
+BENCHMARK(BM_serial_small_fixed)->Apply(customArgs);
+BENCHMARK(BM_batch_serial)->Apply(customArgs);
+BENCHMARK_TEMPLATE(BM_batch_simd, 4)->Apply(customArgs);
+BENCHMARK_TEMPLATE(BM_batch_simd, 8)->Apply(customArgs);
 #ifdef ALIGATOR_MULTITHREADING
 BENCHMARK_TEMPLATE(BM_parallel, 2)->Apply(customArgs);
 BENCHMARK_TEMPLATE(BM_parallel, 3)->Apply(customArgs);
 BENCHMARK_TEMPLATE(BM_parallel, 4)->Apply(customArgs);
 BENCHMARK_TEMPLATE(BM_parallel, 6)->Apply(customArgs);
+BENCHMARK_TEMPLATE(BM_parallel_multiphase, 4)->Apply(customArgs);
+BENCHMARK_TEMPLATE(BM_parallel_multiphase, 8)->Apply(customArgs);
 #endif
 
 int main(int argc, char **argv) {
@@ -43,8 +43,15 @@ struct SolverVisitor : bp::def_visitor<SolverVisitor<SolverType>> {
                        &SolverType::force_initial_condition_,
                        "Set x0 to be fixed to the initial condition.")
         .add_property("num_threads", &SolverType::getNumThreads)
+        .def_readwrite("threading_backend", &SolverType::threading_backend_,
+                       "Threading backend. Takes effect on the next call to "
+                       "setup().")
+        .def_readwrite("pin_threads", &SolverType::pin_threads_,
+                       "Pin the worker threads of the thread pool to CPU "
+                       "cores (Linux only). Takes effect on the next call to "
+                       "setup().")
         .def("setNumThreads", &SolverType::setNumThreads,
-             ("self"_a, "num_threads"))
+             ("self"_a, "num_threads", "pin_threads"_a = false))
         .def("getResults", &SolverType::getResults, ("self"_a),
              deprecation_warning_policy<DeprecationType::DEPRECATION,
                                         bp::return_internal_reference<>>(
@@ -29,7 +29,34 @@ struct FunctionDataWrapper : StageFunctionData, bp::wrapper<StageFunctionData> {
   using StageFunctionData::StageFunctionData;
 };
 
+static void exposeJacobianStructure() {
+  bp::enum_<JacobianBlockType>("JacobianBlockType",
+                               "Known sparsity pattern of a Jacobian block.")
+      .value("ZERO", JacobianBlockType::ZERO)
+      .value("IDENTITY", JacobianBlockType::IDENTITY)
+      .value("DIAGONAL", JacobianBlockType::DIAGONAL)
+      .value("SELECTION", JacobianBlockType::SELECTION)
+      .value("DENSE", JacobianBlockType::DENSE);
+
+  bp::class_<JacobianBlockStructure>(
+      "JacobianBlockStructure", "Structure of a block of a Jacobian matrix.",
+      bp::init<>(bp::args("self")))
+      .def_readwrite("type", &JacobianBlockStructure::type)
+      .def_readwrite("indices", &JacobianBlockStructure::indices,
+                     "Column of the nonzero entry of each row (SELECTION).")
+      .def("isZero", &JacobianBlockStructure::isZero, "self"_a);
+
+  bp::class_<JacobianStructure>(
+      "JacobianStructure",
+      "Structure of the Jacobians (Jx, Ju, Jy) of a stage function.",
+      bp::init<>(bp::args("self")))
+      .def_readwrite("x", &JacobianStructure::x)
+      .def_readwrite("u", &JacobianStructure::u)
+      .def_readwrite("y", &JacobianStructure::y);
+}
+
 void exposeFunctionBase() {
+  exposeJacobianStructure();
 
   bp::register_ptr_to_python<FunctionPtr>();
 
@@ -53,6 +80,8 @@ void exposeFunctionBase() {
       .def_readonly("ndx2", &StageFunction::ndx2, "Next state space.")
       .def_readonly("nu", &StageFunction::nu, "Control dimension.")
       .def_readonly("nr", &StageFunction::nr, "Function codimension.")
+      .def_readwrite("jac_structure", &StageFunction::jac_structure_,
+                     "Structure of the Jacobians, exploited by the solvers.")
       .def(SlicingVisitor<StageFunction>())
       .def(CreateDataPolymorphicPythonVisitor<StageFunction,
                                               PyStageFunction<>>());
@@ -170,9 +199,24 @@ void exposeFunctions() {
       .def(bp::init<const ConstMatrixRef, const ConstMatrixRef,
                     const ConstVectorRef>("Constructor with C=0.",
                                           bp::args("self", "A", "B", "d")))
-      .def_readonly("A", &LinearFunction::A_)
-      .def_readonly("B", &LinearFunction::B_)
-      .def_readonly("C", &LinearFunction::C_)
+      .add_property(
+          "A",
+          +[](const LinearFunction &f) -> context::MatrixXs {
+            return f.getA();
+          },
+          &LinearFunction::setA, "Matrix A (setting it updates jac_structure).")
+      .add_property(
+          "B",
+          +[](const LinearFunction &f) -> context::MatrixXs {
+            return f.getB();
+          },
+          &LinearFunction::setB, "Matrix B (setting it updates jac_structure).")
+      .add_property(
+          "C",
+          +[](const LinearFunction &f) -> context::MatrixXs {
+            return f.getC();
+          },
+          &LinearFunction::setC, "Matrix C (setting it updates jac_structure).")
       .def_readonly("d", &LinearFunction::d_);
 
   bp::class_<ControlBoxFunctionTpl<Scalar>, bp::bases<StageFunction>>(
@@ -17,6 +17,14 @@ void exposeProblem() {
   using context::TrajOptData;
   using context::TrajOptProblem;
   using context::UnaryFunction;
+  using context::VectorOfVectors;
+
+  using evaluate_t = Scalar (TrajOptProblem::*)(
+      const VectorOfVectors &, const VectorOfVectors &, TrajOptData &,
+      std::size_t) const;
+  using compute_derivatives_t = void (TrajOptProblem::*)(
+      const VectorOfVectors &, const VectorOfVectors &, TrajOptData &,
+      std::size_t, bool) const;
 
   bp::class_<TrajOptProblem>("TrajOptProblem", "Define a shooting problem.",
                              bp::no_init)
@@ -58,13 +66,15 @@ void exposeProblem() {
       .def("removeTerminalConstraint",
            &TrajOptProblem::removeTerminalConstraints, "self"_a,
            "Remove all terminal constraints.")
-      .def("evaluate", &TrajOptProblem::evaluate,
-           ("self"_a, "xs", "us", "prob_data", "num_threads"_a = 1),
-           "Evaluate the problem costs, dynamics, and constraints.")
-      .def("computeDerivatives", &TrajOptProblem::computeDerivatives,
-           ("self"_a, "xs", "us", "prob_data", "num_threads"_a = 1,
-            "compute_second_order"_a = true),
-           "Evaluate the problem derivatives. Call `evaluate()` first.")
+      .def<evaluate_t>(
+          "evaluate", &TrajOptProblem::evaluate,
+          ("self"_a, "xs", "us", "prob_data", "num_threads"_a = 1),
+          "Evaluate the problem costs, dynamics, and constraints.")
+      .def<compute_derivatives_t>(
+          "computeDerivatives", &TrajOptProblem::computeDerivatives,
+          ("self"_a, "xs", "us", "prob_data", "num_threads"_a = 1,
+           "compute_second_order"_a = true),
+          "Evaluate the problem derivatives. Call `evaluate()` first.")
       .def("replaceStageCircular", &TrajOptProblem::replaceStageCircular,
            ("self"_a, "model"),
            "Circularly replace the last stage in the problem, dropping the "
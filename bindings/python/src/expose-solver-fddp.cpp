@@ -80,7 +80,11 @@ void exposeFDDP() {
       .def_readwrite("preg", &SolverFDDP::preg_)
       .def(SolverVisitor<SolverFDDP>())
       .def("run", &SolverFDDP::run,
-           ("self"_a, "problem", "xs_init", "us_init"));
+           ("self"_a, "problem", "xs_init", "us_init"))
+      .def("shiftAndResume", &SolverFDDP::shiftAndResume,
+           ("self"_a, "problem", "stage"),
+           "Drop the first stage of the problem, append the given stage, "
+           "shift the solver data and resume solving (receding horizon).");
 }
 
 } // namespace python
@@ -5,6 +5,7 @@
 #include "aligator/python/solvers.hpp"
 
 #include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/proxddp/batch-solver.hpp"
 
 #include <eigenpy/std-unique-ptr.hpp>
 
@@ -32,6 +33,8 @@ void exposeProxDDP() {
       .value("LQ_SOLVER_SERIAL", LQSolverChoice::SERIAL)
       .value("LQ_SOLVER_PARALLEL", LQSolverChoice::PARALLEL)
       .value("LQ_SOLVER_STAGEDENSE", LQSolverChoice::STAGEDENSE)
+      .value("LQ_SOLVER_CHOLMOD", LQSolverChoice::CHOLMOD)
+      .value("LQ_SOLVER_BANDED", LQSolverChoice::BANDED)
       .export_values();
 
   using ProxScaler = ConstraintProximalScalerTpl<Scalar>;
@@ -89,6 +92,8 @@ void exposeProxDDP() {
       .def_readonly("dlams", &Workspace::dlams)
       .def_readonly("trial_vs", &Workspace::trial_vs)
       .def_readonly("trial_lams", &Workspace::trial_lams)
+      .def_readonly("trial_alpha", &Workspace::trial_alpha,
+                    "Step size of the current trial point.")
       .def_readonly("lams_plus", &Workspace::lams_plus)
       .def_readonly("lams_pdal", &Workspace::lams_pdal)
       .def_readonly("vs_plus", &Workspace::vs_plus)
@@ -130,6 +135,9 @@ void exposeProxDDP() {
       .def_readwrite("max_refinement_steps", &SolverType::maxRefinementSteps_)
       .def_readwrite("refinement_threshold", &SolverType::refinementThreshold_)
       .def_readwrite("linear_solver_choice", &SolverType::linear_solver_choice)
+      .def_readwrite("lq_num_legs", &SolverType::lq_num_legs_,
+                     "Number of legs for the parallel linear solver (0 for "
+                     "one leg per thread).")
       .def_readwrite("multiplier_update_mode",
                      &SolverType::multiplier_update_mode)
       .def_readwrite("mu_init", &SolverType::mu_init,
@@ -145,8 +153,15 @@ void exposeProxDDP() {
       .def_readwrite("max_al_iters", &SolverType::max_al_iters,
                      "Maximum number of AL iterations.")
       .def_readwrite("ls_mode", &SolverType::ls_mode, "Linesearch mode.")
+      .def_readwrite("ls_params", &SolverType::ls_params,
+                     "Linesearch parameters.")
       .def_readwrite("sa_strategy", &SolverType::sa_strategy,
                      "StepAcceptance strategy.")
+      .def_readwrite("ls_num_candidates", &SolverType::ls_num_candidates_,
+                     "Number of step sizes evaluated concurrently by the "
+                     "linesearch (takes effect in setup()). The candidates are "
+                     "the powers of ls_params.contraction_min, whatever "
+                     "ls_params.interp_type.")
       .def_readwrite("rollout_type", &SolverType::rollout_type_,
                      "Rollout type.")
       .def_readwrite("dual_weight", &SolverType::dual_weight,
@@ -174,7 +189,80 @@ void exposeProxDDP() {
            prox_run_overloads(
                ("self"_a, "problem", "xs_init", "us_init", "lams_init"),
                "Run the algorithm. Can receive initial guess for "
-               "multiplier trajectory."));
+               "multiplier trajectory."))
+      .def("shiftAndResume", &SolverType::shiftAndResume,
+           ("self"_a, "problem", "stage"),
+           "Drop the first stage of the problem, append the given stage, "
+           "shift the solver data and resume solving (receding horizon). "
+           "Penalty parameters and tolerances are kept.")
+      .def("shiftHorizon", &SolverType::shiftHorizon,
+           ("self"_a, "problem", "stage"),
+           "Drop the first stage of the problem, append the given stage and "
+           "shift the solver data and solution accordingly.")
+      .def("rtiPreparation", &SolverType::rtiPreparation,
+           ("self"_a, "problem"),
+           "Real-time iteration: linearize the problem around the current "
+           "solution and factorize the LQ subproblem.")
+      .def("rtiFeedback", &SolverType::rtiFeedback,
+           ("self"_a, "problem", "x0"),
+           "Real-time iteration: set the new initial state and take a full "
+           "step, using the factorization from rtiPreparation().")
+      .def_readonly("rti_preparation_time",
+                    &SolverType::rti_preparation_time_,
+                    "Duration of the last preparation phase (microseconds).")
+      .def_readonly("rti_feedback_time", &SolverType::rti_feedback_time_,
+                    "Duration of the last feedback phase (microseconds).");
+
+  using BatchSolverType = SolverProxDDPBatchTpl<Scalar>;
+  using ProblemVec = std::vector<shared_ptr<TrajOptProblem>>;
+  StdVectorPythonVisitor<ProblemVec, true>::expose("StdVec_TrajOptProblem");
+
+  bp::class_<BatchSolverType, boost::noncopyable>(
+      "SolverProxDDPBatch",
+      "Solve a batch of independent problems concurrently, using one "
+      "SolverProxDDP instance per problem.",
+      bp::init<std::size_t, Scalar, Scalar, Scalar, std::size_t, VerboseLevel,
+               HessianApprox>(
+          ("self"_a, "batch_size", "tol"_a = 1e-6, "mu_init"_a = 1e-2,
+           "rho_init"_a = 0., "max_iters"_a = 1000,
+           "verbose"_a = VerboseLevel::QUIET,
+           "hess_approx"_a = HessianApprox::GAUSS_NEWTON)))
+      .def_readwrite("warm_start", &BatchSolverType::warm_start_,
+                     "Warm-start each solver from its previous solution.")
+      .add_property("size", &BatchSolverType::size)
+      .def("setNumThreads", &BatchSolverType::setNumThreads,
+           ("self"_a, "num_threads", "pin_threads"_a = false))
+      .add_property("num_threads", &BatchSolverType::getNumThreads)
+      .add_property("pin_threads", &BatchSolverType::getPinThreads)
+      .def("getSolver",
+           +[](BatchSolverType &b, std::size_t i) -> SolverType & {
+             if (i >= b.size()) {
+               PyErr_SetString(PyExc_IndexError, "Index out of bounds.");
+               bp::throw_error_already_set();
+             }
+             return b.getSolver(i);
+           },
+           ("self"_a, "i"), bp::return_internal_reference<>())
+      .def("getResults",
+           +[](const BatchSolverType &b, std::size_t i) -> const Results & {
+             if (i >= b.size()) {
+               PyErr_SetString(PyExc_IndexError, "Index out of bounds.");
+               bp::throw_error_already_set();
+             }
+             return b.getResults(i);
+           },
+           ("self"_a, "i"), bp::return_internal_reference<>())
+      .def<void (BatchSolverType::*)(const ProblemVec &)>(
+          "setup", &BatchSolverType::setup, ("self"_a, "problems"),
+          "Allocate one solver per problem.")
+      .def<void (BatchSolverType::*)(const TrajOptProblem &)>(
+          "setup", &BatchSolverType::setup, ("self"_a, "problem"),
+          "Allocate the batch for copies of a problem with distinct initial "
+          "states.")
+      .def<bool (BatchSolverType::*)()>("run", &BatchSolverType::run, "self"_a)
+      .def<bool (BatchSolverType::*)(const context::VectorOfVectors &)>(
+          "run", &BatchSolverType::run, ("self"_a, "x0s"),
+          "Set the initial state of each problem, then solve the batch.");
 }
 
 } // namespace python
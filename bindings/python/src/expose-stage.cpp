@@ -18,6 +18,8 @@ void exposeStage() {
   using context::Scalar;
   using context::StageModel;
   using StageData = StageDataTpl<Scalar>;
+  using StageCacheModel = StageCacheModelTpl<Scalar>;
+  using StageCacheData = StageCacheDataTpl<Scalar>;
 
   using CostPtr = shared_ptr<context::CostAbstract>;
   using DynamicsPtr = shared_ptr<context::DynamicsModel>;
@@ -27,6 +29,23 @@ void exposeStage() {
   StdVectorPythonVisitor<std::vector<shared_ptr<StageModel>>, true>::expose(
       "StdVec_StageModel");
 
+  bp::register_ptr_to_python<shared_ptr<StageCacheModel>>();
+  bp::class_<StageCacheModel, boost::noncopyable>(
+      "StageCacheModel",
+      "Base class for the quantities shared by the constraints and costs of a "
+      "stage.",
+      bp::no_init)
+      .def("evaluate", &StageCacheModel::evaluate,
+           bp::args("self", "x", "data"))
+      .def("computeDerivatives", &StageCacheModel::computeDerivatives,
+           bp::args("self", "x", "data"))
+      .def("createData", &StageCacheModel::createData, bp::args("self"));
+
+  bp::register_ptr_to_python<shared_ptr<StageCacheData>>();
+  bp::class_<StageCacheData, boost::noncopyable>(
+      "StageCacheData", "Base class for the data of a StageCacheModel.",
+      bp::no_init);
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
   bp::register_ptr_to_python<shared_ptr<StageModel>>();
@@ -46,6 +65,10 @@ void exposeStage() {
       .def_readonly("constraints", &StageModel::constraints_,
                     "Get the set of constraints.")
       .def_readonly("dynamics", &StageModel::dynamics_, "Stage dynamics.")
+      .def_readwrite("cache_model", &StageModel::cache_model_,
+                     "Quantities shared by the constraints and costs of the "
+                     "stage (optional). Set it before creating the stage "
+                     "data.")
       .add_property("xspace",
                     bp::make_function(&StageModel::xspace,
                                       bp::return_internal_reference<>()),
@@ -104,6 +127,7 @@ void exposeStage() {
       .def_readonly("cost_data", &StageData::cost_data)
       .def_readwrite("dynamics_data", &StageData::dynamics_data)
       .def_readwrite("constraint_data", &StageData::constraint_data)
+      .def_readonly("cache_data", &StageData::cache_data)
       .def(ClonePythonVisitor<StageData>());
 }
 
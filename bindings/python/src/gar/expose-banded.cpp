@@ -0,0 +1,37 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#include "aligator/python/fwd.hpp"
+
+#include "aligator/gar/banded-ldlt.hpp"
+
+namespace aligator::python {
+using namespace gar;
+using context::Scalar;
+using riccati_base_t = RiccatiSolverBase<Scalar>;
+using lqr_t = LQRProblemTpl<context::Scalar>;
+using banded_solver_t = BandedLDLTSolver<Scalar>;
+
+void exposeBandedSolver() {
+
+  bp::class_<banded_solver_t, bp::bases<riccati_base_t>, boost::noncopyable>(
+      "BandedLDLTSolver",
+      "Solver for the LQ problem which factorizes its KKT matrix as a band "
+      "matrix, with an unpivoted LDLT factorization and iterative refinement.",
+      bp::no_init)
+      .def(bp::init<const lqr_t &, uint>(
+          ("self"_a, "problem", "numRefinementSteps"_a = 1)))
+      .def_readonly("kktBand", &banded_solver_t::kktBand,
+                    "Lower band of the KKT matrix, in the order of the "
+                    "factorization.")
+      .def_readonly("kktRhs", &banded_solver_t::kktRhs)
+      .def_readonly("kktSol", &banded_solver_t::kktSol)
+      .add_property("bandwidth", &banded_solver_t::bandwidth)
+      .add_property("residual", &banded_solver_t::computeResidual,
+                    "Residual of the KKT system at the last solution.")
+      .add_property(
+          "num_perturbed_pivots",
+          +[](const banded_solver_t &s) { return s.ldlt.numPerturbedPivots; })
+      .def_readwrite("numRefinementSteps",
+                     &banded_solver_t::numRefinementSteps);
+}
+
+} // namespace aligator::python
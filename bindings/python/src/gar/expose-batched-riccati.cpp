@@ -0,0 +1,47 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#include "aligator/python/fwd.hpp"
+#include "aligator/gar/batched-riccati.hpp"
+
+namespace aligator::python {
+using namespace gar;
+using context::Scalar;
+using lqr_t = LQRProblemTpl<Scalar>;
+using batched_solver_t = BatchedRiccatiSolver<Scalar>;
+
+static batched_solver_t *make_batched_solver(const bp::list &problems,
+                                             uint num_threads) {
+  std::vector<const lqr_t *> ptrs;
+  for (long i = 0; i < bp::len(problems); i++)
+    ptrs.push_back(&bp::extract<const lqr_t &>(problems[i])());
+  return new batched_solver_t(ptrs, num_threads);
+}
+
+static void init_batched_solver(bp::object self, const bp::list &problems,
+                                uint num_threads) {
+  bp::object ctor = bp::make_constructor(make_batched_solver);
+  ctor(self, problems, num_threads);
+  // the solver holds pointers to the problems: keep them alive
+  self.attr("problems") = bp::tuple(problems);
+}
+
+void exposeBatchedRiccati() {
+  bp::class_<batched_solver_t, boost::noncopyable>(
+      "BatchedRiccatiSolver",
+      "Riccati solver for a batch of LQ problems with the same dimensions, "
+      "vectorized across the problems.",
+      bp::no_init)
+      .def("__init__", init_batched_solver,
+           ("self"_a, "problems", "num_threads"_a = 1))
+      .def("backward", &batched_solver_t::backward,
+           ("self"_a, "mudyn", "mueq"))
+      .def("forward", &batched_solver_t::forward, ("self"_a))
+      .def("getSolution", &batched_solver_t::getSolution,
+           ("self"_a, "i", "xs", "us", "vs", "lbdas"),
+           "Get the solution of problem i from the last forward() call.")
+      .add_property("num_problems", &batched_solver_t::numProblems)
+      .add_property("num_groups", &batched_solver_t::numGroups)
+      .def_readwrite("num_threads", &batched_solver_t::num_threads)
+      .setattr("width", int(batched_solver_t::Width));
+}
+
+} // namespace aligator::python
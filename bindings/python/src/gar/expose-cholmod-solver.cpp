@@ -4,22 +4,29 @@
 namespace aligator::python {
 
 using lqr_t = gar::LQRProblemTpl<context::Scalar>;
+using riccati_base_t = gar::RiccatiSolverBase<context::Scalar>;
 using cholmod_solver_t = gar::CholmodLqSolver<context::Scalar>;
+using gar::CholmodFactorization;
 
 void exposeCholmodSolver() {
-  bp::class_<cholmod_solver_t, boost::noncopyable>(
+  bp::enum_<CholmodFactorization>("CholmodFactorization")
+      .value("SIMPLICIAL_LDLT", CholmodFactorization::SIMPLICIAL_LDLT)
+      .value("SUPERNODAL_LLT", CholmodFactorization::SUPERNODAL_LLT)
+      .export_values();
+
+  bp::class_<cholmod_solver_t, bp::bases<riccati_base_t>, boost::noncopyable>(
       "CholmodLqSolver",
-      "A wrapper for CHOLMOD to solve the linear system for the LQ step.",
+      "A wrapper for CHOLMOD to solve the linear system for the LQ step. The "
+      "symbolic analysis of the KKT matrix is computed once, at construction.",
       bp::no_init)
-      .def(bp::init<const lqr_t &, uint>(
-          ("self"_a, "problem", "numRefinementSteps"_a = 1)))
+      .def(bp::init<const lqr_t &, uint, CholmodFactorization>(
+          ("self"_a, "problem", "numRefinementSteps"_a = 1,
+           "factorization"_a = CholmodFactorization::SIMPLICIAL_LDLT)))
       .def_readonly("kktMatrix", &cholmod_solver_t::kktMatrix)
       .def_readonly("kktRhs", &cholmod_solver_t::kktRhs)
-      .def("backward", &cholmod_solver_t::backward, ("self"_a, "mudyn", "mueq"))
-      .def("forward", &cholmod_solver_t::forward,
-           ("self"_a, "xs", "us", "vs", "lbdas"))
       .add_property("sparse_residual", &cholmod_solver_t::computeSparseResidual,
                     "Sparse problem residual.")
+      .add_property("factorization", &cholmod_solver_t::factorization)
       .def_readonly("cholmod", &cholmod_solver_t::cholmod)
       .def_readwrite("numRefinementSteps",
                      &cholmod_solver_t::numRefinementSteps);
@@ -61,6 +61,28 @@ void exposeParallelSolver();
 void exposeDenseSolver();
 // fwd-declare exposeProxRiccati()
 void exposeProxRiccati();
+// fwd-declare exposeBatchedRiccati()
+void exposeBatchedRiccati();
+// fwd-declare exposeBandedSolver()
+void exposeBandedSolver();
+
+// The knot data are Eigen::Map objects into the knot (or problem) storage:
+// expose them as writable references, with the knot kept alive by the
+// returned array. makeContiguous() and addParameterization() reallocate the
+// storage, which invalidates the arrays obtained before the call.
+#define KNOT_DATA_GETTER(name)                                                 \
+  bp::make_function(                                                           \
+      +[](knot_t &self) -> Eigen::Ref<decltype(knot_t::name)::PlainObject> {   \
+        return self.name;                                                      \
+      },                                                                       \
+      bp::with_custodian_and_ward_postcall<0, 1>())
+#define KNOT_DATA_SETTER(name)                                                 \
+  +[](knot_t &self,                                                            \
+      const Eigen::Ref<const decltype(knot_t::name)::PlainObject> &value) {    \
+    if (value.rows() != self.name.rows() || value.cols() != self.name.cols())  \
+      ALIGATOR_RUNTIME_ERROR("Wrong dimensions for knot data.");               \
+    self.name = value;                                                         \
+  }
 
 void exposeGAR() {
 
@@ -77,25 +99,28 @@ void exposeGAR() {
       .def_readonly("nx2", &knot_t::nx2)
       .def_readonly("nth", &knot_t::nth)
       //
-      .def_readwrite("Q", &knot_t::Q)
-      .def_readwrite("S", &knot_t::S)
-      .def_readwrite("R", &knot_t::R)
-      .def_readwrite("q", &knot_t::q)
-      .def_readwrite("r", &knot_t::r)
+      .add_property("Q", KNOT_DATA_GETTER(Q), KNOT_DATA_SETTER(Q))
+      .add_property("S", KNOT_DATA_GETTER(S), KNOT_DATA_SETTER(S))
+      .add_property("R", KNOT_DATA_GETTER(R), KNOT_DATA_SETTER(R))
+      .add_property("q", KNOT_DATA_GETTER(q), KNOT_DATA_SETTER(q))
+      .add_property("r", KNOT_DATA_GETTER(r), KNOT_DATA_SETTER(r))
       //
-      .def_readwrite("A", &knot_t::A)
-      .def_readwrite("B", &knot_t::B)
-      .def_readwrite("E", &knot_t::E)
-      .def_readwrite("f", &knot_t::f)
+      .add_property("A", KNOT_DATA_GETTER(A), KNOT_DATA_SETTER(A))
+      .add_property("B", KNOT_DATA_GETTER(B), KNOT_DATA_SETTER(B))
+      .add_property("E", KNOT_DATA_GETTER(E), KNOT_DATA_SETTER(E))
+      .add_property("f", KNOT_DATA_GETTER(f), KNOT_DATA_SETTER(f))
       //
-      .def_readwrite("C", &knot_t::C)
-      .def_readwrite("D", &knot_t::D)
-      .def_readwrite("d", &knot_t::d)
+      .add_property("C", KNOT_DATA_GETTER(C), KNOT_DATA_SETTER(C))
+      .add_property("D", KNOT_DATA_GETTER(D), KNOT_DATA_SETTER(D))
+      .add_property("d", KNOT_DATA_GETTER(d), KNOT_DATA_SETTER(d))
       //
-      .def_readwrite("Gth", &knot_t::Gth)
-      .def_readwrite("Gx", &knot_t::Gx)
-      .def_readwrite("Gu", &knot_t::Gu)
-      .def_readwrite("gamma", &knot_t::gamma)
+      .add_property("Gth", KNOT_DATA_GETTER(Gth), KNOT_DATA_SETTER(Gth))
+      .add_property("Gx", KNOT_DATA_GETTER(Gx), KNOT_DATA_SETTER(Gx))
+      .add_property("Gu", KNOT_DATA_GETTER(Gu), KNOT_DATA_SETTER(Gu))
+      .add_property("gamma", KNOT_DATA_GETTER(gamma), KNOT_DATA_SETTER(gamma))
+      .def("updateStructure", &knot_t::updateStructure, ("self"_a),
+           "Detect the structure of the knot data (e.g. E = -I) for the "
+           "Riccati kernels to exploit.")
       //
       .def(CopyableVisitor<knot_t>())
       .def(PrintableVisitor<knot_t>());
@@ -115,6 +140,10 @@ void exposeGAR() {
       .def("addParameterization", &lqr_t::addParameterization,
            ("self"_a, "nth"))
       .add_property("ntheta", &lqr_t::ntheta)
+      .def("makeContiguous", &lqr_t::makeContiguous, ("self"_a),
+           "Move the data of all knots to a single contiguous buffer.")
+      .add_property("isContiguous", &lqr_t::isContiguous,
+                    "Whether all the knots are stored in the problem arena.")
       .def("evaluate", &lqr_t::evaluate,
            ("self"_a, "xs", "us", "theta"_a = std::nullopt),
            "Evaluate the problem objective.")
@@ -142,6 +171,8 @@ void exposeGAR() {
   exposeDenseSolver();
   exposeParallelSolver();
   exposeProxRiccati();
+  exposeBatchedRiccati();
+  exposeBandedSolver();
 }
 
 } // namespace aligator::python
@@ -13,13 +13,31 @@ using riccati_base_t = RiccatiSolverBase<Scalar>;
 using knot_t = LQRKnotTpl<context::Scalar>;
 using lqr_t = LQRProblemTpl<context::Scalar>;
 
+#ifdef ALIGATOR_MULTITHREADING
+using parallel_solver_t = gar::ParallelRiccatiSolver<Scalar>;
+
+parallel_solver_t *make_parallel_solver(lqr_t &problem, uint num_threads,
+                                        uint num_legs) {
+  return new parallel_solver_t(problem, num_threads, nullptr, num_legs);
+}
+#endif
+
 void exposeParallelSolver() {
 #ifdef ALIGATOR_MULTITHREADING
-  using parallel_solver_t = gar::ParallelRiccatiSolver<Scalar>;
   bp::class_<parallel_solver_t, bp::bases<riccati_base_t>, boost::noncopyable>(
       "ParallelRiccatiSolver", bp::no_init)
       .def(bp::init<lqr_t &, uint>(("self"_a, "problem", "num_threads")))
-      .def_readonly("datas", &parallel_solver_t::datas);
+      .def("__init__",
+           bp::make_constructor(make_parallel_solver,
+                                bp::default_call_policies(),
+                                ("problem"_a, "num_threads", "num_legs")),
+           "Construct the solver with a number of legs independent from the "
+           "number of threads.")
+      .def_readonly("num_threads", &parallel_solver_t::numThreads)
+      .def_readonly("num_legs", &parallel_solver_t::numLegs)
+      .def_readonly("datas", &parallel_solver_t::datas)
+      .def_readwrite("use_cyclic_reduction",
+                     &parallel_solver_t::useCyclicReduction);
 #endif
 }
 
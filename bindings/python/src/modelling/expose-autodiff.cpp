@@ -5,6 +5,37 @@
 namespace aligator {
 namespace python {
 
+/// The members are cast to members of @p FiniteDiffType, since their base
+/// class is not exposed.
+template <typename FiniteDiffType>
+struct FiniteDifferenceVisitor
+    : bp::def_visitor<FiniteDifferenceVisitor<FiniteDiffType>> {
+  using T = FiniteDiffType;
+  using ConstMatrixRef = context::ConstMatrixRef;
+
+  template <class PyClass> void visit(PyClass &cl) const {
+    cl.def_readwrite("scheme",
+                     static_cast<autodiff::FiniteDifferenceScheme T::*>(
+                         &T::scheme),
+                     "Finite difference scheme.")
+        .def_readwrite("num_threads",
+                       static_cast<std::size_t T::*>(&T::num_threads),
+                       "Number of threads for the perturbed evaluations. Must "
+                       "be set before createData().")
+        .def("setSparsityPattern",
+             static_cast<void (T::*)(const ConstMatrixRef &)>(
+                 &T::setSparsityPattern),
+             ("self"_a, "pattern"),
+             "Set the sparsity pattern of the full Jacobian, given by the "
+             "nonzero entries of a matrix, and color its columns.")
+        .def("clearSparsityPattern",
+             static_cast<void (T::*)()>(&T::clearSparsityPattern), "self"_a)
+        .def("numColors",
+             static_cast<std::size_t (T::*)() const>(&T::numColors), "self"_a,
+             "Number of perturbed evaluations per Jacobian.");
+  }
+};
+
 /// Expose finite difference helpers.
 void exposeAutodiff() {
   using namespace autodiff;
@@ -16,6 +47,11 @@ void exposeAutodiff() {
   using context::StageFunction;
   using context::StageFunctionData;
 
+  bp::enum_<FiniteDifferenceScheme>("FiniteDifferenceScheme",
+                                    "Finite difference scheme.")
+      .value("FORWARD", FiniteDifferenceScheme::FORWARD)
+      .value("CENTRAL", FiniteDifferenceScheme::CENTRAL);
+
   {
     using FiniteDiffType = FiniteDifferenceHelper<Scalar>;
     bp::scope _ = bp::class_<FiniteDiffType, bp::bases<StageFunction>>(
@@ -23,7 +59,8 @@ void exposeAutodiff() {
         "Make a function into a differentiable function/dynamics using"
         " finite differences.",
         bp::init<shared_ptr<Manifold>, shared_ptr<StageFunction>, const Scalar>(
-            bp::args("self", "space", "func", "eps")));
+            bp::args("self", "space", "func", "eps")))
+        .def(FiniteDifferenceVisitor<FiniteDiffType>());
     bp::class_<FiniteDiffType::Data, bp::bases<StageFunctionData>>("Data",
                                                                    bp::no_init);
   }
@@ -33,7 +70,8 @@ void exposeAutodiff() {
     bp::scope _ = bp::class_<DynFiniteDiffType, bp::bases<DynamicsModel>>(
         "DynamicsFiniteDifferenceHelper",
         bp::init<shared_ptr<Manifold>, shared_ptr<DynamicsModel>, const Scalar>(
-            bp::args("self", "space", "dyn", "eps")));
+            bp::args("self", "space", "dyn", "eps")))
+        .def(FiniteDifferenceVisitor<DynFiniteDiffType>());
     bp::class_<DynFiniteDiffType::Data>("Data", bp::no_init);
   }
 
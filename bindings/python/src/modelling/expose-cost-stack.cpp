@@ -2,6 +2,7 @@
 #include "aligator/python/visitors.hpp"
 
 #include "aligator/modelling/costs/sum-of-costs.hpp"
+#include "aligator/modelling/costs/fused-cost-stack.hpp"
 
 namespace aligator {
 namespace python {
@@ -34,6 +35,24 @@ void exposeCostStack() {
   bp::class_<CostStackData, bp::bases<CostData>>(
       "CostStackData", "Data struct for CostStack.", bp::no_init)
       .def_readonly("sub_cost_data", &CostStackData::sub_cost_data);
+
+  using FusedCostStack = FusedCostStackTpl<Scalar>;
+  using FusedCostStackData = FusedCostStackDataTpl<Scalar>;
+
+  bp::class_<FusedCostStack, bp::bases<CostStack>>(
+      "FusedCostStack",
+      "A weighted sum of other cost functions, where the Gauss-Newton "
+      "quadratic residual costs are evaluated as stacked least-squares terms.",
+      bp::init<shared_ptr<Manifold>, int,
+               const std::vector<shared_ptr<CostAbstract>> &,
+               const std::vector<Scalar> &>(("self"_a, "space", "nu",
+                                             "components"_a = bp::list(),
+                                             "weights"_a = bp::list())))
+      .def(CopyableVisitor<FusedCostStack>());
+
+  bp::register_ptr_to_python<shared_ptr<FusedCostStackData>>();
+  bp::class_<FusedCostStackData, bp::bases<CostStackData>>(
+      "FusedCostStackData", "Data struct for FusedCostStack.", bp::no_init);
 }
 
 } // namespace python
@@ -7,6 +7,7 @@
 #include "aligator/modelling/multibody/frame-placement.hpp"
 #include "aligator/modelling/multibody/frame-velocity.hpp"
 #include "aligator/modelling/multibody/frame-translation.hpp"
+#include "aligator/modelling/multibody/kinematics-cache.hpp"
 #ifdef ALIGATOR_PINOCCHIO_V3
 #include "aligator/modelling/multibody/constrained-rnea.hpp"
 #endif
@@ -125,8 +126,32 @@ auto underactuatedConstraintInvDyn_proxy(
 }
 #endif
 
+void exposeKinematicsCache() {
+  using context::Scalar;
+  using KinematicsCacheModel = KinematicsCacheModelTpl<Scalar>;
+  using KinematicsCacheData = KinematicsCacheDataTpl<Scalar>;
+
+  bp::register_ptr_to_python<shared_ptr<KinematicsCacheModel>>();
+  bp::class_<KinematicsCacheModel, bp::bases<StageCacheModelTpl<Scalar>>>(
+      "KinematicsCacheModel",
+      "Forward kinematics computed once per stage, and shared by the frame "
+      "and center of mass residuals of the stage which use the same model.",
+      bp::init<shared_ptr<PinModel>, bp::optional<bool>>(
+          bp::args("self", "model", "with_velocity")))
+      .def_readonly("pin_model", &KinematicsCacheModel::pin_model_)
+      .def_readonly("with_velocity", &KinematicsCacheModel::with_velocity_);
+
+  bp::register_ptr_to_python<shared_ptr<KinematicsCacheData>>();
+  bp::class_<KinematicsCacheData, bp::bases<StageCacheDataTpl<Scalar>>>(
+      "KinematicsCacheData", "Data struct for KinematicsCacheModel.",
+      bp::no_init)
+      .def_readonly("pin_data", &KinematicsCacheData::pin_data_,
+                    "Pinocchio data struct, shared by the residuals.");
+}
+
 void exposePinocchioFunctions() {
   exposeFrameFunctions();
+  exposeKinematicsCache();
   exposeFlyHigh();
 #ifdef ALIGATOR_PINOCCHIO_V3
   exposeContactForce();
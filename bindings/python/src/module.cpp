@@ -45,6 +45,12 @@ static void exposeEnums() {
       .value("SA_LINESEARCH", StepAcceptanceStrategy::LINESEARCH)
       .value("SA_FILTER", StepAcceptanceStrategy::FILTER)
       .export_values();
+
+  bp::enum_<ThreadingBackend>("ThreadingBackend",
+                              "Threading backend for the parallel solvers.")
+      .value("THREADING_OPENMP", ThreadingBackend::OPENMP)
+      .value("THREADING_THREAD_POOL", ThreadingBackend::THREAD_POOL)
+      .export_values();
 }
 
 static void exposeContainers() {
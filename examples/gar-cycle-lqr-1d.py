@@ -15,13 +15,13 @@ nu = 1
 
 def create_knot(nx, nu):
     knot = gar.LQRKnot(nx, nu, 0)
-    knot.Q[:] = np.eye(nx) * 0.01
-    knot.R[:] = np.eye(nu) * 0.01
-    knot.r[:] = (2 * np.random.rand(nx) - 1) * 0.01
-    knot.A[:] = 1.2
-    knot.B[:] = np.eye(nx, nu)
-    knot.E[:] = -np.eye(nx)
-    knot.f[:] = (2 * np.random.rand(nx) - 1) * 0.1
+    knot.Q = np.eye(nx) * 0.01
+    knot.R = np.eye(nu) * 0.01
+    knot.r = (2 * np.random.rand(nx) - 1) * 0.01
+    knot.A = np.full((nx, nx), 1.2)
+    knot.B = np.eye(nx, nu)
+    knot.E = -np.eye(nx)
+    knot.f = (2 * np.random.rand(nx) - 1) * 0.1
     return knot
 
 
@@ -36,14 +36,14 @@ prob.addParameterization(PARAM_DIM)
 
 xf = np.array([0.05])
 kf = prob.stages[T]
-kf.Q[:] = np.eye(nx) * 1.0
-kf.q[:] = -kf.Q @ xf
+kf.Q = np.eye(nx) * 1.0
+kf.q = -kf.Q @ xf
 
 
 def add_mid(t0, v):
     kt0 = prob.stages[t0]
-    kt0.Q[:] = 0.05
-    kt0.q[:] = -kt0.Q @ np.array([v])
+    kt0.Q = np.full((nx, nx), 0.05)
+    kt0.q = -kt0.Q @ np.array([v])
 
 
 t0 = T // 3
@@ -53,8 +53,8 @@ add_mid(t1, -0.1)
 
 print(prob.stages[0])
 print(prob.stages[T])
-prob.stages[0].Gx[:] = +np.eye(nx)
-prob.stages[T].Gx[:] = -np.eye(nx)
+prob.stages[0].Gx = np.eye(nx)
+prob.stages[T].Gx = -np.eye(nx)
 
 solver = gar.ProximalRiccatiSolver(prob)
 mu = 1e-8
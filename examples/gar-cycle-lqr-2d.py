@@ -19,15 +19,15 @@ def random_unit(size):
 
 def create_knot(nx, nu):
     knot = gar.LQRKnot(nx, nu, 0)
-    knot.Q[:] = np.eye(nx) * 1e-3
-    knot.R[:] = np.eye(nu) * 0.1
+    knot.Q = np.eye(nx) * 1e-3
+    knot.R = np.eye(nu) * 0.1
     th = 0.156
     cs = np.cos(th)
     ss = np.sin(th)
-    knot.A[:] = [[cs, -ss], [ss, cs]]
-    knot.B[:] = np.eye(nx, nu)
-    knot.E[:] = -np.eye(nx)
-    knot.f[:] = 0.0
+    knot.A = np.array([[cs, -ss], [ss, cs]])
+    knot.B = np.eye(nx, nu)
+    knot.E = -np.eye(nx)
+    knot.f = np.zeros(nx)
     return knot
 
 
@@ -42,8 +42,8 @@ prob.addParameterization(PARAM_DIM)
 
 xf = np.array([0.6, 0.6])
 kf = prob.stages[T]
-kf.Q[:] = np.eye(nx) * 1.0
-kf.q[:] = -kf.Q @ xf
+kf.Q = np.eye(nx) * 1.0
+kf.q = -kf.Q @ xf
 
 
 _t_objs = []
@@ -52,8 +52,8 @@ _x_objs = []
 
 def add_mid(t0, v):
     kt0 = prob.stages[t0]
-    kt0.Q[:] = np.eye(nx) * 0.2
-    kt0.q[:] = -kt0.Q @ v
+    kt0.Q = np.eye(nx) * 0.2
+    kt0.q = -kt0.Q @ v
     _t_objs.append(t0)
     _x_objs.append(np.array(v))
 
@@ -70,8 +70,8 @@ add_mid(t2, xt2)
 
 print(prob.stages[0])
 print(prob.stages[T])
-prob.stages[0].Gx[:] = +np.eye(nx)
-prob.stages[T].Gx[:] = -np.eye(nx)
+prob.stages[0].Gx = np.eye(nx)
+prob.stages[T].Gx = -np.eye(nx)
 
 solver = gar.ProximalRiccatiSolver(prob)
 mu = 1e-12
@@ -29,13 +29,13 @@ xterm = np.array([0.0])
 
 def knot_get_default(nx, nu, nc):
     knot = gar.LQRKnot(nx, nu, nc)
-    knot.Q[:] = np.eye(nx, nx) * 0.1
-    knot.q[:] = 0.0
-    knot.R[:] = np.eye(nu) * 0.1
-    knot.A[:] = 1.2 * np.eye(nx)
-    knot.f[:] = 0.01 * np.ones(nx)
+    knot.Q = np.eye(nx, nx) * 0.1
+    knot.q = np.zeros(nx)
+    knot.R = np.eye(nu) * 0.1
+    knot.A = 1.2 * np.eye(nx)
+    knot.f = 0.01 * np.ones(nx)
     knot.B = np.eye(nx, nu)
-    knot.E[:] = -np.eye(nx)
+    knot.E = -np.eye(nx)
     return knot
 
 
@@ -52,8 +52,8 @@ if args.term:
     knot1.d = -xterm
 else:
     knot1 = knot_get_default(nx, 0, 0)
-    knot1.Q[:] = np.eye(nx) * 0.1
-    knot1.q[:] = -knot1.Q @ xterm
+    knot1.Q = np.eye(nx) * 0.1
+    knot1.q = -knot1.Q @ xterm
 
 T = 7
 t0 = T // 2
@@ -212,8 +212,8 @@ PARAM_DIM = nx
 prob.addParameterization(PARAM_DIM)
 
 knot1 = prob.stages[-1]
-knot1.Gx[:] = -knot1.Q
-knot1.Gth[:] = knot1.Q
+knot1.Gx = -knot1.Q
+knot1.Gth = knot1.Q
 print("Terminal knot:", knot1)
 
 print("Is problem parameterized? {}".format(prob.isParameterized))
@@ -29,14 +29,14 @@ r_ = np.random.randn(nu)
 
 def knot_get_default(nx, nu, nc):
     knot = gar.LQRKnot(nx, nu, nc)
-    knot.Q[:] = Q_
-    knot.q[:] = -Q_ @ xbar
-    knot.R[:] = np.eye(nu) * 0.1
-    knot.r[:] = r_
-    knot.f[:] = f_
-    knot.A[:] = A_
-    knot.B[:] = B_
-    knot.E[:] = E_
+    knot.Q = Q_
+    knot.q = -Q_ @ xbar
+    knot.R = np.eye(nu) * 0.1
+    knot.r = r_
+    knot.f = f_
+    knot.A = A_
+    knot.B = B_
+    knot.E = E_
     return knot
 
 
@@ -68,8 +68,8 @@ prob2 = gar.LQRProblem(knots, 0)
 prob2.addParameterization(nx)
 knots2 = prob2.stages
 knots2[0].Gx = E_.T
-knots2[-1].Q[:] = Qf_
-knots2[-1].q[:] = -Qf_ @ xf
+knots2[-1].Q = Qf_
+knots2[-1].q = -Qf_ @ xf
 
 assert prob1.horizon + prob2.horizon + 1 == T_all, "Got {}, expected {}".format(
     prob1.horizon + prob2.horizon, T_all
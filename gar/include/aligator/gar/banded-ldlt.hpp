@@ -0,0 +1,156 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "riccati-base.hpp"
+#include "utils.hpp"
+
+namespace aligator {
+namespace gar {
+
+/// @brief In-place LDLT factorization of a symmetric band matrix.
+/// @details The lower band is stored contiguously, column by column (the
+/// layout of LAPACK's `dpbtrf`): entry \f$(i, j)\f$, for
+/// \f$j \leq i \leq j + k\f$, is `band(i - j, j)`. The factorization only
+/// updates the contiguous columns of the band, which vectorizes.
+/// There is no pivoting, since it would destroy the band structure. Pivots
+/// which are smaller than @ref pivotThreshold times the largest diagonal
+/// entry in magnitude are replaced by this value, with their sign (static
+/// pivoting): the factorization is then that of a nearby matrix, and the
+/// solution should be refined iteratively.
+template <typename _Scalar> class BandedLDLT {
+public:
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Index = Eigen::Index;
+
+  BandedLDLT() = default;
+  BandedLDLT(Index size, Index bandwidth);
+
+  Index size() const { return band.cols(); }
+  /// Number of subdiagonals.
+  Index bandwidth() const { return band.rows() - 1; }
+
+  /// Entry \f$(i, j)\f$ of the lower band, with \f$i \geq j\f$.
+  Scalar &coeffRef(Index i, Index j) {
+    assert(i >= j && i - j <= bandwidth());
+    return band(i - j, j);
+  }
+
+  /// @brief Factorize the matrix held in @ref band, in place.
+  /// @returns Whether no pivot had to be perturbed.
+  bool factorize();
+
+  /// Solve in place with the factorization computed by factorize().
+  void solveInPlace(VectorRef rhs) const;
+
+  /// @brief Compute \f$y = A x\f$, for the symmetric matrix \f$A\f$ with
+  /// lower band @p band.
+  static void multiply(const MatrixXs &band, const ConstVectorRef &x,
+                       VectorRef y);
+
+  /// Lower band of the matrix, or its factors after factorize(): the pivots
+  /// on the first row, the unit lower-triangular factor below.
+  MatrixXs band;
+  /// Pivots smaller than this, relative to the largest diagonal entry, are
+  /// perturbed.
+  Scalar pivotThreshold = 1e-8;
+  /// Number of perturbed pivots in the last factorization.
+  uint numPerturbedPivots = 0;
+
+protected:
+  VectorXs work_;
+};
+
+/// @brief A solver for the LQ problem which factorizes its full KKT matrix,
+/// a band matrix, with a banded LDLT factorization (see BandedLDLT).
+/// @details The variables are ordered as in lqrDenseMatrix(), except that the
+/// multipliers of the path constraints of each stage come before its state
+/// and control: \f$(\lambda_0, v_0, x_0, u_0, \lambda_1, v_1, x_1, \ldots)\f$.
+/// The bandwidth of the KKT matrix is then about \f$2n_x + n_u + n_c\f$, and
+/// the cost of the factorization is linear in the horizon. Each primal pivot
+/// comes after the multipliers of the constraints and of the dynamics
+/// defining it, so that the pivots do not vanish as long as the dual
+/// regularization is positive and the cost, dynamics and constraints have no
+/// common null direction. Unlike the Riccati recursion, this does not require
+/// the dynamics matrices \f$E\f$ to be invertible, nor the constraint
+/// Jacobians to have full rank.
+/// The solver computes no feedback gains: the feedforward gains hold the
+/// solution itself, and the feedback gains are zero.
+template <typename _Scalar>
+class BandedLDLTSolver : public RiccatiSolverBase<_Scalar> {
+public:
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS_WITH_ROW_TYPES(Scalar);
+  using Base = RiccatiSolverBase<Scalar>;
+  using Problem = LQRProblemTpl<Scalar>;
+  using Index = Eigen::Index;
+
+  explicit BandedLDLTSolver(const Problem &problem,
+                            uint numRefinementSteps = 1);
+
+  bool backward(const Scalar mudyn, const Scalar mueq);
+
+  /// @warning The parameter @p theta is not supported, and ignored.
+  bool forward(std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+               std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
+               const std::optional<ConstVectorRef> &theta = std::nullopt) const;
+
+  VectorRef getFeedforward(size_t i) { return ffs[i].matrix(); }
+  RowMatrixRef getFeedback(size_t i) { return fbs[i].matrix(); }
+
+  /// Copy the new initial residual \f$g_0\f$ into the right-hand side
+  /// kktRhs. The next forward() call solves with the current factorization.
+  bool updateInitialResidual() {
+    kktRhs.head(problem_->nc0()) = problem_->g0;
+    return true;
+  }
+
+  /// Re-assemble the right-hand side kktRhs from the vectors of the problem,
+  /// leaving the KKT matrix and its factorization untouched. The next
+  /// forward() call solves with the current factorization.
+  bool backwardRhs(const Scalar mudyn, const Scalar mueq) {
+    lqrAssembleSparseMatrix(*problem_, mudyn, mueq, kktRhs,
+                            [](Index, Index, Scalar) {});
+    return true;
+  }
+
+  /// Infinity norm of the residual of the KKT system at the solution of the
+  /// last forward() call.
+  Scalar computeResidual() const {
+    work_ = perm_ * kktSol;
+    residual_ = perm_ * kktRhs;
+    BandedLDLT<Scalar>::multiply(kktBand, work_, residual_);
+    return math::infty_norm(residual_);
+  }
+
+  Index bandwidth() const { return ldlt.bandwidth(); }
+
+  /// Lower band of the KKT matrix, in the order of the factorization
+  MatrixXs kktBand;
+  /// Linear problem rhs
+  VectorXs kktRhs;
+  /// Linear problem solution
+  mutable VectorXs kktSol;
+  BandedLDLT<Scalar> ldlt;
+  /// Number of iterative refinement steps.
+  uint numRefinementSteps;
+
+protected:
+  const Problem *problem_;
+  /// Maps the rows of lqrDenseMatrix() to the order of the factorization.
+  Eigen::PermutationMatrix<Eigen::Dynamic> perm_;
+  /// Solution and residual, in the order of the factorization.
+  mutable VectorXs work_;
+  mutable VectorXs residual_;
+  mutable std::vector<BlkMatrix<VectorXs, 4, 1>> ffs;
+  std::vector<BlkMatrix<RowMatrixXs, 4, 1>> fbs;
+};
+
+} // namespace gar
+} // namespace aligator
+
+#include "./banded-ldlt.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "./banded-ldlt.txx"
+#endif
@@ -0,0 +1,165 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./banded-ldlt.hpp"
+
+#include <tracy/Tracy.hpp>
+
+namespace aligator::gar {
+
+template <typename Scalar>
+BandedLDLT<Scalar>::BandedLDLT(Index size, Index bandwidth)
+    : band(bandwidth + 1, size), work_(bandwidth) {
+  band.setZero();
+}
+
+template <typename Scalar> bool BandedLDLT<Scalar>::factorize() {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  const Index n = size();
+  const Index kd = bandwidth();
+  const Scalar minPivot = pivotThreshold * band.row(0).cwiseAbs().maxCoeff();
+  numPerturbedPivots = 0;
+  for (Index j = 0; j < n; j++) {
+    const Index m = std::min(kd, n - 1 - j);
+    Scalar &d = band(0, j);
+    if (std::abs(d) < minPivot) {
+      d = d < 0 ? -minPivot : minPivot;
+      numPerturbedPivots++;
+    }
+    auto l = band.col(j).segment(1, m);
+    auto w = work_.head(m);
+    w = l;
+    l /= d;
+    // rank-one update of the trailing band, one contiguous column at a time
+    for (Index k = 0; k < m; k++) {
+      band.col(j + k + 1).head(m - k) -= l[k] * w.tail(m - k);
+    }
+  }
+  return numPerturbedPivots == 0;
+}
+
+template <typename Scalar>
+void BandedLDLT<Scalar>::solveInPlace(VectorRef rhs) const {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  const Index n = size();
+  const Index kd = bandwidth();
+  assert(rhs.size() == n);
+  for (Index j = 0; j < n; j++) {
+    const Index m = std::min(kd, n - 1 - j);
+    rhs.segment(j + 1, m) -= rhs[j] * band.col(j).segment(1, m);
+  }
+  rhs.array() /= band.row(0).transpose().array();
+  for (Index j = n - 1; j >= 0; j--) {
+    const Index m = std::min(kd, n - 1 - j);
+    rhs[j] -= band.col(j).segment(1, m).dot(rhs.segment(j + 1, m));
+  }
+}
+
+template <typename Scalar>
+void BandedLDLT<Scalar>::multiply(const MatrixXs &band,
+                                  const ConstVectorRef &x, VectorRef y) {
+  ALIGATOR_NOMALLOC_SCOPED;
+  const Index n = band.cols();
+  const Index kd = band.rows() - 1;
+  assert(x.size() == n);
+  assert(y.size() == n);
+  for (Index j = 0; j < n; j++) {
+    const Index m = std::min(kd, n - 1 - j);
+    auto col = band.col(j).segment(1, m);
+    y[j] += band(0, j) * x[j] + col.dot(x.segment(j + 1, m));
+    y.segment(j + 1, m) += x[j] * col;
+  }
+}
+
+template <typename Scalar>
+BandedLDLTSolver<Scalar>::BandedLDLTSolver(const Problem &problem,
+                                           uint numRefinementSteps)
+    : Base(), numRefinementSteps(numRefinementSteps), problem_(&problem) {
+  ZoneScoped;
+  const Index n = lqrNumRows(problem);
+  kktRhs.setZero(n);
+  kktSol.setZero(n);
+  work_.setZero(n);
+  residual_.setZero(n);
+
+  // move the constraint multipliers of each stage before its state
+  const uint N = uint(problem.horizon());
+  perm_.resize(n);
+  {
+    auto &indices = perm_.indices();
+    Index idx = 0;
+    for (Index k = 0; k < problem.nc0(); k++, idx++)
+      indices[idx] = int(idx);
+    for (uint t = 0; t <= N; t++) {
+      const LQRKnotTpl<Scalar> &knot = problem.stages[t];
+      const Index nxu = knot.nx + knot.nu;
+      for (Index k = 0; k < nxu; k++)
+        indices[idx + k] = int(idx + knot.nc + k);
+      for (Index k = 0; k < knot.nc; k++)
+        indices[idx + nxu + k] = int(idx + k);
+      idx += nxu + knot.nc;
+      if (t < N) {
+        for (Index k = 0; k < knot.nx2; k++, idx++)
+          indices[idx] = int(idx);
+      }
+    }
+  }
+
+  Index kd = 0;
+  lqrAssembleSparseMatrix(problem, Scalar(1.), Scalar(1.), kktRhs,
+                          [&](Index i, Index j, Scalar) {
+                            kd = std::max(kd, Index(perm_.indices()[i] -
+                                                    perm_.indices()[j]));
+                          });
+  // only the structural nonzeros are assigned by backward()
+  kktBand.setZero(kd + 1, n);
+  ldlt = BandedLDLT<Scalar>(n, kd);
+
+  for (uint t = 0; t <= N; t++) {
+    const LQRKnotTpl<Scalar> &knot = problem.stages[t];
+    std::array<long, 4> dims{knot.nu, knot.nc, knot.nx2, knot.nx2};
+    ffs.emplace_back(dims, std::array<long, 1>{1});
+    fbs.emplace_back(dims, std::array<long, 1>{knot.nx});
+    ffs.back().setZero();
+    fbs.back().setZero();
+  }
+}
+
+template <typename Scalar>
+bool BandedLDLTSolver<Scalar>::backward(const Scalar mudyn, const Scalar mueq) {
+  ZoneScoped;
+  lqrAssembleSparseMatrix(*problem_, mudyn, mueq, kktRhs,
+                          [&](Index i, Index j, Scalar value) {
+                            i = perm_.indices()[i];
+                            j = perm_.indices()[j];
+                            if (i >= j)
+                              kktBand(i - j, j) = value;
+                          });
+  ldlt.band = kktBand;
+  ldlt.factorize();
+  return true;
+}
+
+template <typename Scalar>
+bool BandedLDLTSolver<Scalar>::forward(
+    std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+    std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
+    const std::optional<ConstVectorRef> &) const {
+  ZoneScoped;
+  work_.noalias() = perm_ * kktRhs;
+  work_ *= -1;
+  ldlt.solveInPlace(work_);
+  for (uint i = 0; i < numRefinementSteps; i++) {
+    residual_.noalias() = perm_ * kktRhs;
+    BandedLDLT<Scalar>::multiply(kktBand, work_, residual_);
+    ldlt.solveInPlace(residual_);
+    work_ -= residual_;
+  }
+  kktSol.noalias() = perm_.transpose() * work_;
+  lqrSolutionToTrajAndGains(*problem_, kktSol, xs, us, vs, lbdas, ffs);
+  return true;
+}
+
+} // namespace aligator::gar
@@ -0,0 +1,14 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./banded-ldlt.hpp"
+#include "aligator/context.hpp"
+
+namespace aligator {
+namespace gar {
+
+extern template class BandedLDLT<context::Scalar>;
+extern template class BandedLDLTSolver<context::Scalar>;
+
+} // namespace gar
+} // namespace aligator
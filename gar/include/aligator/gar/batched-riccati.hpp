@@ -0,0 +1,214 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "lqr-problem.hpp"
+#include "aligator/threads.hpp"
+
+namespace aligator {
+namespace gar {
+
+/// @brief Dense matrix holding the same entry of a group of `Width` problems.
+/// @details The lanes of each entry `(i, j)` are contiguous (entries are
+/// stored in row-major order), so that element-wise operations on one entry
+/// of all the problems map to SIMD instructions.
+template <typename _Scalar, int _Width> struct PackedMatrix {
+  using Scalar = _Scalar;
+  static constexpr int Width = _Width;
+  using Lane = Eigen::Array<Scalar, Width, 1>;
+  using Storage = Eigen::Array<Scalar, Width, Eigen::Dynamic>;
+
+  PackedMatrix() : PackedMatrix(0, 0) {}
+  PackedMatrix(uint rows, uint cols)
+      : data(Width, rows * cols), rows_(rows), cols_(cols) {
+    data.setZero();
+  }
+
+  uint rows() const { return rows_; }
+  uint cols() const { return cols_; }
+
+  auto operator()(uint i, uint j) { return data.col(i * cols_ + j); }
+  auto operator()(uint i, uint j) const { return data.col(i * cols_ + j); }
+
+  /// Copy @p src into lane @p k.
+  template <typename Derived>
+  void setLane(uint k, const Eigen::MatrixBase<Derived> &src) {
+    assert(src.rows() == rows_ && src.cols() == cols_);
+    for (uint i = 0; i < rows_; i++)
+      for (uint j = 0; j < cols_; j++)
+        data(k, i * cols_ + j) = src(i, j);
+  }
+
+  /// Copy lane @p k into @p dst.
+  template <typename Derived>
+  void getLane(uint k, Eigen::MatrixBase<Derived> &dst) const {
+    assert(dst.rows() == rows_ && dst.cols() == cols_);
+    for (uint i = 0; i < rows_; i++)
+      for (uint j = 0; j < cols_; j++)
+        dst(i, j) = data(k, i * cols_ + j);
+  }
+
+  Storage data;
+
+private:
+  uint rows_;
+  uint cols_;
+};
+
+/// @brief Knot of a group of LQ problems, see LQRKnotTpl.
+/// @details The matrix `B` is also stored padded with `nc` zero columns
+/// (`Bz`), to multiply the stacked control and multiplier gains.
+template <typename Scalar, int Width> struct BatchedKnot {
+  using Packed = PackedMatrix<Scalar, Width>;
+  uint nx, nu, nc;
+  Packed Q, S, R, q, r;
+  Packed A, B, Bz, f;
+  Packed C, D, d;
+
+  BatchedKnot(uint nx, uint nu, uint nc)
+      : nx(nx), nu(nu), nc(nc), Q(nx, nx), S(nx, nu), R(nu, nu), q(nx, 1),
+        r(nu, 1), A(nx, nx), B(nx, nu), Bz(nx, nu + nc), f(nx, 1),
+        C(nc, nx), D(nc, nu), d(nc, 1) {}
+
+  /// Copy the data of @p knot into lane @p k.
+  void setLane(uint k, const LQRKnotTpl<Scalar> &knot);
+};
+
+/// @brief Per-node data of the batched Riccati recursion, see StageFactor.
+template <typename Scalar, int Width> struct BatchedStageFactor {
+  using Packed = PackedMatrix<Scalar, Width>;
+  Packed Pmat, pvec; //< Riccati matrix and bias
+  Packed Vxx, vx;    //< cost-to-go, after the proximal dynamics step
+  Packed schur;      //< factorized Schur matrix I + mudyn * P
+  Packed VA, VB;     //< products Vxx * A and Vxx * B
+  Packed Qhat, Rhat, Shat, qhat;
+  Packed SC;  //< [Shat, C^T]
+  Packed kkt; //< factorized reduced KKT matrix
+  Packed kz;  //< stacked control and multiplier feedforward gains
+  Packed KZ;  //< stacked control and multiplier feedback gains
+  Packed bk;  //< product B * k
+  Packed M;   //< product A + B * K
+  Packed lff, L;
+  Packed yff, Afb; //< closed-loop dynamics
+
+  BatchedStageFactor(uint nx, uint nu, uint nc)
+      : Pmat(nx, nx), pvec(nx, 1), Vxx(nx, nx), vx(nx, 1), schur(nx, nx),
+        VA(nx, nx), VB(nx, nu), Qhat(nx, nx), Rhat(nu, nu), Shat(nx, nu),
+        qhat(nx, 1), SC(nx, nu + nc), kkt(nu + nc, nu + nc), kz(nu + nc, 1),
+        KZ(nu + nc, nx), bk(nx, 1), M(nx, nx), lff(nx, 1), L(nx, nx),
+        yff(nx, 1), Afb(nx, nx) {}
+};
+
+/// @brief Lane-wise dense linear algebra and Riccati recursion on packed
+/// data.
+template <typename Scalar, int Width> struct BatchedRiccatiKernel {
+  using Packed = PackedMatrix<Scalar, Width>;
+  using Lane = typename Packed::Lane;
+  using KnotType = BatchedKnot<Scalar, Width>;
+  using StageFactorType = BatchedStageFactor<Scalar, Width>;
+
+  /// @brief C = alpha * op(A) * op(B), or C += alpha * op(A) * op(B) if
+  /// @p accumulate is true.
+  template <bool TransA, bool TransB>
+  static void gemm(Packed &C, const Packed &A, const Packed &B,
+                   bool accumulate, Scalar alpha = Scalar(1));
+
+  /// Copy @p alpha * op(src) into @p dst, starting at entry (i0, j0).
+  template <bool Trans>
+  static void setBlock(Packed &dst, uint i0, uint j0, const Packed &src,
+                       Scalar alpha = Scalar(1));
+
+  /// @brief In-place LDLT factorization without pivoting, from the lower
+  /// triangular part of @p mat.
+  /// @details Stable for the quasi-definite systems of the Riccati recursion.
+  static void ldlt(Packed &mat);
+
+  /// Solve in place with the factorization computed by ldlt().
+  static void ldltSolveInPlace(const Packed &fact, Packed &rhs);
+
+  static void terminalSolve(const KnotType &model, const Scalar mueq,
+                            StageFactorType &d);
+
+  static void stageKernelSolve(const KnotType &model, StageFactorType &d,
+                               const StageFactorType &dn, const Scalar mudyn,
+                               const Scalar mueq);
+};
+
+/// @brief A Riccati solver for a batch of LQ problems with the same
+/// dimensions, vectorized across the problems.
+/// @details The problems are split into groups of `Width` problems, whose
+/// data are packed into an interleaved structure-of-arrays layout (see
+/// PackedMatrix). The recursion then runs on all the problems of a group at
+/// once, with one SIMD lane per problem; the groups are solved in parallel.
+/// Pivoting does not vectorize, so the factorizations are unpivoted LDLT
+/// decompositions of the (quasi-definite) KKT systems.
+/// @warning The knots must have dynamics `E = -I` (so `nx2 == nx`) and no
+/// parameters (`nth == 0`).
+template <typename _Scalar, int _Width = 4> class BatchedRiccatiSolver {
+public:
+  using Scalar = _Scalar;
+  static constexpr int Width = _Width;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using ProblemType = LQRProblemTpl<Scalar>;
+  using Packed = PackedMatrix<Scalar, Width>;
+  using Impl = BatchedRiccatiKernel<Scalar, Width>;
+  using KnotType = BatchedKnot<Scalar, Width>;
+  using StageFactorType = BatchedStageFactor<Scalar, Width>;
+
+  /// @brief Knots, factorization and solution of a group of problems.
+  struct Group {
+    std::vector<KnotType> knots;
+    std::vector<StageFactorType> datas;
+    Packed G0, g0;
+    Packed kkt0; //< factorized initial KKT system
+    Packed xl0;  //< initial state and multiplier
+    std::vector<Packed> xs, uzs, lbdas;
+  };
+
+  /// @param problems  Problems to solve, with the same horizon and
+  /// dimensions. They are held by pointer, and re-read by each backward().
+  /// @param pool  Optional persistent thread pool to solve the groups on. If
+  /// null, an OpenMP parallel region is opened instead.
+  explicit BatchedRiccatiSolver(
+      const std::vector<const ProblemType *> &problems,
+      const uint num_threads = 1, ThreadPool *pool = nullptr);
+
+  /// Pack the data of the problems and run the backward sweep.
+  bool backward(const Scalar mudyn, const Scalar mueq);
+
+  /// Run the forward sweep for all the problems.
+  bool forward();
+
+  /// @brief Get the solution of problem @p i from the last forward() call,
+  /// with the layout of lqrInitializeSolution().
+  void getSolution(size_t i, std::vector<VectorXs> &xs,
+                   std::vector<VectorXs> &us, std::vector<VectorXs> &vs,
+                   std::vector<VectorXs> &lbdas) const;
+
+  size_t numProblems() const { return problems_.size(); }
+  size_t numGroups() const { return groups.size(); }
+
+  std::vector<Group> groups;
+  uint num_threads;
+
+protected:
+  /// Problem in lane @p k of group @p g. Missing problems of the last group
+  /// are filled with the last problem.
+  const ProblemType &laneProblem(size_t g, uint k) const {
+    return *problems_[std::min(g * Width + k, problems_.size() - 1)];
+  }
+
+  void backwardGroup(size_t g, const Scalar mudyn, const Scalar mueq);
+  void forwardGroup(size_t g);
+
+  std::vector<const ProblemType *> problems_;
+  ThreadPool *pool_;
+};
+
+} // namespace gar
+} // namespace aligator
+
+#include "./batched-riccati.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "./batched-riccati.txx"
+#endif
@@ -0,0 +1,366 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./batched-riccati.hpp"
+
+#include <tracy/Tracy.hpp>
+
+namespace aligator {
+namespace gar {
+
+template <typename Scalar, int Width>
+void BatchedKnot<Scalar, Width>::setLane(uint k,
+                                         const LQRKnotTpl<Scalar> &knot) {
+  Q.setLane(k, knot.Q);
+  S.setLane(k, knot.S);
+  R.setLane(k, knot.R);
+  q.setLane(k, knot.q);
+  r.setLane(k, knot.r);
+  A.setLane(k, knot.A);
+  B.setLane(k, knot.B);
+  for (uint i = 0; i < nx; i++)
+    for (uint j = 0; j < nu; j++)
+      Bz(i, j)(k) = knot.B(i, j);
+  f.setLane(k, knot.f);
+  C.setLane(k, knot.C);
+  D.setLane(k, knot.D);
+  d.setLane(k, knot.d);
+}
+
+template <typename Scalar, int Width>
+template <bool TransA, bool TransB>
+void BatchedRiccatiKernel<Scalar, Width>::gemm(Packed &C, const Packed &A,
+                                               const Packed &B,
+                                               bool accumulate, Scalar alpha) {
+  const uint m = C.rows();
+  const uint n = C.cols();
+  const uint p = TransA ? A.rows() : A.cols();
+  assert((TransA ? A.cols() : A.rows()) == m);
+  assert((TransB ? B.rows() : B.cols()) == n);
+  assert((TransB ? B.cols() : B.rows()) == p);
+  for (uint i = 0; i < m; i++) {
+    for (uint j = 0; j < n; j++) {
+      Lane acc = Lane::Zero();
+      for (uint k = 0; k < p; k++)
+        acc += (TransA ? A(k, i) : A(i, k)) * (TransB ? B(j, k) : B(k, j));
+      if (accumulate)
+        C(i, j) += alpha * acc;
+      else
+        C(i, j) = alpha * acc;
+    }
+  }
+}
+
+template <typename Scalar, int Width>
+template <bool Trans>
+void BatchedRiccatiKernel<Scalar, Width>::setBlock(Packed &dst, uint i0,
+                                                   uint j0, const Packed &src,
+                                                   Scalar alpha) {
+  const uint m = Trans ? src.cols() : src.rows();
+  const uint n = Trans ? src.rows() : src.cols();
+  assert(i0 + m <= dst.rows() && j0 + n <= dst.cols());
+  for (uint i = 0; i < m; i++)
+    for (uint j = 0; j < n; j++)
+      dst(i0 + i, j0 + j) = alpha * (Trans ? src(j, i) : src(i, j));
+}
+
+template <typename Scalar, int Width>
+void BatchedRiccatiKernel<Scalar, Width>::ldlt(Packed &mat) {
+  const uint n = mat.rows();
+  assert(mat.cols() == n);
+  for (uint j = 0; j < n; j++) {
+    Lane djj = mat(j, j);
+    for (uint k = 0; k < j; k++)
+      djj -= mat(j, k).square() * mat(k, k);
+    mat(j, j) = djj;
+    for (uint i = j + 1; i < n; i++) {
+      Lane lij = mat(i, j);
+      for (uint k = 0; k < j; k++)
+        lij -= mat(i, k) * mat(j, k) * mat(k, k);
+      mat(i, j) = lij / djj;
+    }
+  }
+}
+
+template <typename Scalar, int Width>
+void BatchedRiccatiKernel<Scalar, Width>::ldltSolveInPlace(const Packed &fact,
+                                                           Packed &rhs) {
+  const uint n = fact.rows();
+  assert(rhs.rows() == n);
+  for (uint c = 0; c < rhs.cols(); c++) {
+    for (uint i = 0; i < n; i++) {
+      Lane yi = rhs(i, c);
+      for (uint k = 0; k < i; k++)
+        yi -= fact(i, k) * rhs(k, c);
+      rhs(i, c) = yi;
+    }
+    for (uint i = 0; i < n; i++)
+      rhs(i, c) /= fact(i, i);
+    for (uint i = n; i-- > 0;) {
+      Lane xi = rhs(i, c);
+      for (uint k = i + 1; k < n; k++)
+        xi -= fact(k, i) * rhs(k, c);
+      rhs(i, c) = xi;
+    }
+  }
+}
+
+template <typename Scalar, int Width>
+void BatchedRiccatiKernel<Scalar, Width>::terminalSolve(const KnotType &model,
+                                                        const Scalar mueq,
+                                                        StageFactorType &d) {
+  ZoneScoped;
+  const uint nu = model.nu;
+  d.kkt.data.setZero();
+  setBlock<false>(d.kkt, 0, 0, model.R);
+  setBlock<false>(d.kkt, nu, 0, model.D);
+  for (uint i = 0; i < model.nc; i++)
+    d.kkt(nu + i, nu + i).setConstant(-mueq);
+  ldlt(d.kkt);
+
+  setBlock<false>(d.SC, 0, 0, model.S);
+  setBlock<true>(d.SC, 0, nu, model.C);
+  setBlock<false>(d.kz, 0, 0, model.r, -1);
+  setBlock<false>(d.kz, nu, 0, model.d, -1);
+  setBlock<true>(d.KZ, 0, 0, d.SC, -1);
+  ldltSolveInPlace(d.kkt, d.kz);
+  ldltSolveInPlace(d.kkt, d.KZ);
+
+  d.Pmat.data = model.Q.data;
+  gemm<false, false>(d.Pmat, d.SC, d.KZ, true);
+  d.pvec.data = model.q.data;
+  gemm<false, false>(d.pvec, d.SC, d.kz, true);
+}
+
+template <typename Scalar, int Width>
+void BatchedRiccatiKernel<Scalar, Width>::stageKernelSolve(
+    const KnotType &model, StageFactorType &d, const StageFactorType &dn,
+    const Scalar mudyn, const Scalar mueq) {
+  ZoneScoped;
+  const uint nx = model.nx;
+  const uint nu = model.nu;
+
+  // proximal step on the dynamics, with E = -I
+  for (uint i = 0; i < nx; i++) {
+    for (uint j = 0; j <= i; j++)
+      d.schur(i, j) = mudyn * dn.Pmat(i, j);
+    d.schur(i, i) += Scalar(1);
+  }
+  ldlt(d.schur);
+  d.vx.data = dn.pvec.data;
+  gemm<false, false>(d.vx, dn.Pmat, model.f, true);
+  ldltSolveInPlace(d.schur, d.vx);
+  d.Vxx.data = dn.Pmat.data;
+  ldltSolveInPlace(d.schur, d.Vxx);
+  for (uint i = 0; i < nx; i++)
+    for (uint j = 0; j < i; j++)
+      d.Vxx(j, i) = d.Vxx(i, j);
+
+  gemm<false, false>(d.VA, d.Vxx, model.A, false);
+  gemm<false, false>(d.VB, d.Vxx, model.B, false);
+  d.Qhat.data = model.Q.data;
+  gemm<true, false>(d.Qhat, model.A, d.VA, true);
+  d.Rhat.data = model.R.data;
+  gemm<true, false>(d.Rhat, model.B, d.VB, true);
+  d.Shat.data = model.S.data;
+  gemm<true, false>(d.Shat, model.A, d.VB, true);
+  d.qhat.data = model.q.data;
+  gemm<true, false>(d.qhat, model.A, d.vx, true);
+
+  // factorize reduced KKT system
+  d.kkt.data.setZero();
+  setBlock<false>(d.kkt, 0, 0, d.Rhat);
+  setBlock<false>(d.kkt, nu, 0, model.D);
+  for (uint i = 0; i < model.nc; i++)
+    d.kkt(nu + i, nu + i).setConstant(-mueq);
+  ldlt(d.kkt);
+
+  // gains: the rhs is -[rhat; d] and -[Shat^T; C]
+  setBlock<false>(d.SC, 0, 0, d.Shat);
+  setBlock<true>(d.SC, 0, nu, model.C);
+  gemm<true, false>(d.kz, model.Bz, d.vx, false, -1);
+  for (uint i = 0; i < nu; i++)
+    d.kz(i, 0) -= model.r(i, 0);
+  for (uint i = 0; i < model.nc; i++)
+    d.kz(nu + i, 0) = -model.d(i, 0);
+  setBlock<true>(d.KZ, 0, 0, d.SC, -1);
+  ldltSolveInPlace(d.kkt, d.kz);
+  ldltSolveInPlace(d.kkt, d.KZ);
+
+  // closed-loop dynamics and costate
+  gemm<false, false>(d.bk, model.Bz, d.kz, false);
+  d.M.data = model.A.data;
+  gemm<false, false>(d.M, model.Bz, d.KZ, true);
+  d.lff.data = d.vx.data;
+  gemm<false, false>(d.lff, d.Vxx, d.bk, true);
+  gemm<false, false>(d.L, d.Vxx, d.M, false);
+  d.yff.data = model.f.data + d.bk.data - mudyn * d.lff.data;
+  d.Afb.data = d.M.data - mudyn * d.L.data;
+
+  d.Pmat.data = d.Qhat.data;
+  gemm<false, false>(d.Pmat, d.SC, d.KZ, true);
+  d.pvec.data = d.qhat.data;
+  gemm<false, false>(d.pvec, d.SC, d.kz, true);
+}
+
+template <typename Scalar, int Width>
+BatchedRiccatiSolver<Scalar, Width>::BatchedRiccatiSolver(
+    const std::vector<const ProblemType *> &problems, const uint num_threads,
+    ThreadPool *pool)
+    : groups(), num_threads(num_threads), problems_(problems), pool_(pool) {
+  ZoneScoped;
+  if (problems_.empty())
+    ALIGATOR_RUNTIME_ERROR("BatchedRiccatiSolver: no problems were given.");
+  const ProblemType &ref = *problems_[0];
+  const uint N = uint(ref.horizon());
+  const uint nc0 = ref.nc0();
+  for (const ProblemType *problem : problems_) {
+    if (problem->horizon() != ref.horizon() || problem->nc0() != nc0)
+      ALIGATOR_RUNTIME_ERROR(
+          "BatchedRiccatiSolver: the problems must have the same horizon "
+          "and initial constraint dimension.");
+    for (uint t = 0; t <= N; t++) {
+      const LQRKnotTpl<Scalar> &knot = problem->stages[t];
+      const LQRKnotTpl<Scalar> &rknot = ref.stages[t];
+      if (knot.nx != rknot.nx || knot.nu != rknot.nu || knot.nc != rknot.nc)
+        ALIGATOR_RUNTIME_ERROR(fmt::format(
+            "BatchedRiccatiSolver: dimensions of knot {:d} differ between "
+            "the problems.",
+            t));
+      if (knot.nth > 0)
+        ALIGATOR_RUNTIME_ERROR(
+            "BatchedRiccatiSolver: parameterized problems are not supported.");
+      if (t < N && (knot.nx2 != knot.nx ||
+                    !(knot.E + MatrixXs::Identity(knot.nx, knot.nx))
+                         .isZero(0)))
+        ALIGATOR_RUNTIME_ERROR(fmt::format(
+            "BatchedRiccatiSolver: knot {:d} does not have E = -I.", t));
+    }
+  }
+
+  const size_t num_groups = (problems_.size() + Width - 1) / Width;
+  groups.resize(num_groups);
+  for (Group &grp : groups) {
+    grp.knots.reserve(N + 1);
+    grp.datas.reserve(N + 1);
+    for (uint t = 0; t <= N; t++) {
+      const LQRKnotTpl<Scalar> &knot = ref.stages[t];
+      grp.knots.emplace_back(knot.nx, knot.nu, knot.nc);
+      grp.datas.emplace_back(knot.nx, knot.nu, knot.nc);
+      grp.xs.emplace_back(knot.nx, 1);
+      grp.uzs.emplace_back(knot.nu + knot.nc, 1);
+      grp.lbdas.emplace_back(t == 0 ? nc0 : ref.stages[t - 1].nx2, 1);
+    }
+    const uint nx0 = ref.stages[0].nx;
+    grp.G0 = Packed(nc0, nx0);
+    grp.g0 = Packed(nc0, 1);
+    grp.kkt0 = Packed(nx0 + nc0, nx0 + nc0);
+    grp.xl0 = Packed(nx0 + nc0, 1);
+  }
+}
+
+template <typename Scalar, int Width>
+void BatchedRiccatiSolver<Scalar, Width>::backwardGroup(size_t g,
+                                                        const Scalar mudyn,
+                                                        const Scalar mueq) {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  Group &grp = groups[g];
+  const uint N = uint(grp.knots.size() - 1);
+  {
+    ZoneScopedN("pack_knots");
+    for (uint k = 0; k < Width; k++) {
+      const ProblemType &problem = laneProblem(g, k);
+      for (uint t = 0; t <= N; t++)
+        grp.knots[t].setLane(k, problem.stages[t]);
+      grp.G0.setLane(k, problem.G0);
+      grp.g0.setLane(k, problem.g0);
+    }
+  }
+
+  Impl::terminalSolve(grp.knots[N], mueq, grp.datas[N]);
+  for (uint t = N; t > 0; t--) {
+    Impl::stageKernelSolve(grp.knots[t - 1], grp.datas[t - 1], grp.datas[t],
+                           mudyn, mueq);
+  }
+
+  // initial stage
+  const uint nx0 = grp.knots[0].nx;
+  const uint nc0 = grp.G0.rows();
+  const StageFactorType &d0 = grp.datas[0];
+  grp.kkt0.data.setZero();
+  Impl::template setBlock<false>(grp.kkt0, 0, 0, d0.Pmat);
+  Impl::template setBlock<false>(grp.kkt0, nx0, 0, grp.G0);
+  for (uint i = 0; i < nc0; i++)
+    grp.kkt0(nx0 + i, nx0 + i).setConstant(-mudyn);
+  Impl::ldlt(grp.kkt0);
+  Impl::template setBlock<false>(grp.xl0, 0, 0, d0.pvec, -1);
+  Impl::template setBlock<false>(grp.xl0, nx0, 0, grp.g0, -1);
+  Impl::ldltSolveInPlace(grp.kkt0, grp.xl0);
+}
+
+template <typename Scalar, int Width>
+bool BatchedRiccatiSolver<Scalar, Width>::backward(const Scalar mudyn,
+                                                   const Scalar mueq) {
+  ZoneScoped;
+  parallel_for(pool_, num_threads, groups.size(),
+               [&](size_t g) { backwardGroup(g, mudyn, mueq); });
+  return true;
+}
+
+template <typename Scalar, int Width>
+void BatchedRiccatiSolver<Scalar, Width>::forwardGroup(size_t g) {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  Group &grp = groups[g];
+  const uint N = uint(grp.knots.size() - 1);
+  const uint nx0 = grp.knots[0].nx;
+  for (uint i = 0; i < nx0; i++)
+    grp.xs[0](i, 0) = grp.xl0(i, 0);
+  for (uint i = 0; i < grp.lbdas[0].rows(); i++)
+    grp.lbdas[0](i, 0) = grp.xl0(nx0 + i, 0);
+
+  for (uint t = 0; t <= N; t++) {
+    const StageFactorType &d = grp.datas[t];
+    grp.uzs[t].data = d.kz.data;
+    Impl::template gemm<false, false>(grp.uzs[t], d.KZ, grp.xs[t], true);
+    if (t == N)
+      break;
+    grp.lbdas[t + 1].data = d.lff.data;
+    Impl::template gemm<false, false>(grp.lbdas[t + 1], d.L, grp.xs[t], true);
+    grp.xs[t + 1].data = d.yff.data;
+    Impl::template gemm<false, false>(grp.xs[t + 1], d.Afb, grp.xs[t], true);
+  }
+}
+
+template <typename Scalar, int Width>
+bool BatchedRiccatiSolver<Scalar, Width>::forward() {
+  ZoneScoped;
+  parallel_for(pool_, num_threads, groups.size(),
+               [&](size_t g) { forwardGroup(g); });
+  return true;
+}
+
+template <typename Scalar, int Width>
+void BatchedRiccatiSolver<Scalar, Width>::getSolution(
+    size_t i, std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+    std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas) const {
+  assert(i < problems_.size());
+  const Group &grp = groups[i / Width];
+  const uint k = uint(i % Width);
+  const uint N = uint(grp.knots.size() - 1);
+  for (uint t = 0; t <= N; t++) {
+    const KnotType &knot = grp.knots[t];
+    grp.xs[t].getLane(k, xs[t]);
+    grp.lbdas[t].getLane(k, lbdas[t]);
+    if (t < us.size()) {
+      for (uint j = 0; j < knot.nu; j++)
+        us[t][j] = grp.uzs[t](j, 0)(k);
+    }
+    for (uint j = 0; j < knot.nc; j++)
+      vs[t][j] = grp.uzs[t](knot.nu + j, 0)(k);
+  }
+}
+
+} // namespace gar
+} // namespace aligator
@@ -0,0 +1,14 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./batched-riccati.hpp"
+#include "aligator/context.hpp"
+
+namespace aligator {
+namespace gar {
+
+extern template struct BatchedRiccatiKernel<context::Scalar, 4>;
+extern template class BatchedRiccatiSolver<context::Scalar, 4>;
+
+} // namespace gar
+} // namespace aligator
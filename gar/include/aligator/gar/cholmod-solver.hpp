@@ -5,10 +5,14 @@
 #ifdef ALIGATOR_WITH_CHOLMOD
 #include <Eigen/CholmodSupport>
 
-#include "lqr-problem.hpp"
+#include "blk-matrix.hpp"
+#include "riccati-base.hpp"
 #include "utils.hpp"
 #include "aligator/context.hpp"
 
+#include <algorithm>
+#include <array>
+
 namespace aligator::gar {
 namespace helpers {
 /// @brief Helper to assign a dense matrix into a range of coefficients of a
@@ -39,128 +43,86 @@ void lqrCreateSparseMatrix(const LQRProblemTpl<Scalar> &problem,
                            Eigen::Matrix<Scalar, -1, 1> &rhs) {
   using Eigen::Index;
   const uint nrows = lqrNumRows(problem);
-  using knot_t = LQRKnotTpl<Scalar>;
-  const auto &knots = problem.stages;
-
-  if constexpr (!Update) {
-    mat.conservativeResize(nrows, nrows);
-    mat.setZero();
-  }
-
   rhs.conservativeResize(nrows);
-  rhs.setZero();
-  const size_t N = size_t(problem.horizon());
-  uint idx = 0;
-  {
-    uint nc0 = problem.nc0();
-    rhs.head(nc0) = problem.g0;
-    helpers::sparseAssignDenseBlock<Update>(0, nc0, problem.G0, mat);
-    helpers::sparseAssignDenseBlock<Update>(nc0, 0, problem.G0.transpose(),
-                                            mat);
-    for (Index kk = 0; kk < nc0; kk++) {
-      if constexpr (Update) {
-        mat.coeffRef(kk, kk) = -mudyn;
-      } else {
-        mat.insert(kk, kk) = -mudyn;
-      }
-    }
-    idx += nc0;
-  }
-
-  for (size_t t = 0; t <= N; t++) {
-    const knot_t &model = knots[t];
-    const uint n = model.nx + model.nu + model.nc;
-    // get block for current variables
-    auto rhsblk = rhs.segment(idx, n);
-
-    rhsblk.head(model.nx) = model.q;
-    rhsblk.segment(model.nx, model.nu) = model.r;
-    rhsblk.tail(model.nc) = model.d;
-
-    // fill-in Q block
-    helpers::sparseAssignDenseBlock<Update>(idx, idx, model.Q, mat);
-    const Index i0 = idx + model.nx; // u
-    // S block
-    helpers::sparseAssignDenseBlock<Update>(i0, idx, model.S.transpose(), mat);
-    helpers::sparseAssignDenseBlock<Update>(idx, i0, model.S, mat);
-    // R block
-    helpers::sparseAssignDenseBlock<Update>(i0, i0, model.R, mat);
-
-    const Index i1 = i0 + model.nu; // v
-    // C block
-    helpers::sparseAssignDenseBlock<Update>(i1, idx, model.C, mat);
-    helpers::sparseAssignDenseBlock<Update>(idx, i1, model.C.transpose(), mat);
-    // D block
-    helpers::sparseAssignDenseBlock<Update>(i1, i0, model.D, mat);
-    helpers::sparseAssignDenseBlock<Update>(i0, i1, model.D.transpose(), mat);
-
-    const Index i2 = i1 + model.nc;
-    // dual block
-    for (Index kk = i1; kk < i2; kk++) {
-      if constexpr (Update) {
-        mat.coeffRef(kk, kk) = -mueq;
-      } else {
-        mat.insert(kk, kk) = -mueq;
-      }
-    }
 
-    if (t != N) {
-      rhs.segment(idx + n, model.nx2) = model.f;
-
-      // A
-      helpers::sparseAssignDenseBlock<Update>(i2, idx, model.A, mat);
-      helpers::sparseAssignDenseBlock<Update>(idx, i2, model.A.transpose(),
-                                              mat);
-      // B
-      helpers::sparseAssignDenseBlock<Update>(i2, i0, model.B, mat);
-      helpers::sparseAssignDenseBlock<Update>(i0, i2, model.B.transpose(), mat);
-      // E
-      const Index i3 = i2 + model.nx2;
-      helpers::sparseAssignDenseBlock<Update>(i2, i3, model.E, mat);
-      helpers::sparseAssignDenseBlock<Update>(i3, i2, model.E.transpose(), mat);
-
-      for (Index kk = i2; kk < i3; kk++) {
-        if constexpr (Update) {
-          mat.coeffRef(kk, kk) = -mudyn;
-        } else {
-          mat.insert(kk, kk) = -mudyn;
-        }
-      }
-
-      idx += n + model.nx2;
-    }
+  if constexpr (Update) {
+    lqrAssembleSparseMatrix(problem, mudyn, mueq, rhs,
+                            [&](Index i, Index j, Scalar value) {
+                              mat.coeffRef(i, j) = value;
+                            });
+  } else {
+    // random insertions into a sparse matrix are quadratic in the number of
+    // nonzeros, build from triplets instead
+    std::vector<Eigen::Triplet<Scalar>> triplets;
+    lqrAssembleSparseMatrix(problem, mudyn, mueq, rhs,
+                            [&](Index i, Index j, Scalar value) {
+                              triplets.emplace_back(i, j, value);
+                            });
+    mat.resize(nrows, nrows);
+    mat.setFromTriplets(triplets.begin(), triplets.end());
   }
 }
 
+/// Factorization used by CholmodLqSolver.
+enum class CholmodFactorization {
+  /// Simplicial LDLT factorization of the (indefinite) KKT matrix.
+  SIMPLICIAL_LDLT,
+  /// Supernodal Cholesky factorization of the Schur complement of the
+  /// dual-regularized KKT matrix onto the primal variables. CHOLMOD's
+  /// supernodal factorization requires a positive-definite matrix, which the
+  /// KKT matrix is not. The condensed matrix is ill-conditioned for small
+  /// values of the dual regularization, so it relies on iterative
+  /// refinement, and the dual regularization must be positive.
+  SUPERNODAL_LLT
+};
+
 /// @brief A sparse solver for the linear-quadratic problem based on CHOLMOD.
-template <typename _Scalar> class CholmodLqSolver {
+/// @details The sparsity pattern of the KKT matrix only depends on the
+/// dimensions of the problem: it is analyzed once at construction, and
+/// backward() only writes the new coefficients in place (including the dual
+/// regularization) and runs the numerical factorization.
+/// The solver computes no feedback gains: the feedforward gains hold the
+/// solution itself, and the feedback gains are zero.
+template <typename _Scalar>
+class CholmodLqSolver : public RiccatiSolverBase<_Scalar> {
 public:
   using Scalar = _Scalar;
-  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  ALIGATOR_DYNAMIC_TYPEDEFS_WITH_ROW_TYPES(Scalar);
+  using Base = RiccatiSolverBase<Scalar>;
   using Problem = LQRProblemTpl<Scalar>;
   using SparseType = Eigen::SparseMatrix<Scalar>;
-  using Triplet = Eigen::Triplet<Scalar>;
+  using PermutationType = Eigen::PermutationMatrix<Eigen::Dynamic>;
 
-  explicit CholmodLqSolver(const Problem &problem, uint numRefinementSteps = 1);
+  explicit CholmodLqSolver(
+      const Problem &problem, uint numRefinementSteps = 1,
+      CholmodFactorization factorization =
+          CholmodFactorization::SIMPLICIAL_LDLT);
 
-  bool backward(const Scalar mudyn, const Scalar mueq) {
-    // update the sparse linear problem
-    lqrCreateSparseMatrix<true>(*problem_, mudyn, mueq, kktMatrix, kktRhs);
-    cholmod.factorize(kktMatrix);
-    return cholmod.info() == Eigen::Success;
-  }
+  bool backward(const Scalar mudyn, const Scalar mueq);
 
+  /// @warning The parameter @p theta is not supported, and ignored.
   bool forward(std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
-               std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas) const {
-    kktSol = cholmod.solve(-kktRhs);
-    kktResidual = kktRhs;
-    for (uint i = 0; i < numRefinementSteps; i++) {
-      kktResidual.noalias() += kktMatrix * kktSol;
-      kktSol += cholmod.solve(-kktResidual);
-    }
-    lqrDenseSolutionToTraj(*problem_, kktSol, xs, us, vs, lbdas);
+               std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
+               const std::optional<ConstVectorRef> &theta = std::nullopt) const;
+
+  VectorRef getFeedforward(size_t i) { return ffs[i].matrix(); }
+  RowMatrixRef getFeedback(size_t i) { return fbs[i].matrix(); }
+
+  /// Copy the new initial residual \f$g_0\f$ into the right-hand side
+  /// kktRhs. The next forward() call solves with the current factorization.
+  bool updateInitialResidual() {
+    kktRhs.head(problem_->nc0()) = problem_->g0;
     return true;
-  };
+  }
+
+  /// Re-assemble the right-hand side kktRhs from the vectors of the problem,
+  /// leaving the KKT matrix and its factorization untouched. The next
+  /// forward() call solves with the current factorization.
+  bool backwardRhs(const Scalar mudyn, const Scalar mueq) {
+    lqrAssembleSparseMatrix(*problem_, mudyn, mueq, kktRhs,
+                            [](Eigen::Index, Eigen::Index, Scalar) {});
+    return true;
+  }
 
   Scalar computeSparseResidual() const {
     kktResidual = kktRhs;
@@ -168,6 +130,8 @@ public:
     return math::infty_norm(kktResidual);
   }
 
+  CholmodFactorization factorization() const { return factorization_; }
+
   /// Linear problem matrix
   SparseType kktMatrix;
   /// Linear problem rhs
@@ -177,23 +141,272 @@ public:
   /// Linear problem solution
   mutable VectorXs kktSol;
   Eigen::CholmodSimplicialLDLT<SparseType> cholmod;
+  /// Factorization of the condensed matrix, see
+  /// CholmodFactorization::SUPERNODAL_LLT.
+  Eigen::CholmodSupernodalLLT<SparseType> cholmodSupernodal;
+  /// Schur complement of the KKT matrix onto the primal variables.
+  SparseType condensedMatrix;
   /// Number of iterative refinement steps.
   uint numRefinementSteps;
 
 protected:
+  /// Solve the KKT system in place, with the current factorization.
+  void solveInPlace(VectorXs &rhs) const;
+  /// Build the sparsity patterns of the condensed matrix and of the
+  /// primal-dual block, see CholmodFactorization::SUPERNODAL_LLT.
+  void analyzeCondensedPattern();
+  /// Compute the values of the condensed matrix from the KKT matrix, in place.
+  void condense();
+
   const Problem *problem_;
+  CholmodFactorization factorization_;
+  /// Offset, in the values of kktMatrix, of each coefficient visited by
+  /// lqrAssembleSparseMatrix().
+  std::vector<Eigen::Index> valueIndices_;
+  /// Puts the primal variables of the KKT system first.
+  PermutationType perm_;
+  Eigen::Index numPrimal_;
+  /// Primal-dual block of the permuted KKT matrix.
+  SparseType kktPrimalDual_;
+  /// Inverse of the dual regularization of each dual variable.
+  VectorXs dualWeights_;
+  /// Offset, in the values of kktMatrix, of each coefficient of
+  /// kktPrimalDual_.
+  std::vector<Eigen::Index> primalDualSrc_;
+  /// Offset, in the values of kktMatrix, of the regularization of each dual
+  /// variable.
+  std::vector<Eigen::Index> dualDiagSrc_;
+  /// Offsets of the primal block coefficients, in the values of kktMatrix and
+  /// of condensedMatrix.
+  std::vector<std::pair<Eigen::Index, Eigen::Index>> primalSrcDst_;
+  /// For each product of two coefficients of the same column of
+  /// kktPrimalDual_, the offset it is added to in the values of
+  /// condensedMatrix and the offsets of both coefficients. The products of
+  /// column k are in the range [productStart_[k], productStart_[k+1]).
+  std::vector<std::array<Eigen::Index, 3>> products_;
+  std::vector<Eigen::Index> productStart_;
+  mutable VectorXs permRhs_;
+  mutable std::vector<BlkMatrix<VectorXs, 4, 1>> ffs;
+  std::vector<BlkMatrix<RowMatrixXs, 4, 1>> fbs;
 };
 
 template <typename Scalar>
 CholmodLqSolver<Scalar>::CholmodLqSolver(const Problem &problem,
-                                         uint numRefinementSteps)
-    : kktMatrix(), kktRhs(), cholmod(), numRefinementSteps(numRefinementSteps),
-      problem_(&problem) {
+                                         uint numRefinementSteps,
+                                         CholmodFactorization factorization)
+    : Base(), kktMatrix(), kktRhs(), cholmod(),
+      numRefinementSteps(numRefinementSteps), problem_(&problem),
+      factorization_(factorization) {
+  using Eigen::Index;
   lqrCreateSparseMatrix<false>(problem, 1., 1., kktMatrix, kktRhs);
   assert(kktMatrix.cols() == kktRhs.rows());
   kktSol.resize(kktRhs.rows());
   kktResidual.resize(kktRhs.rows());
-  cholmod.analyzePattern(kktMatrix);
+
+  // cache where each coefficient goes, so that backward() only writes values
+  valueIndices_.reserve(size_t(kktMatrix.nonZeros()));
+  lqrAssembleSparseMatrix(problem, Scalar(1.), Scalar(1.), kktRhs,
+                          [&](Index i, Index j, Scalar) {
+                            valueIndices_.push_back(
+                                Index(&kktMatrix.coeffRef(i, j) -
+                                      kktMatrix.valuePtr()));
+                          });
+  assert(Index(valueIndices_.size()) == kktMatrix.nonZeros());
+
+  const uint N = uint(problem.horizon());
+  for (uint t = 0; t <= N; t++) {
+    const LQRKnotTpl<Scalar> &knot = problem.stages[t];
+    std::array<long, 4> dims{knot.nu, knot.nc, knot.nx2, knot.nx2};
+    ffs.emplace_back(dims, std::array<long, 1>{1});
+    fbs.emplace_back(dims, std::array<long, 1>{knot.nx});
+    ffs.back().setZero();
+    fbs.back().setZero();
+  }
+
+  if (factorization_ == CholmodFactorization::SIMPLICIAL_LDLT) {
+    cholmod.analyzePattern(kktMatrix);
+    return;
+  }
+
+  // primal variables first, then the dual variables
+  const Index n = kktMatrix.rows();
+  std::vector<bool> isDual(size_t(n), false);
+  {
+    Index idx = 0;
+    for (Index k = 0; k < problem.nc0(); k++)
+      isDual[size_t(idx++)] = true;
+    for (uint t = 0; t <= N; t++) {
+      const LQRKnotTpl<Scalar> &knot = problem.stages[t];
+      idx += knot.nx + knot.nu;
+      for (uint k = 0; k < knot.nc; k++)
+        isDual[size_t(idx++)] = true;
+      if (t < N) {
+        for (uint k = 0; k < knot.nx2; k++)
+          isDual[size_t(idx++)] = true;
+      }
+    }
+  }
+  perm_.resize(n);
+  numPrimal_ = Index(std::count(isDual.begin(), isDual.end(), false));
+  Index ip = 0, id = numPrimal_;
+  for (Index k = 0; k < n; k++)
+    perm_.indices()[k] = int(isDual[size_t(k)] ? id++ : ip++);
+  permRhs_.resize(n);
+  analyzeCondensedPattern();
+  condense();
+  cholmodSupernodal.analyzePattern(condensedMatrix);
+}
+
+template <typename Scalar>
+void CholmodLqSolver<Scalar>::analyzeCondensedPattern() {
+  using Eigen::Index;
+  using Triplet = Eigen::Triplet<Scalar>;
+  const Index np = numPrimal_;
+  const Index nd = kktMatrix.rows() - np;
+  const int *p = perm_.indices().data();
+  const Scalar *values = kktMatrix.valuePtr();
+  auto offset = [](const Scalar &value, const Scalar *ptr) {
+    return Index(&value - ptr);
+  };
+
+  // split the coefficients of the permuted KKT matrix into its primal block,
+  // its primal-dual block and the dual regularization, which is diagonal
+  std::vector<Triplet> primalTriplets, primalDualTriplets;
+  dualDiagSrc_.assign(size_t(nd), -1);
+  for (Index j = 0; j < kktMatrix.outerSize(); j++) {
+    for (typename SparseType::InnerIterator it(kktMatrix, j); it; ++it) {
+      const Index pi = p[it.row()], pj = p[j];
+      if (pi < np && pj < np)
+        primalTriplets.emplace_back(pi, pj);
+      else if (pi < np)
+        primalDualTriplets.emplace_back(pi, pj - np);
+      else if (pj >= np) {
+        assert(pi == pj && "Off-diagonal coefficient in the dual block.");
+        dualDiagSrc_[size_t(pi - np)] = offset(it.valueRef(), values);
+      }
+    }
+  }
+  kktPrimalDual_.resize(np, nd);
+  kktPrimalDual_.setFromTriplets(primalDualTriplets.begin(),
+                                 primalDualTriplets.end());
+  dualWeights_.resize(nd);
+
+  // pattern of the condensed matrix: primal block, and outer products of the
+  // columns of the primal-dual block
+  for (Index k = 0; k < nd; k++) {
+    for (typename SparseType::InnerIterator a(kktPrimalDual_, k); a; ++a)
+      for (typename SparseType::InnerIterator b(kktPrimalDual_, k); b; ++b)
+        primalTriplets.emplace_back(a.row(), b.row());
+  }
+  condensedMatrix.resize(np, np);
+  condensedMatrix.setFromTriplets(primalTriplets.begin(), primalTriplets.end());
+
+  // cache where each coefficient is read from and added to
+  const Scalar *pdValues = kktPrimalDual_.valuePtr();
+  const Scalar *condValues = condensedMatrix.valuePtr();
+  primalDualSrc_.assign(size_t(kktPrimalDual_.nonZeros()), -1);
+  primalSrcDst_.clear();
+  for (Index j = 0; j < kktMatrix.outerSize(); j++) {
+    for (typename SparseType::InnerIterator it(kktMatrix, j); it; ++it) {
+      const Index pi = p[it.row()], pj = p[j];
+      const Index src = offset(it.valueRef(), values);
+      if (pi < np && pj < np)
+        primalSrcDst_.emplace_back(
+            src, offset(condensedMatrix.coeffRef(pi, pj), condValues));
+      else if (pi < np)
+        primalDualSrc_[size_t(offset(kktPrimalDual_.coeffRef(pi, pj - np),
+                                     pdValues))] = src;
+    }
+  }
+  products_.clear();
+  productStart_.assign(1, 0);
+  for (Index k = 0; k < nd; k++) {
+    for (typename SparseType::InnerIterator a(kktPrimalDual_, k); a; ++a)
+      for (typename SparseType::InnerIterator b(kktPrimalDual_, k); b; ++b)
+        products_.push_back(
+            {offset(condensedMatrix.coeffRef(a.row(), b.row()), condValues),
+             offset(a.valueRef(), pdValues), offset(b.valueRef(), pdValues)});
+    productStart_.push_back(Eigen::Index(products_.size()));
+  }
+}
+
+template <typename Scalar> void CholmodLqSolver<Scalar>::condense() {
+  const Scalar *values = kktMatrix.valuePtr();
+  Scalar *pdValues = kktPrimalDual_.valuePtr();
+  Scalar *condValues = condensedMatrix.valuePtr();
+  for (size_t k = 0; k < primalDualSrc_.size(); k++)
+    pdValues[k] = values[primalDualSrc_[k]];
+  for (size_t k = 0; k < dualDiagSrc_.size(); k++)
+    dualWeights_[Eigen::Index(k)] = -1. / values[dualDiagSrc_[k]];
+
+  std::fill_n(condValues, condensedMatrix.nonZeros(), Scalar(0.));
+  for (const auto &[src, dst] : primalSrcDst_)
+    condValues[dst] += values[src];
+  for (size_t k = 0; k < dualDiagSrc_.size(); k++) {
+    const Scalar w = dualWeights_[Eigen::Index(k)];
+    for (Eigen::Index l = productStart_[k]; l < productStart_[k + 1]; l++) {
+      const auto &[dst, a, b] = products_[size_t(l)];
+      condValues[dst] += w * pdValues[a] * pdValues[b];
+    }
+  }
+}
+
+template <typename Scalar>
+bool CholmodLqSolver<Scalar>::backward(const Scalar mudyn, const Scalar mueq) {
+  ZoneScoped;
+  // update the values of the sparse linear problem in place
+  Scalar *values = kktMatrix.valuePtr();
+  size_t k = 0;
+  lqrAssembleSparseMatrix(*problem_, mudyn, mueq, kktRhs,
+                          [&](Eigen::Index, Eigen::Index, Scalar value) {
+                            values[valueIndices_[k++]] = value;
+                          });
+  if (factorization_ == CholmodFactorization::SIMPLICIAL_LDLT) {
+    cholmod.factorize(kktMatrix);
+    return cholmod.info() == Eigen::Success;
+  }
+  condense();
+  cholmodSupernodal.factorize(condensedMatrix);
+  return cholmodSupernodal.info() == Eigen::Success;
+}
+
+template <typename Scalar>
+void CholmodLqSolver<Scalar>::solveInPlace(VectorXs &rhs) const {
+  if (factorization_ == CholmodFactorization::SIMPLICIAL_LDLT) {
+    rhs = cholmod.solve(rhs);
+    return;
+  }
+  const Eigen::Index nd = kktMatrix.rows() - numPrimal_;
+  permRhs_ = perm_ * rhs;
+  auto bp = permRhs_.head(numPrimal_);
+  auto bd = permRhs_.tail(nd);
+  // eliminate the dual variables
+  bd.array() *= dualWeights_.array();
+  bp.noalias() += kktPrimalDual_ * bd;
+  bp = cholmodSupernodal.solve(bp);
+  bd.noalias() -= dualWeights_.asDiagonal() * (kktPrimalDual_.transpose() * bp);
+  bd *= -1;
+  rhs = perm_.transpose() * permRhs_;
+}
+
+template <typename Scalar>
+bool CholmodLqSolver<Scalar>::forward(
+    std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+    std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
+    const std::optional<ConstVectorRef> &) const {
+  ZoneScoped;
+  kktSol = -kktRhs;
+  solveInPlace(kktSol);
+  for (uint i = 0; i < numRefinementSteps; i++) {
+    kktResidual = kktRhs;
+    kktResidual.noalias() += kktMatrix * kktSol;
+    kktResidual *= -1;
+    solveInPlace(kktResidual);
+    kktSol += kktResidual;
+  }
+
+  lqrSolutionToTrajAndGains(*problem_, kktSol, xs, us, vs, lbdas, ffs);
+  return true;
 }
 
 #ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
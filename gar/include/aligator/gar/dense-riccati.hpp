@@ -65,6 +65,18 @@ public:
   VectorRef getFeedforward(size_t i) { return datas[i].ff.matrix(); }
   RowMatrixRef getFeedback(size_t i) { return datas[i].fb.matrix(); }
 
+  bool cycleLeft() {
+    rotate_vec_left(datas, 0, 1);
+    rotate_vec_left(Pxx, 0, 1);
+    rotate_vec_left(Pxt, 0, 1);
+    rotate_vec_left(Ptt, 0, 1);
+    rotate_vec_left(px, 0, 1);
+    rotate_vec_left(pt, 0, 1);
+    return true;
+  }
+
+  bool updateInitialResidual();
+
 protected:
   void initialize();
   const LQRProblemTpl<Scalar> *problem_;
@@ -187,6 +187,16 @@ bool RiccatiSolverDense<Scalar>::backward(const Scalar mudyn,
   return true;
 }
 
+template <typename Scalar>
+bool RiccatiSolverDense<Scalar>::updateInitialResidual() {
+  ZoneScoped;
+  kkt0.ff[0] = -px[0];
+  kkt0.ff[1] = -problem_->g0;
+  kkt0.ldl.solveInPlace(kkt0.ff.matrix());
+  thGrad.noalias() = pt[0] + Pxt[0].transpose() * kkt0.ff[0];
+  return true;
+}
+
 template <typename Scalar>
 bool RiccatiSolverDense<Scalar>::forward(
     std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
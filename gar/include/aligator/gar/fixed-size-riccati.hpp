@@ -0,0 +1,238 @@
+/// @file fixed-size-riccati.hpp
+/// @brief Proximal Riccati kernel and solver with compile-time dimensions.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "riccati-base.hpp"
+#include "riccati-impl.hpp"
+#include "lqr-problem.hpp"
+
+#include <memory>
+#include <tuple>
+
+namespace aligator {
+namespace gar {
+
+/// @brief Per-node factorization data with compile-time state ( @p NX ),
+/// control ( @p NU ) and constraint ( @p NC ) dimensions.
+/// @details Fixed-size counterpart of StageFactor<Scalar> for running knots
+/// without parameterization and with the same state dimension on both ends.
+/// All buffers live inside the struct, and all the products in the kernel are
+/// unrolled by Eigen. The gains are stored with the same layout as the
+/// dynamic-size factor.
+template <typename _Scalar, int NX, int NU, int NC> struct StageFactor {
+  static_assert(NX > 0 && NU > 0 && NC >= 0,
+                "Fixed-size stage factors need positive state and control "
+                "dimensions.");
+  using Scalar = _Scalar;
+  enum { NK = NU + NC, NTOT = NU + NC + 2 * NX };
+
+  using MatrixXX = Eigen::Matrix<Scalar, NX, NX>;
+  using MatrixUU = Eigen::Matrix<Scalar, NU, NU>;
+  using MatrixXU = Eigen::Matrix<Scalar, NX, NU>;
+  using MatrixUX = Eigen::Matrix<Scalar, NU, NX>;
+  using MatrixKK = Eigen::Matrix<Scalar, NK, NK>;
+  using VectorX = Eigen::Matrix<Scalar, NX, 1>;
+  using VectorU = Eigen::Matrix<Scalar, NU, 1>;
+  /// Feedforward gains \f$(k, z, \xi, a)\f$.
+  using FfType = Eigen::Matrix<Scalar, NTOT, 1>;
+  /// Feedback gains \f$(K, Z, \Xi, A)\f$.
+  using FbType = Eigen::Matrix<Scalar, NTOT, NX,
+                               NX == 1 ? Eigen::ColMajor : Eigen::RowMajor>;
+
+  struct value_t {
+    MatrixXX Pmat; //< Riccati matrix
+    VectorX pvec;  //< Riccati bias
+    MatrixXX Vxx;  //< "cost-to-go" matrix
+    VectorX vx;    //< "cost-to-go" gradient
+
+    value_t() {
+      Pmat.setZero();
+      pvec.setZero();
+      Vxx.setZero();
+      vx.setZero();
+    }
+  };
+
+  StageFactor() {
+    Qhat.setZero();
+    Rhat.setZero();
+    Shat.setZero();
+    qhat.setZero();
+    rhat.setZero();
+    AtV.setZero();
+    BtV.setZero();
+    ff.setZero();
+    fb.setZero();
+    kktMat.setZero();
+    yff_pre.setZero();
+    A_pre.setZero();
+    Ptilde.setZero();
+    Einv.setZero();
+    EinvP.setZero();
+    schurMat.setZero();
+  }
+
+  MatrixXX Qhat;
+  MatrixUU Rhat;
+  MatrixXU Shat;
+  VectorX qhat;
+  VectorU rhat;
+  MatrixXX AtV;
+  MatrixUX BtV;
+
+  FfType ff;                             //< feedforward gains
+  FbType fb;                             //< feedback gains
+  MatrixKK kktMat;                       //< reduced KKT matrix buffer
+  Eigen::LDLT<MatrixKK> kktChol;         //< reduced KKT LDLT solver
+  Eigen::PartialPivLU<MatrixXX> Efact;   //< LU decomp. of E matrix
+  VectorX yff_pre;
+  MatrixXX A_pre;
+  MatrixXX Ptilde;                //< product Et.inv P * E.inv
+  MatrixXX Einv;                  //< inverse of E
+  MatrixXX EinvP;                 //< product Et.inv * P
+  MatrixXX schurMat;              //< Dual-space Schur matrix
+  Eigen::LLT<MatrixXX> schurChol; //< Cholesky decomposition of Schur matrix
+  value_t vm;                     //< cost-to-go parameters
+};
+
+/// @brief Proximal Riccati kernel with compile-time dimensions, for the
+/// running knots of the problem.
+/// @details Same recursion as ProximalRiccatiKernel<Scalar>, without the
+/// parametric terms. The knot data is read through fixed-size maps.
+template <typename Scalar, int NX, int NU, int NC>
+struct ProximalRiccatiKernel {
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using KnotType = LQRKnotTpl<Scalar>;
+  using StageFactorType = StageFactor<Scalar, NX, NU, NC>;
+  using value_t = typename StageFactorType::value_t;
+
+  /// Whether this kernel can process the running knot @p knot.
+  static bool matchesKnot(const KnotType &knot) {
+    return (knot.nx == NX) && (knot.nu == NU) && (knot.nc == NC) &&
+           (knot.nx2 == NX) && (knot.nth == 0);
+  }
+
+  inline static void stageKernelSolve(const KnotType &model, StageFactorType &d,
+                                      value_t &vn, const Scalar mudyn,
+                                      const Scalar mueq);
+
+  /// @brief Backward sweep over the running knots.
+  /// @param vterm  Value function at the end of the span (input).
+  inline static bool backwardImpl(boost::span<const KnotType> stages,
+                                  const Scalar mudyn, const Scalar mueq,
+                                  boost::span<StageFactorType> datas,
+                                  value_t &vterm);
+
+  inline static void stageKernelSolveRhs(const KnotType &model,
+                                         StageFactorType &d, value_t &vn,
+                                         const Scalar mudyn);
+
+  /// @brief Backward sweep for the vectors of the running knots only, reusing
+  /// the factorizations and gains from the last backwardImpl() call.
+  /// @param vterm  Value function at the end of the span (input, only its
+  /// vector `pvec` needs to be up to date).
+  inline static bool backwardRhsImpl(boost::span<const KnotType> stages,
+                                     const Scalar mudyn,
+                                     boost::span<StageFactorType> datas,
+                                     value_t &vterm);
+
+  /// @brief Forward sweep over the running knots. This computes the controls,
+  /// path multipliers and co-states for all the knots in the span, and all
+  /// the states after the first one.
+  inline static bool forwardImpl(boost::span<const KnotType> stages,
+                                 boost::span<const StageFactorType> datas,
+                                 boost::span<VectorXs> xs,
+                                 boost::span<VectorXs> us,
+                                 boost::span<VectorXs> vs,
+                                 boost::span<VectorXs> lbdas);
+};
+
+/// @brief Proximal Riccati solver using the fixed-size kernel for the running
+/// knots, and the dynamic-size kernel for the terminal knot.
+/// @details The problem must not be parameterized, and all its running knots
+/// must have dimensions `(NX, NU, NC)` (see supportsProblem()). Use
+/// createProximalRiccatiSolver() to pick this solver automatically.
+template <typename _Scalar, int NX, int NU, int NC>
+class ProximalRiccatiSolverFixed : public RiccatiSolverBase<_Scalar> {
+public:
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS_WITH_ROW_TYPES(Scalar);
+  using Base = RiccatiSolverBase<Scalar>;
+  using Impl = ProximalRiccatiKernel<Scalar, NX, NU, NC>;
+  using DynamicImpl = ProximalRiccatiKernel<Scalar>;
+  using StageFactorType = StageFactor<Scalar, NX, NU, NC>;
+  using value_t = typename StageFactorType::value_t;
+  using kkt0_t = typename DynamicImpl::kkt0_t;
+  using KnotType = LQRKnotTpl<Scalar>;
+
+  explicit ProximalRiccatiSolverFixed(const LQRProblemTpl<Scalar> &problem);
+
+  /// Whether the dimensions of @p problem match this solver.
+  static bool supportsProblem(const LQRProblemTpl<Scalar> &problem);
+
+  bool backward(const Scalar mudyn, const Scalar mueq);
+
+  /// @param theta  Must be empty if given, since the problem is not
+  /// parameterized.
+  bool forward(std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+               std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
+               const std::optional<ConstVectorRef> &theta = std::nullopt) const;
+
+  VectorRef getFeedforward(size_t i) {
+    if (i < datas.size())
+      return datas[i].ff;
+    return terminal.ff.matrix();
+  }
+  RowMatrixRef getFeedback(size_t i) {
+    if (i < datas.size())
+      return datas[i].fb;
+    return terminal.fb.matrix();
+  }
+
+  bool cycleLeft() {
+    rotate_vec_left(datas);
+    return true;
+  }
+
+  bool updateInitialResidual();
+
+  bool backwardRhs(const Scalar mudyn, const Scalar mueq);
+
+  std::vector<StageFactorType> datas; //< running knots
+  StageFactor<Scalar> terminal;       //< terminal knot
+  value_t vterm;                      //< terminal value function
+  kkt0_t kkt0;                        //< initial stage KKT system
+
+protected:
+  const LQRProblemTpl<Scalar> *problem_;
+};
+
+/// Dimensions `(NX, NU, NC)` for which createProximalRiccatiSolver() uses a
+/// fixed-size solver: small systems without path constraints, or with one
+/// constraint per control (e.g. control bounds).
+template <int NX, int NU, int NC> struct fixed_riccati_dims {
+  static constexpr int nx = NX;
+  static constexpr int nu = NU;
+  static constexpr int nc = NC;
+};
+using common_fixed_riccati_dims =
+    std::tuple<fixed_riccati_dims<4, 2, 0>, fixed_riccati_dims<6, 3, 0>,
+               fixed_riccati_dims<12, 4, 0>, fixed_riccati_dims<4, 2, 2>,
+               fixed_riccati_dims<6, 3, 3>, fixed_riccati_dims<12, 4, 4>>;
+
+/// @brief Create a proximal Riccati solver for @p problem. If its knot
+/// dimensions are one of common_fixed_riccati_dims, the fixed-size solver is
+/// used; otherwise, this falls back to ProximalRiccatiSolver.
+template <typename Scalar>
+std::unique_ptr<RiccatiSolverBase<Scalar>>
+createProximalRiccatiSolver(const LQRProblemTpl<Scalar> &problem);
+
+} // namespace gar
+} // namespace aligator
+
+#include "./fixed-size-riccati.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "./fixed-size-riccati.txx"
+#endif
@@ -0,0 +1,392 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./fixed-size-riccati.hpp"
+#include "./proximal-riccati.hpp"
+
+#include <tracy/Tracy.hpp>
+
+namespace aligator {
+namespace gar {
+
+template <typename Scalar, int NX, int NU, int NC>
+void ProximalRiccatiKernel<Scalar, NX, NU, NC>::stageKernelSolve(
+    const KnotType &model, StageFactorType &d, value_t &vn, const Scalar mudyn,
+    const Scalar mueq) {
+  ZoneScoped;
+  using Eigen::Map;
+  using MatrixXX = typename StageFactorType::MatrixXX;
+  using MatrixUU = typename StageFactorType::MatrixUU;
+  using MatrixXU = typename StageFactorType::MatrixXU;
+  using VectorX = typename StageFactorType::VectorX;
+  using VectorU = typename StageFactorType::VectorU;
+  using MatrixCX = Eigen::Matrix<Scalar, NC, NX>;
+  using MatrixCU = Eigen::Matrix<Scalar, NC, NU>;
+  using VectorC = Eigen::Matrix<Scalar, NC, 1>;
+  enum { NK = StageFactorType::NK };
+
+  const Map<const MatrixXX> A(model.A.data());
+  const Map<const MatrixXU> B(model.B.data());
+  const Map<const MatrixXX> E(model.E.data());
+  const Map<const VectorX> f(model.f.data());
+  const Map<const MatrixXX> Q(model.Q.data());
+  const Map<const MatrixXU> S(model.S.data());
+  const Map<const MatrixUU> R(model.R.data());
+  const Map<const VectorX> q(model.q.data());
+  const Map<const VectorU> r(model.r.data());
+  const Map<const MatrixCX> C(model.C.data());
+  const Map<const MatrixCU> D(model.D.data());
+  const Map<const VectorC> dvec(model.d.data());
+
+  const bool E_minus_identity = model.structure.E_minus_identity;
+
+  // step 1. compute decomposition of the E matrix
+  auto &ptilde = vn.vx; // just an alias
+  if (E_minus_identity) {
+    // Einv = -I
+    ptilde = vn.pvec;
+    d.Ptilde = vn.Pmat;
+  } else {
+    d.Efact.compute(E);
+    d.Einv = d.Efact.inverse();
+    ptilde.noalias() = -d.Einv.transpose() * vn.pvec;
+    d.EinvP.noalias() = d.Einv.transpose() * vn.Pmat;
+    d.Ptilde.noalias() = d.EinvP * d.Einv;
+  }
+  d.Ptilde = d.Ptilde.template selfadjointView<Eigen::Lower>();
+
+  d.schurMat.setIdentity();
+  d.schurMat.noalias() += mudyn * d.Ptilde;
+
+  d.schurChol.compute(d.schurMat);
+  vn.Vxx = d.Ptilde;
+  vn.vx.noalias() += d.Ptilde * f;
+  d.schurChol.solveInPlace(vn.vx);
+  d.schurChol.solveInPlace(vn.Vxx);
+  vn.Vxx = vn.Vxx.template selfadjointView<Eigen::Lower>();
+
+  d.AtV.noalias() = A.transpose() * vn.Vxx;
+  d.BtV.noalias() = B.transpose() * vn.Vxx;
+
+  d.Qhat.noalias() = Q + d.AtV * A;
+  d.Rhat.noalias() = R + d.BtV * B;
+  d.Shat.noalias() = S + d.AtV * B;
+  d.qhat.noalias() = q + A.transpose() * vn.vx;
+  d.rhat.noalias() = r + B.transpose() * vn.vx;
+
+  // factorize reduced KKT system
+  d.kktMat.template topLeftCorner<NU, NU>() = d.Rhat;
+  d.kktMat.template bottomLeftCorner<NC, NU>() = D;
+  d.kktMat.template bottomRightCorner<NC, NC>().setZero();
+  d.kktMat.template bottomRightCorner<NC, NC>().diagonal().setConstant(-mueq);
+  d.kktMat = d.kktMat.template selfadjointView<Eigen::Lower>();
+  d.kktChol.compute(d.kktMat);
+
+  auto kff = d.ff.template segment<NU>(0);
+  auto zff = d.ff.template segment<NC>(NU);
+  auto lff = d.ff.template segment<NX>(NK);
+  auto yff = d.ff.template segment<NX>(NK + NX);
+
+  auto K = d.fb.template middleRows<NU>(0);
+  auto Z = d.fb.template middleRows<NC>(NU);
+  auto L = d.fb.template middleRows<NX>(NK);
+  auto Acl = d.fb.template middleRows<NX>(NK + NX);
+
+  // fill feedback system
+  kff = -d.rhat;
+  zff = -dvec;
+  K = -d.Shat.transpose();
+  Z = -C;
+  auto ffview = d.ff.template head<NK>();
+  auto fbview = d.fb.template topRows<NK>();
+  d.kktChol.solveInPlace(ffview);
+  d.kktChol.solveInPlace(fbview);
+
+  // set closed loop dynamics
+  lff.noalias() = vn.vx + d.BtV.transpose() * kff;
+  d.yff_pre = f;
+  d.yff_pre.noalias() += B * kff;
+  d.yff_pre -= mudyn * lff;
+  if (E_minus_identity)
+    yff = d.yff_pre;
+  else
+    yff.noalias() = -d.Einv * d.yff_pre;
+
+  L.noalias() = vn.Vxx * A;
+  L.noalias() += d.BtV.transpose() * K;
+
+  d.A_pre = A;
+  d.A_pre.noalias() += B * K;
+  d.A_pre -= mudyn * L;
+  if (E_minus_identity)
+    Acl = d.A_pre;
+  else
+    Acl.noalias() = -d.Einv * d.A_pre;
+
+  value_t &vc = d.vm;
+  vc.Pmat.noalias() = d.Qhat + d.Shat * K + C.transpose() * Z;
+  vc.pvec.noalias() = d.qhat + d.Shat * kff + C.transpose() * zff;
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+bool ProximalRiccatiKernel<Scalar, NX, NU, NC>::backwardImpl(
+    boost::span<const KnotType> stages, const Scalar mudyn, const Scalar mueq,
+    boost::span<StageFactorType> datas, value_t &vterm) {
+  ZoneScoped;
+  const std::size_t N = datas.size();
+  if (N == 0)
+    return true;
+
+  std::size_t t = N - 1;
+  stageKernelSolve(stages[t], datas[t], vterm, mudyn, mueq);
+  while (t > 0) {
+    --t;
+    stageKernelSolve(stages[t], datas[t], datas[t + 1].vm, mudyn, mueq);
+  }
+  return true;
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+void ProximalRiccatiKernel<Scalar, NX, NU, NC>::stageKernelSolveRhs(
+    const KnotType &model, StageFactorType &d, value_t &vn,
+    const Scalar mudyn) {
+  ZoneScoped;
+  using Eigen::Map;
+  using MatrixXX = typename StageFactorType::MatrixXX;
+  using MatrixXU = typename StageFactorType::MatrixXU;
+  using VectorX = typename StageFactorType::VectorX;
+  using VectorU = typename StageFactorType::VectorU;
+  using MatrixCX = Eigen::Matrix<Scalar, NC, NX>;
+  using VectorC = Eigen::Matrix<Scalar, NC, 1>;
+  enum { NK = StageFactorType::NK };
+
+  const Map<const MatrixXX> A(model.A.data());
+  const Map<const MatrixXU> B(model.B.data());
+  const Map<const VectorX> f(model.f.data());
+  const Map<const VectorX> q(model.q.data());
+  const Map<const VectorU> r(model.r.data());
+  const Map<const MatrixCX> C(model.C.data());
+  const Map<const VectorC> dvec(model.d.data());
+
+  const bool E_minus_identity = model.structure.E_minus_identity;
+
+  auto &ptilde = vn.vx; // just an alias
+  if (E_minus_identity)
+    ptilde = vn.pvec;
+  else
+    ptilde.noalias() = -d.Einv.transpose() * vn.pvec;
+  vn.vx.noalias() += d.Ptilde * f;
+  d.schurChol.solveInPlace(vn.vx);
+
+  d.qhat.noalias() = q + A.transpose() * vn.vx;
+  d.rhat.noalias() = r + B.transpose() * vn.vx;
+
+  auto kff = d.ff.template segment<NU>(0);
+  auto zff = d.ff.template segment<NC>(NU);
+  auto lff = d.ff.template segment<NX>(NK);
+  auto yff = d.ff.template segment<NX>(NK + NX);
+
+  kff = -d.rhat;
+  zff = -dvec;
+  auto ffview = d.ff.template head<NK>();
+  d.kktChol.solveInPlace(ffview);
+
+  lff.noalias() = vn.vx + d.BtV.transpose() * kff;
+  d.yff_pre = f;
+  d.yff_pre.noalias() += B * kff;
+  d.yff_pre -= mudyn * lff;
+  if (E_minus_identity)
+    yff = d.yff_pre;
+  else
+    yff.noalias() = -d.Einv * d.yff_pre;
+
+  d.vm.pvec.noalias() = d.qhat + d.Shat * kff + C.transpose() * zff;
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+bool ProximalRiccatiKernel<Scalar, NX, NU, NC>::backwardRhsImpl(
+    boost::span<const KnotType> stages, const Scalar mudyn,
+    boost::span<StageFactorType> datas, value_t &vterm) {
+  ZoneScoped;
+  const std::size_t N = datas.size();
+  if (N == 0)
+    return true;
+
+  std::size_t t = N - 1;
+  stageKernelSolveRhs(stages[t], datas[t], vterm, mudyn);
+  while (t > 0) {
+    --t;
+    stageKernelSolveRhs(stages[t], datas[t], datas[t + 1].vm, mudyn);
+  }
+  return true;
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+bool ProximalRiccatiKernel<Scalar, NX, NU, NC>::forwardImpl(
+    boost::span<const KnotType> stages,
+    boost::span<const StageFactorType> datas, boost::span<VectorXs> xs,
+    boost::span<VectorXs> us, boost::span<VectorXs> vs,
+    boost::span<VectorXs> lbdas) {
+  ZoneScoped;
+  using Eigen::Map;
+  using VectorX = typename StageFactorType::VectorX;
+  using VectorU = typename StageFactorType::VectorU;
+  using VectorC = Eigen::Matrix<Scalar, NC, 1>;
+  enum { NK = StageFactorType::NK };
+
+  const std::size_t N = datas.size();
+  for (std::size_t t = 0; t < N; t++) {
+    const StageFactorType &d = datas[t];
+    assert(xs[t].size() == NX);
+    assert(us[t].size() == NU);
+    assert(vs[t].size() == NC);
+    assert(lbdas[t + 1].size() == NX);
+    assert(xs[t + 1].size() == NX);
+    (void)stages;
+
+    const Map<const VectorX> x(xs[t].data());
+    Map<VectorU>(us[t].data()).noalias() =
+        d.ff.template segment<NU>(0) + d.fb.template middleRows<NU>(0) * x;
+    Map<VectorC>(vs[t].data()).noalias() =
+        d.ff.template segment<NC>(NU) + d.fb.template middleRows<NC>(NU) * x;
+    Map<VectorX>(lbdas[t + 1].data()).noalias() =
+        d.ff.template segment<NX>(NK) + d.fb.template middleRows<NX>(NK) * x;
+    Map<VectorX>(xs[t + 1].data()).noalias() =
+        d.ff.template segment<NX>(NK + NX) +
+        d.fb.template middleRows<NX>(NK + NX) * x;
+  }
+  return true;
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+ProximalRiccatiSolverFixed<Scalar, NX, NU, NC>::ProximalRiccatiSolverFixed(
+    const LQRProblemTpl<Scalar> &problem)
+    : Base(), datas(problem.horizon()),
+      terminal(problem.stages.back().nx, problem.stages.back().nu,
+               problem.stages.back().nc, problem.stages.back().nx2, 0),
+      vterm(), kkt0(NX, problem.nc0(), 0), problem_(&problem) {
+  ZoneScoped;
+  if (!supportsProblem(problem)) {
+    ALIGATOR_RUNTIME_ERROR("Problem dimensions do not match the fixed-size "
+                           "Riccati solver.");
+  }
+  kkt0.mat.setZero();
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+bool ProximalRiccatiSolverFixed<Scalar, NX, NU, NC>::supportsProblem(
+    const LQRProblemTpl<Scalar> &problem) {
+  if (!problem.isInitialized() || problem.horizon() < 1)
+    return false;
+  const auto &knots = problem.stages;
+  const KnotType &term = knots.back();
+  if (term.nx != NX || term.nth != 0)
+    return false;
+  for (std::size_t t = 0; t + 1 < knots.size(); t++) {
+    if (!Impl::matchesKnot(knots[t]))
+      return false;
+  }
+  return true;
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+bool ProximalRiccatiSolverFixed<Scalar, NX, NU, NC>::backward(
+    const Scalar mudyn, const Scalar mueq) {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  const auto &knots = problem_->stages;
+  const std::size_t N = datas.size();
+  DynamicImpl::terminalSolve(knots[N], mueq, terminal);
+  vterm.Pmat = terminal.vm.Pmat;
+  vterm.pvec = terminal.vm.pvec;
+
+  bool ret = Impl::backwardImpl(make_span_from_indices(knots, 0, N), mudyn,
+                                mueq, datas, vterm);
+
+  // initial stage
+  value_t &vinit = datas[0].vm;
+  vinit.Vxx = vinit.Pmat;
+  vinit.vx = vinit.pvec;
+  kkt0.mat(0, 0) = vinit.Vxx;
+  kkt0.mat(1, 0) = problem_->G0;
+  kkt0.mat(0, 1) = problem_->G0.transpose();
+  kkt0.mat(1, 1).diagonal().setConstant(-mudyn);
+  kkt0.chol.compute(kkt0.mat.matrix());
+
+  kkt0.ff.blockSegment(0) = -vinit.vx;
+  kkt0.ff.blockSegment(1) = -problem_->g0;
+  kkt0.chol.solveInPlace(kkt0.ff.matrix());
+  return ret;
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+bool ProximalRiccatiSolverFixed<Scalar, NX, NU, NC>::updateInitialResidual() {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  kkt0.ff.blockSegment(0) = -datas[0].vm.vx;
+  kkt0.ff.blockSegment(1) = -problem_->g0;
+  kkt0.chol.solveInPlace(kkt0.ff.matrix());
+  return true;
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+bool ProximalRiccatiSolverFixed<Scalar, NX, NU, NC>::backwardRhs(
+    const Scalar mudyn, const Scalar mueq) {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  const auto &knots = problem_->stages;
+  const std::size_t N = datas.size();
+  DynamicImpl::terminalSolveRhs(knots[N], mueq, terminal);
+  vterm.pvec = terminal.vm.pvec;
+
+  bool ret = Impl::backwardRhsImpl(make_span_from_indices(knots, 0, N), mudyn,
+                                   datas, vterm);
+  value_t &vinit = datas[0].vm;
+  vinit.vx = vinit.pvec;
+  return ret && updateInitialResidual();
+}
+
+template <typename Scalar, int NX, int NU, int NC>
+bool ProximalRiccatiSolverFixed<Scalar, NX, NU, NC>::forward(
+    std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+    std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
+    const std::optional<ConstVectorRef> &theta_) const {
+  ZoneScoped;
+  if (theta_.has_value() && theta_->size() > 0) {
+    ALIGATOR_RUNTIME_ERROR("The fixed-size Riccati solver does not support "
+                           "parameterized problems.");
+  }
+  DynamicImpl::computeInitial(xs[0], lbdas[0], kkt0, std::nullopt);
+
+  const auto &knots = problem_->stages;
+  const std::size_t N = datas.size();
+  Impl::forwardImpl(make_span_from_indices(knots, 0, N), datas, xs, us, vs,
+                    lbdas);
+  // terminal knot
+  return DynamicImpl::forwardImpl(
+      make_span_from_indices(knots, N, N + 1), boost::make_span(&terminal, 1),
+      make_span_from_indices(xs, N, N + 1), make_span_from_indices(us, N, us.size()),
+      make_span_from_indices(vs, N, N + 1),
+      make_span_from_indices(lbdas, N, N + 1));
+}
+
+template <typename Scalar>
+std::unique_ptr<RiccatiSolverBase<Scalar>>
+createProximalRiccatiSolver(const LQRProblemTpl<Scalar> &problem) {
+  std::unique_ptr<RiccatiSolverBase<Scalar>> out;
+  const auto try_dims = [&](auto dims) {
+    using Dims = decltype(dims);
+    using Solver =
+        ProximalRiccatiSolverFixed<Scalar, Dims::nx, Dims::nu, Dims::nc>;
+    if (!out && Solver::supportsProblem(problem))
+      out = std::make_unique<Solver>(problem);
+  };
+  std::apply([&](auto... dims) { (try_dims(dims), ...); },
+             common_fixed_riccati_dims{});
+  if (!out)
+    out = std::make_unique<ProximalRiccatiSolver<Scalar>>(problem);
+  return out;
+}
+
+} // namespace gar
+} // namespace aligator
@@ -0,0 +1,20 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./fixed-size-riccati.hpp"
+#include "aligator/context.hpp"
+
+namespace aligator {
+namespace gar {
+
+extern template class ProximalRiccatiSolverFixed<context::Scalar, 4, 2, 0>;
+extern template class ProximalRiccatiSolverFixed<context::Scalar, 6, 3, 0>;
+extern template class ProximalRiccatiSolverFixed<context::Scalar, 12, 4, 0>;
+extern template class ProximalRiccatiSolverFixed<context::Scalar, 4, 2, 2>;
+extern template class ProximalRiccatiSolverFixed<context::Scalar, 6, 3, 3>;
+extern template class ProximalRiccatiSolverFixed<context::Scalar, 12, 4, 4>;
+extern template std::unique_ptr<RiccatiSolverBase<context::Scalar>>
+createProximalRiccatiSolver(const LQRProblemTpl<context::Scalar> &);
+
+} // namespace gar
+} // namespace aligator
@@ -3,6 +3,7 @@
 
 #include "aligator/math.hpp"
 
+#include <algorithm>
 #include <optional>
 
 namespace aligator {
@@ -26,64 +27,265 @@ namespace gar {
 ///
 template <typename Scalar> struct LQRKnotTpl {
   ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  static constexpr int Alignment = Eigen::AlignedMax;
+  using MatrixMap = Eigen::Map<MatrixXs, Alignment>;
+  using VectorMap = Eigen::Map<VectorXs, Alignment>;
 
-  uint nx, nu, nc, nx2, nth;
-  MatrixXs Q, S, R;
-  VectorXs q, r;
-  MatrixXs A, B, E;
-  VectorXs f;
-  MatrixXs C, D;
-  VectorXs d;
+  uint nx = 0, nu = 0, nc = 0, nx2 = 0, nth = 0;
+  MatrixMap Q{nullptr, 0, 0}, S{nullptr, 0, 0}, R{nullptr, 0, 0};
+  VectorMap q{nullptr, 0}, r{nullptr, 0};
+  MatrixMap A{nullptr, 0, 0}, B{nullptr, 0, 0}, E{nullptr, 0, 0};
+  VectorMap f{nullptr, 0};
+  MatrixMap C{nullptr, 0, 0}, D{nullptr, 0, 0};
+  VectorMap d{nullptr, 0};
 
-  MatrixXs Gth;
-  MatrixXs Gx;
-  MatrixXs Gu;
-  MatrixXs Gv;
-  VectorXs gamma;
+  MatrixMap Gth{nullptr, 0, 0};
+  MatrixMap Gx{nullptr, 0, 0};
+  MatrixMap Gu{nullptr, 0, 0};
+  MatrixMap Gv{nullptr, 0, 0};
+  VectorMap gamma{nullptr, 0};
+
+  /// @brief Structure of the knot data which the Riccati kernels exploit.
+  /// @details Nothing is assumed by default. The flags are either detected
+  /// from the data by updateStructure(), or set by the owner of the knot when
+  /// it knows the structure of the data (e.g. SolverProxDDPTpl). They must be
+  /// refreshed (or reset) whenever the data changes structure.
+  struct Structure {
+    /// E = -I, as for explicit dynamics on a vector space. The kernels then
+    /// skip the factorization of E.
+    bool E_minus_identity = false;
+    /// Q is diagonal.
+    bool Q_diagonal = false;
+    /// R is diagonal.
+    bool R_diagonal = false;
+    /// Number of leading rows of B which are zero, e.g. when the controls
+    /// only act on the velocity part of the state.
+    uint B_zero_rows = 0;
+  };
+  Structure structure;
 
   LQRKnotTpl() = default;
 
   LQRKnotTpl(uint nx, uint nu, uint nc, uint nx2, uint nth = 0)
-      : nx(nx), nu(nu), nc(nc), nx2(nx2), nth(nth),    //
-        Q(nx, nx), S(nx, nu), R(nu, nu), q(nx), r(nu), //
-        A(nx2, nx), B(nx2, nu), E(nx2, nx), f(nx2),    //
-        C(nc, nx), D(nc, nu), d(nc), Gth(nth, nth), Gx(nx, nth), Gu(nu, nth),
-        Gv(nc, nth), gamma(nth) {
-    Q.setZero();
-    S.setZero();
-    R.setZero();
-    q.setZero();
-    r.setZero();
-
-    A.setZero();
-    B.setZero();
-    E.setZero();
-    f.setZero();
-
-    C.setZero();
-    D.setZero();
-    d.setZero();
-
-    Gth.setZero();
-    Gx.setZero();
-    Gu.setZero();
-    Gv.setZero();
-    gamma.setZero();
+      : nx(nx), nu(nu), nc(nc), nx2(nx2), nth(nth) {
+    allocate();
+    setZero();
   }
 
   LQRKnotTpl(uint nx, uint nu, uint nc) : LQRKnotTpl(nx, nu, nc, nx) {}
 
+  LQRKnotTpl(const LQRKnotTpl &other)
+      : nx(other.nx), nu(other.nu), nc(other.nc), nx2(other.nx2),
+        nth(other.nth) {
+    allocate();
+    copyData(other);
+  }
+
+  /// Moving a knot transfers its storage, which can be owned by the knot or
+  /// by the arena of an LQRProblemTpl.
+  LQRKnotTpl(LQRKnotTpl &&other) noexcept { swap(other); }
+
+  /// Copies the data of @p other. If the dimensions match, the existing
+  /// storage is reused (and the knot stays in its arena, if any).
+  LQRKnotTpl &operator=(const LQRKnotTpl &other) {
+    if (this == &other)
+      return *this;
+    if (sameDims(other)) {
+      copyData(other);
+    } else {
+      LQRKnotTpl tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  LQRKnotTpl &operator=(LQRKnotTpl &&other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~LQRKnotTpl() { deallocate(); }
+
+  void swap(LQRKnotTpl &other) noexcept {
+    std::swap(nx, other.nx);
+    std::swap(nu, other.nu);
+    std::swap(nc, other.nc);
+    std::swap(nx2, other.nx2);
+    std::swap(nth, other.nth);
+    std::swap(memory_, other.memory_);
+    std::swap(owns_memory_, other.owns_memory_);
+    std::swap(structure, other.structure);
+    bindMemory();
+    other.bindMemory();
+  }
+
   // reallocates entire buffer for contigousness
   inline void addParameterization(uint nth) {
-    this->nth = nth;
-    Gth.setZero(nth, nth);
-    Gx.setZero(nx, nth);
-    Gu.setZero(nu, nth);
-    Gv.setZero(nc, nth);
-    gamma.setZero(nth);
+    LQRKnotTpl tmp(nx, nu, nc, nx2, nth);
+    // the parametric blocks come last in the storage: the other blocks have
+    // the same offsets in both knots
+    std::copy_n(memory_, storageSize(nx, nu, nc, nx2, 0), tmp.memory_);
+    tmp.structure = structure;
+    swap(tmp);
+  }
+
+  /// @brief Detect the structure of the knot data (see Structure). Only
+  /// exact zeros and ones are considered.
+  void updateStructure() {
+    structure.E_minus_identity = (nx2 == nx) && E.isDiagonal(Scalar(0)) &&
+                                 (E.diagonal().array() == Scalar(-1)).all();
+    structure.Q_diagonal = Q.isDiagonal(Scalar(0));
+    structure.R_diagonal = R.isDiagonal(Scalar(0));
+    uint k = 0;
+    while (k < nx2 && B.row(k).isZero(Scalar(0)))
+      k++;
+    structure.B_zero_rows = k;
+  }
+
+  /// @brief Copy the data of @p other, which must have the same dimensions,
+  /// converted to this knot's scalar type.
+  template <typename OtherScalar>
+  void castFrom(const LQRKnotTpl<OtherScalar> &other) {
+    assert(nx == other.nx && nu == other.nu && nc == other.nc &&
+           nx2 == other.nx2 && nth == other.nth);
+    Q = other.Q.template cast<Scalar>();
+    S = other.S.template cast<Scalar>();
+    R = other.R.template cast<Scalar>();
+    q = other.q.template cast<Scalar>();
+    r = other.r.template cast<Scalar>();
+    A = other.A.template cast<Scalar>();
+    B = other.B.template cast<Scalar>();
+    E = other.E.template cast<Scalar>();
+    f = other.f.template cast<Scalar>();
+    C = other.C.template cast<Scalar>();
+    D = other.D.template cast<Scalar>();
+    d = other.d.template cast<Scalar>();
+    Gth = other.Gth.template cast<Scalar>();
+    Gx = other.Gx.template cast<Scalar>();
+    Gu = other.Gu.template cast<Scalar>();
+    Gv = other.Gv.template cast<Scalar>();
+    gamma = other.gamma.template cast<Scalar>();
+    structure.E_minus_identity = other.structure.E_minus_identity;
+    structure.Q_diagonal = other.structure.Q_diagonal;
+    structure.R_diagonal = other.structure.R_diagonal;
+    structure.B_zero_rows = other.structure.B_zero_rows;
+  }
+
+  /// @brief Number of scalars used to store a knot with the given dimensions,
+  /// including the padding which aligns every block.
+  static std::size_t storageSize(uint nx, uint nu, uint nc, uint nx2,
+                                 uint nth) {
+    const std::size_t sizes[] = {
+        nx * nx,  nx * nu, nu * nu,  nx,       nu,       nx2 * nx,
+        nx2 * nu, nx2 * nx, nx2,     nc * nx,  nc * nu,  nc,
+        nth * nth, nx * nth, nu * nth, nc * nth, nth};
+    std::size_t total = 0;
+    for (std::size_t n : sizes)
+      total += paddedSize(n);
+    return total;
+  }
+
+  /// Whether the knot data is stored in the arena of an LQRProblemTpl.
+  bool isArenaBacked() const { return memory_ && !owns_memory_; }
+
+private:
+  template <typename> friend struct LQRProblemTpl;
+
+  /// Copy @p other into the external buffer @p memory, which must hold
+  /// storageSize() scalars.
+  LQRKnotTpl(const LQRKnotTpl &other, Scalar *memory)
+      : nx(other.nx), nu(other.nu), nc(other.nc), nx2(other.nx2),
+        nth(other.nth), memory_(memory), owns_memory_(false) {
+    bindMemory();
+    copyData(other);
+  }
+
+  static std::size_t paddedSize(std::size_t n) {
+    constexpr std::size_t align =
+        std::max<std::size_t>(EIGEN_MAX_ALIGN_BYTES / sizeof(Scalar), 1);
+    return (n + align - 1) / align * align;
+  }
+
+  std::size_t storageSize() const {
+    return storageSize(nx, nu, nc, nx2, nth);
+  }
+
+  bool sameDims(const LQRKnotTpl &other) const {
+    return (nx == other.nx) && (nu == other.nu) && (nc == other.nc) &&
+           (nx2 == other.nx2) && (nth == other.nth);
   }
+
+  void allocate() {
+    const std::size_t size = storageSize();
+    memory_ = size > 0 ? static_cast<Scalar *>(Eigen::internal::aligned_malloc(
+                             size * sizeof(Scalar)))
+                       : nullptr;
+    owns_memory_ = memory_ != nullptr;
+    bindMemory();
+  }
+
+  void deallocate() {
+    if (owns_memory_)
+      Eigen::internal::aligned_free(memory_);
+    memory_ = nullptr;
+    owns_memory_ = false;
+  }
+
+  void copyData(const LQRKnotTpl &other) {
+    structure = other.structure;
+    if (other.memory_)
+      std::copy_n(other.memory_, storageSize(), memory_);
+  }
+
+  void setZero() {
+    if (memory_)
+      std::fill_n(memory_, storageSize(), Scalar(0));
+  }
+
+  /// Point the maps to the blocks of the current buffer.
+  void bindMemory() {
+    Scalar *ptr = memory_;
+    auto bind_mat = [&](MatrixMap &map, uint rows, uint cols) {
+      new (&map) MatrixMap(ptr, rows, cols);
+      if (ptr)
+        ptr += paddedSize(rows * cols);
+    };
+    auto bind_vec = [&](VectorMap &map, uint size) {
+      new (&map) VectorMap(ptr, size);
+      if (ptr)
+        ptr += paddedSize(size);
+    };
+    bind_mat(Q, nx, nx);
+    bind_mat(S, nx, nu);
+    bind_mat(R, nu, nu);
+    bind_vec(q, nx);
+    bind_vec(r, nu);
+
+    bind_mat(A, nx2, nx);
+    bind_mat(B, nx2, nu);
+    bind_mat(E, nx2, nx);
+    bind_vec(f, nx2);
+
+    bind_mat(C, nc, nx);
+    bind_mat(D, nc, nu);
+    bind_vec(d, nc);
+
+    bind_mat(Gth, nth, nth);
+    bind_mat(Gx, nx, nth);
+    bind_mat(Gu, nu, nth);
+    bind_mat(Gv, nc, nth);
+    bind_vec(gamma, nth);
+  }
+
+  Scalar *memory_ = nullptr;
+  bool owns_memory_ = false;
 };
 
+/// @brief A constrained LQ problem.
+/// @details The data of all the knots is stored in a single contiguous and
+/// aligned buffer (the arena), which the knots access through `Eigen::Map`
+/// views. Knots which are replaced or re-parameterized afterwards get their
+/// own storage; makeContiguous() moves them back into the arena.
 template <typename Scalar> struct LQRProblemTpl {
   ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
   using KnotType = LQRKnotTpl<Scalar>;
@@ -97,21 +299,49 @@ template <typename Scalar> struct LQRProblemTpl {
 
   LQRProblemTpl() : stages(), G0(), g0() {}
 
-  LQRProblemTpl(KnotVector &&knots, long nc0) : stages(knots), G0(), g0(nc0) {
+  LQRProblemTpl(KnotVector &&knots, long nc0) : LQRProblemTpl(knots, nc0) {}
+
+  /// Copy the knots into the arena of the problem.
+  LQRProblemTpl(const KnotVector &knots, long nc0) : stages(), G0(), g0(nc0) {
+    allocateArena(knots);
     initialize();
   }
 
-  LQRProblemTpl(const KnotVector &knots, long nc0)
-      : stages(knots), G0(), g0(nc0) {
-    initialize();
+  LQRProblemTpl(const LQRProblemTpl &other)
+      : stages(), G0(other.G0), g0(other.g0) {
+    allocateArena(other.stages);
   }
 
+  LQRProblemTpl(LQRProblemTpl &&) = default;
+
+  LQRProblemTpl &operator=(const LQRProblemTpl &other) {
+    if (this != &other) {
+      LQRProblemTpl tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+
+  LQRProblemTpl &operator=(LQRProblemTpl &&) = default;
+
   void addParameterization(uint nth) {
     if (!isInitialized())
       return;
     for (uint i = 0; i <= (uint)horizon(); i++) {
       stages[i].addParameterization(nth);
     }
+    makeContiguous();
+  }
+
+  /// @brief Move the data of all knots to a new arena. Pointers and
+  /// references to the knot data are invalidated.
+  void makeContiguous() { allocateArena(KnotVector(std::move(stages))); }
+
+  /// Whether all the knots live in the arena of the problem.
+  bool isContiguous() const {
+    return std::all_of(stages.begin(), stages.end(), [](const KnotType &k) {
+      return k.isArenaBacked() || k.storageSize() == 0;
+    });
   }
 
   inline bool isParameterized() const {
@@ -132,6 +362,25 @@ protected:
     auto nx0 = stages[0].nx;
     G0.resize(nc0(), nx0);
   }
+
+  void allocateArena(const KnotVector &knots) {
+    std::size_t size = 0;
+    for (const KnotType &knot : knots)
+      size += knot.storageSize();
+    std::vector<Scalar, Eigen::aligned_allocator<Scalar>> arena(size);
+    KnotVector new_stages;
+    new_stages.reserve(knots.size());
+    Scalar *ptr = arena.data();
+    for (const KnotType &knot : knots) {
+      new_stages.push_back(KnotType(knot, ptr));
+      ptr += knot.storageSize();
+    }
+    stages = std::move(new_stages);
+    arena_ = std::move(arena);
+  }
+
+  /// Contiguous storage for the data of all the knots.
+  std::vector<Scalar, Eigen::aligned_allocator<Scalar>> arena_;
 };
 
 template <typename Scalar>
@@ -8,5 +8,7 @@ namespace aligator {
 namespace gar {
 extern template struct LQRKnotTpl<context::Scalar>;
 extern template struct LQRProblemTpl<context::Scalar>;
+extern template struct LQRKnotTpl<float>;
+extern template struct LQRProblemTpl<float>;
 } // namespace gar
 } // namespace aligator
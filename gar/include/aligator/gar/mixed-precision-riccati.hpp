@@ -0,0 +1,90 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "proximal-riccati.hpp"
+#include "utils.hpp"
+
+namespace aligator {
+namespace gar {
+
+/// @brief A proximal Riccati solver which factorizes the LQ problem in a lower
+/// precision (by default, single precision), and recovers the accuracy of the
+/// problem's precision by iterative refinement.
+/// @details The factorization works on a copy of the problem converted to
+/// `LowScalar`, which halves the memory traffic and doubles the width of the
+/// SIMD registers with `float`. forward() then refines the solution: the KKT
+/// residual is computed against the original problem, and the correction is
+/// solved for with the low-precision factorization (see
+/// RiccatiSolverBase::backwardRhs()). This converges as long as the
+/// low-precision factorization is accurate enough for the conditioning of the
+/// problem.
+/// Only the solution and the feedforward gains are refined: the feedback
+/// gains are those of the low-precision factorization, with its accuracy.
+template <typename _Scalar, typename _LowScalar = float>
+class MixedPrecisionRiccatiSolver : public RiccatiSolverBase<_Scalar> {
+public:
+  using Scalar = _Scalar;
+  using LowScalar = _LowScalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS_WITH_ROW_TYPES(Scalar);
+  using Base = RiccatiSolverBase<Scalar>;
+  using KnotType = LQRKnotTpl<Scalar>;
+  using LowKnotType = LQRKnotTpl<LowScalar>;
+  using LowProblemType = LQRProblemTpl<LowScalar>;
+  using LowSolverType = ProximalRiccatiSolver<LowScalar>;
+  using LowVectorXs = typename math_types<LowScalar>::VectorXs;
+
+  explicit MixedPrecisionRiccatiSolver(const LQRProblemTpl<Scalar> &problem);
+
+  bool backward(const Scalar mudyn, const Scalar mueq);
+
+  /// @warning The parameter @p theta is not supported, and ignored.
+  bool forward(std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+               std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
+               const std::optional<ConstVectorRef> &theta = std::nullopt) const;
+
+  /// The feedforward gains include the corrections from the refinement steps
+  /// of the last forward() call.
+  VectorRef getFeedforward(size_t i) { return ffs[i]; }
+  /// @warning The feedback gains are not refined: they are the gains of the
+  /// low-precision factorization, converted to `Scalar`, and are only
+  /// accurate to the precision of `LowScalar`.
+  RowMatrixRef getFeedback(size_t i) { return fbs[i]; }
+
+  /// Max number of refinement steps in forward().
+  uint maxRefinementSteps = 10;
+  /// Target infinity norm of the KKT residual.
+  Scalar refinementThreshold = 1e-10;
+  /// Infinity norm of the KKT residual after the last forward() call.
+  mutable Scalar kktResidual = 0.;
+  /// Number of refinement steps taken by the last forward() call.
+  mutable uint numRefinementSteps = 0;
+
+protected:
+  /// Convert the vectors of the problem, or those of the KKT residual if
+  /// @p residual is true, into the low-precision problem.
+  void setLowRhs(bool residual) const;
+
+  static LowProblemType convertProblem(const LQRProblemTpl<Scalar> &problem);
+
+  const LQRProblemTpl<Scalar> *problem_;
+  mutable LowProblemType lowProblem_;
+  mutable LowSolverType lowSolver_;
+  Scalar mudyn_ = 0.;
+  Scalar mueq_ = 0.;
+  /// Whether the vectors of the low-precision problem hold a residual.
+  mutable bool lowRhsIsResidual_ = false;
+
+  mutable std::vector<VectorXs> ffs;
+  std::vector<RowMatrixXs> fbs;
+  mutable LQRKktResidualTpl<Scalar> residual_;
+  mutable std::vector<LowVectorXs> lxs_, lus_, lvs_, llbdas_;
+};
+
+} // namespace gar
+} // namespace aligator
+
+#include "./mixed-precision-riccati.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "./mixed-precision-riccati.txx"
+#endif
@@ -0,0 +1,133 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./mixed-precision-riccati.hpp"
+
+#include <tracy/Tracy.hpp>
+
+namespace aligator::gar {
+
+template <typename Scalar, typename LowScalar>
+MixedPrecisionRiccatiSolver<Scalar, LowScalar>::MixedPrecisionRiccatiSolver(
+    const LQRProblemTpl<Scalar> &problem)
+    : Base(), problem_(&problem), lowProblem_(convertProblem(problem)),
+      lowSolver_(lowProblem_), residual_(problem) {
+  ZoneScoped;
+  for (const auto &d : lowSolver_.datas) {
+    ffs.emplace_back(d.ff.rows());
+    fbs.emplace_back(d.fb.rows(), d.fb.cols());
+  }
+  std::tie(lxs_, lus_, lvs_, llbdas_) = lqrInitializeSolution(lowProblem_);
+}
+
+template <typename Scalar, typename LowScalar>
+auto MixedPrecisionRiccatiSolver<Scalar, LowScalar>::convertProblem(
+    const LQRProblemTpl<Scalar> &problem) -> LowProblemType {
+  typename LowProblemType::KnotVector knots;
+  knots.reserve(problem.stages.size());
+  for (const KnotType &knot : problem.stages) {
+    knots.emplace_back(knot.nx, knot.nu, knot.nc, knot.nx2, knot.nth);
+    knots.back().castFrom(knot);
+  }
+  LowProblemType out(knots, problem.nc0());
+  out.G0 = problem.G0.template cast<LowScalar>();
+  out.g0 = problem.g0.template cast<LowScalar>();
+  return out;
+}
+
+template <typename Scalar, typename LowScalar>
+void MixedPrecisionRiccatiSolver<Scalar, LowScalar>::setLowRhs(
+    bool residual) const {
+  for (std::size_t t = 0; t < lowProblem_.stages.size(); t++) {
+    LowKnotType &lk = lowProblem_.stages[t];
+    if (residual) {
+      lk.q = residual_.q[t].template cast<LowScalar>();
+      lk.r = residual_.r[t].template cast<LowScalar>();
+      lk.f = residual_.f[t].template cast<LowScalar>();
+      lk.d = residual_.d[t].template cast<LowScalar>();
+    } else {
+      const KnotType &k = problem_->stages[t];
+      lk.q = k.q.template cast<LowScalar>();
+      lk.r = k.r.template cast<LowScalar>();
+      lk.f = k.f.template cast<LowScalar>();
+      lk.d = k.d.template cast<LowScalar>();
+    }
+  }
+  const VectorXs &g0 = residual ? residual_.g0 : problem_->g0;
+  lowProblem_.g0 = g0.template cast<LowScalar>();
+  lowRhsIsResidual_ = residual;
+}
+
+template <typename Scalar, typename LowScalar>
+bool MixedPrecisionRiccatiSolver<Scalar, LowScalar>::backward(
+    const Scalar mudyn, const Scalar mueq) {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  mudyn_ = mudyn;
+  mueq_ = mueq;
+  for (std::size_t t = 0; t < lowProblem_.stages.size(); t++)
+    lowProblem_.stages[t].castFrom(problem_->stages[t]);
+  lowProblem_.G0 = problem_->G0.template cast<LowScalar>();
+  lowProblem_.g0 = problem_->g0.template cast<LowScalar>();
+  lowRhsIsResidual_ = false;
+
+  bool ret = lowSolver_.backward(LowScalar(mudyn), LowScalar(mueq));
+  for (std::size_t i = 0; i < fbs.size(); i++)
+    fbs[i] = lowSolver_.datas[i].fb.matrix().template cast<Scalar>();
+  return ret;
+}
+
+template <typename Scalar, typename LowScalar>
+bool MixedPrecisionRiccatiSolver<Scalar, LowScalar>::forward(
+    std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+    std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
+    const std::optional<ConstVectorRef> &) const {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  const LowScalar lmudyn = LowScalar(mudyn_);
+  const LowScalar lmueq = LowScalar(mueq_);
+  if (lowRhsIsResidual_) {
+    // a previous call left a residual in the low-precision problem
+    setLowRhs(false);
+    lowSolver_.backwardRhs(lmudyn, lmueq);
+  }
+
+  lowSolver_.forward(lxs_, lus_, lvs_, llbdas_);
+  for (std::size_t t = 0; t < xs.size(); t++) {
+    xs[t] = lxs_[t].template cast<Scalar>();
+    vs[t] = lvs_[t].template cast<Scalar>();
+    lbdas[t] = llbdas_[t].template cast<Scalar>();
+  }
+  for (std::size_t t = 0; t < us.size(); t++)
+    us[t] = lus_[t].template cast<Scalar>();
+  for (std::size_t i = 0; i < ffs.size(); i++)
+    ffs[i] = lowSolver_.datas[i].ff.matrix().template cast<Scalar>();
+
+  numRefinementSteps = 0;
+  kktResidual = residual_.compute(*problem_, xs, us, vs, lbdas, mudyn_, mueq_);
+  while (kktResidual > refinementThreshold &&
+         numRefinementSteps < maxRefinementSteps) {
+    ZoneScopedN("refinement_step");
+    // solve for the correction in low precision
+    setLowRhs(true);
+    lowSolver_.backwardRhs(lmudyn, lmueq);
+    lowSolver_.forward(lxs_, lus_, lvs_, llbdas_);
+
+    for (std::size_t t = 0; t < xs.size(); t++) {
+      xs[t] += lxs_[t].template cast<Scalar>();
+      vs[t] += lvs_[t].template cast<Scalar>();
+      lbdas[t] += llbdas_[t].template cast<Scalar>();
+    }
+    for (std::size_t t = 0; t < us.size(); t++)
+      us[t] += lus_[t].template cast<Scalar>();
+    for (std::size_t i = 0; i < ffs.size(); i++)
+      ffs[i] += lowSolver_.datas[i].ff.matrix().template cast<Scalar>();
+
+    numRefinementSteps++;
+    kktResidual =
+        residual_.compute(*problem_, xs, us, vs, lbdas, mudyn_, mueq_);
+  }
+  return true;
+}
+
+} // namespace aligator::gar
@@ -0,0 +1,13 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./mixed-precision-riccati.hpp"
+#include "aligator/context.hpp"
+
+namespace aligator {
+namespace gar {
+
+extern template class MixedPrecisionRiccatiSolver<context::Scalar, float>;
+
+} // namespace gar
+} // namespace aligator
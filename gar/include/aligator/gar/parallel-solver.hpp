@@ -5,6 +5,9 @@
 #include "aligator/gar/fwd.hpp"
 #include "aligator/gar/riccati-base.hpp"
 #include "aligator/gar/riccati-impl.hpp"
+#include "aligator/gar/block-tridiagonal.hpp"
+#include "aligator/gar/work.hpp"
+#include "aligator/threads.hpp"
 
 namespace aligator {
 namespace gar {
@@ -17,8 +20,9 @@ namespace gar {
 /// These splitting variables are used to exploit the problem's
 /// partially-separable structure: each "leg" is then condensed into its value
 /// function with respect to both its initial state and last costate (linking to
-/// the next leg). The saddle-point is cast into a linear system which is solved
-/// by dense LDL factorization.
+/// the next leg). The saddle-point is cast into a block-tridiagonal linear
+/// system, which is solved either by parallel block cyclic reduction or by a
+/// sequential block LDL factorization.
 template <typename _Scalar>
 class ParallelRiccatiSolver : public RiccatiSolverBase<_Scalar> {
 public:
@@ -33,9 +37,18 @@ public:
 
   using BlkMat = BlkMatrix<MatrixXs, -1, -1>;
   using BlkVec = BlkMatrix<VectorXs, -1, 1>;
-
+  using CyclicReduction =
+      BlockTridiagCyclicReduction<MatrixXs, Eigen::BunchKaufman<MatrixXs>>;
+
+  /// @param pool  Optional persistent thread pool to run the legs on. If
+  /// null, an OpenMP parallel region is opened instead.
+  /// @param num_legs  Number of legs the problem is split into. They are
+  /// scheduled dynamically onto the threads, so there can be more (or fewer)
+  /// legs than threads. Zero means one leg per thread.
   explicit ParallelRiccatiSolver(LQRProblemTpl<Scalar> &problem,
-                                 const uint num_threads);
+                                 const uint num_threads,
+                                 ThreadPool *pool = nullptr,
+                                 const uint num_legs = 0);
 
   void allocateLeg(uint start, uint end, bool last_leg);
 
@@ -51,18 +64,13 @@ public:
 
   bool backward(const Scalar mudyn, const Scalar mueq);
 
-  inline void collapseFeedback() {
-    using RowMatrix = Eigen::Matrix<Scalar, -1, -1, Eigen::RowMajor>;
-    StageFactor<Scalar> &d = datas[0];
-    Eigen::Ref<RowMatrix> K = d.fb.blockRow(0);
-    Eigen::Ref<RowMatrix> Kth = d.fth.blockRow(0);
-
-    // condensedSystem.subdiagonal contains the 'U' factors in the
-    // block-tridiag UDUt decomposition
-    // and ∂Xi+1 = -Ui+1.t ∂Xi
-    auto &Up1t = condensedKktSystem.subdiagonal[1];
-    K.noalias() -= Kth * Up1t;
-  }
+  /// @brief Eliminate the dependency of the gains of every leg on its
+  /// parameter (the costate linking it to the next leg).
+  /// @details Afterwards, the gains of each stage form a feedback policy in
+  /// the stage's state only, as they would with a serial Riccati solver, and
+  /// reproduce the last solution computed by forward(). This is what
+  /// nonlinear rollouts need.
+  void collapseFeedback();
 
   struct condensed_system_t {
     std::vector<MatrixXs> subdiagonal;
@@ -86,8 +94,13 @@ public:
   VectorRef getFeedforward(size_t i) { return datas[i].ff.matrix(); }
   RowMatrixRef getFeedback(size_t i) { return datas[i].fb.matrix(); }
 
-  /// Number of parallel divisions in the problem: \f$J+1\f$ in the math.
+  /// Number of threads the legs are run on.
   uint numThreads;
+  /// Number of parallel divisions in the problem: \f$J+1\f$ in the math.
+  uint numLegs;
+  /// Knot ranges of the legs. They are chosen by the constructor to balance
+  /// the estimated cost of the legs (see get_balanced_legs()).
+  std::vector<workrange_t> legs;
 
   /// Hold the compressed representation of the condensed KKT system
   condensed_system_t condensedKktSystem;
@@ -95,12 +108,32 @@ public:
   condensed_system_factor condensedFacs;
   /// Contains the right-hand side and solution of the condensed KKT system.
   BlkVec condensedKktRhs, condensedKktSolution;
+  /// Parallel solver for the condensed KKT system.
+  CyclicReduction condensedCyclicReduction;
+  /// Solve the condensed KKT system by block cyclic reduction on the worker
+  /// threads, rather than sequentially.
+  bool useCyclicReduction = true;
+
+  /// Per-leg buffers for collapseFeedback().
+  struct collapse_buffer_t {
+    MatrixXs S;   //< Schur complement of the leg parameter
+    MatrixXs M;   //< sensitivity of the leg parameter to the state
+    VectorXs th;  //< leg parameter, expressed at the current stage
+    VectorXs x;   //< state along the leg
+    VectorXs xn;  //< next state
+    Eigen::BunchKaufman<MatrixXs> Sfac;
+  };
+  std::vector<collapse_buffer_t> collapseBuffers;
 
   /// @brief Initialize the buffers for the block-tridiagonal system.
   void initializeTridiagSystem(const std::vector<long> &dims);
 
+  /// Set the thread pool used to run the legs (null for OpenMP).
+  void setThreadPool(ThreadPool *pool) { pool_ = pool; }
+
 protected:
   LQRProblemTpl<Scalar> *problem_;
+  ThreadPool *pool_;
 };
 #endif
 
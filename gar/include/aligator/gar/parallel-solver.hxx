@@ -14,25 +14,50 @@ namespace aligator::gar {
 #ifdef ALIGATOR_MULTITHREADING
 template <typename Scalar>
 ParallelRiccatiSolver<Scalar>::ParallelRiccatiSolver(
-    LQRProblemTpl<Scalar> &problem, const uint num_threads)
-    : Base(), numThreads(num_threads), problem_(&problem) {
+    LQRProblemTpl<Scalar> &problem, const uint num_threads, ThreadPool *pool,
+    const uint num_legs)
+    : Base(), numThreads(num_threads),
+      numLegs(num_legs > 0 ? num_legs : num_threads), problem_(&problem),
+      pool_(pool) {
   ZoneScoped;
 
   uint N = (uint)problem.horizon();
-  for (uint i = 0; i < num_threads; i++) {
-    auto [start, end] = get_work(N, i, num_threads);
-    allocateLeg(start, end, i == (num_threads - 1));
+  if (numLegs > N + 1)
+    ALIGATOR_RUNTIME_ERROR(fmt::format(
+        "Number of legs ({:d}) exceeds the number of knots ({:d}).", numLegs,
+        N + 1));
+  // balance the legs according to the dimensions of their knots, once
+  // parameterized
+  legs = get_balanced_legs(problem.stages, numLegs);
+
+  for (uint i = 0; i < numLegs; i++) {
+    auto [start, end] = legs[i];
+    allocateLeg(start, end, i == (numLegs - 1));
   }
+  // parameterizing the knots moved them out of the problem arena
+  problem.makeContiguous();
 
   std::vector<long> dims{problem.nc0(), problem.stages.front().nx};
-  for (uint i = 0; i < num_threads - 1; i++) {
-    auto [i0, i1] = get_work(N, i, num_threads);
+  for (uint i = 0; i < numLegs - 1; i++) {
+    auto [i0, i1] = legs[i];
     dims.push_back(problem.stages[i0].nx);
     dims.push_back(problem.stages[i1 - 1].nx);
   }
   condensedKktRhs = BlkVec(dims);
   condensedKktSolution = condensedKktRhs;
   initializeTridiagSystem(dims);
+  condensedCyclicReduction = CyclicReduction(dims);
+
+  for (uint i = 0; i < numLegs - 1; i++) {
+    const KnotType &kn = problem.stages[legs[i].beg];
+    uint nx_max = 0;
+    for (uint t = legs[i].beg; t < legs[i].end; t++)
+      nx_max = std::max(nx_max, problem.stages[t].nx);
+    collapseBuffers.push_back({MatrixXs(kn.nth, kn.nth),
+                               MatrixXs(kn.nth, nx_max), VectorXs(kn.nth),
+                               VectorXs(nx_max), VectorXs(nx_max),
+                               Eigen::BunchKaufman<MatrixXs>(kn.nth)});
+  }
 
   assert(datas.size() == (N + 1));
 }
@@ -66,17 +91,16 @@ void ParallelRiccatiSolver<Scalar>::assembleCondensedSystem(
   diagonal[1] = datas[0].vm.Pmat;
   superdiagonal[1] = datas[0].vm.Vxt;
 
-  uint N = (uint)problem_->horizon();
   // fill in for all legs
-  for (uint i = 0; i < numThreads - 1; i++) {
-    auto [i0, i1] = get_work(N, i, numThreads);
+  for (uint i = 0; i < numLegs - 1; i++) {
+    auto [i0, i1] = legs[i];
     uint ip1 = i + 1;
     diagonal[2 * ip1] = datas[i0].vm.Vtt;
 
     diagonal[2 * ip1 + 1] = datas[i1].vm.Pmat;
     superdiagonal[2 * ip1] = stages[i1 - 1].E;
 
-    if (ip1 + 1 < numThreads) {
+    if (ip1 + 1 < numLegs) {
       superdiagonal[2 * ip1 + 1] = datas[i1].vm.Vxt;
     }
   }
@@ -89,8 +113,8 @@ void ParallelRiccatiSolver<Scalar>::assembleCondensedSystem(
   condensedKktRhs[0] = -problem_->g0;
   condensedKktRhs[1] = -datas[0].vm.pvec;
 
-  for (uint i = 0; i < numThreads - 1; i++) {
-    auto [i0, i1] = get_work(N, i, numThreads);
+  for (uint i = 0; i < numLegs - 1; i++) {
+    auto [i0, i1] = legs[i];
     uint ip1 = i + 1;
     condensedKktRhs[2 * ip1] = -datas[i0].vm.vt;
     condensedKktRhs[2 * ip1 + 1] = -datas[i1].vm.pvec;
@@ -103,32 +127,38 @@ bool ParallelRiccatiSolver<Scalar>::backward(const Scalar mudyn,
 
   ALIGATOR_NOMALLOC_SCOPED;
   ZoneScopedN("parallel_backward");
-  auto N = static_cast<uint>(problem_->horizon());
-  for (uint i = 0; i < numThreads - 1; i++) {
-    uint end = get_work(N, i, numThreads).end;
+  for (uint i = 0; i < numLegs - 1; i++) {
+    uint end = legs[i].end;
     setupKnot(problem_->stages[end - 1], mudyn);
   }
-  Eigen::setNbThreads(1);
-  aligator::omp::set_default_options(numThreads, false);
-#pragma omp parallel num_threads(numThreads)
-  {
-    uint i = (uint)omp::get_thread_id();
-#ifdef __linux__
-    char *thrdname = new char[16];
-    snprintf(thrdname, 16, "thread%d[c%d]", int(i), sched_getcpu());
-    tracy::SetThreadName(thrdname);
-#endif
-    auto [beg, end] = get_work(N, i, numThreads);
+  // one task per leg
+  parallel_for(pool_, numThreads, numLegs, [&](std::size_t i) {
+    auto [beg, end] = legs[i];
     boost::span<const KnotType> stview =
         make_span_from_indices(problem_->stages, beg, end);
     boost::span<StageFactor<Scalar>> dtview =
         make_span_from_indices(datas, beg, end);
     Impl::backwardImpl(stview, mudyn, mueq, dtview);
-  }
+  });
+
+  assembleCondensedSystem(mudyn);
+  if (useCyclicReduction) {
+    condensedKktSolution = condensedKktRhs;
+    if (!condensedCyclicReduction.factorize(condensedKktSystem.diagonal,
+                                            condensedKktSystem.superdiagonal,
+                                            pool_, numThreads))
+      return false;
+    condensedCyclicReduction.solveInPlace(condensedKktSolution, pool_,
+                                          numThreads);
 
-  {
-    Eigen::setNbThreads(0);
-    assembleCondensedSystem(mudyn);
+    // iterative refinement
+    blockTridiagMatMul(condensedKktSystem.subdiagonal,
+                       condensedKktSystem.diagonal,
+                       condensedKktSystem.superdiagonal, condensedKktSolution,
+                       condensedKktRhs, -1.0);
+    condensedCyclicReduction.solveInPlace(condensedKktRhs, pool_, numThreads);
+    condensedKktSolution.matrix() -= condensedKktRhs.matrix();
+  } else {
     condensedKktSolution = condensedKktRhs;
     condensedFacs.diagonalFacs = condensedKktSystem.diagonal;
     condensedFacs.upFacs = condensedKktSystem.subdiagonal;
@@ -159,39 +189,95 @@ bool ParallelRiccatiSolver<Scalar>::backward(const Scalar mudyn,
   return true;
 }
 
+template <typename Scalar>
+void ParallelRiccatiSolver<Scalar>::collapseFeedback() {
+  ZoneScoped;
+  ALIGATOR_NOMALLOC_SCOPED;
+  const std::vector<MatrixXs> &diagonal = condensedKktSystem.diagonal;
+  std::vector<MatrixXs> &Dhat = condensedFacs.diagonalFacs;
+  if (useCyclicReduction) {
+    // Schur complements of the trailing blocks, as in the up-looking
+    // factorization (which the sequential solve already computed)
+    std::vector<MatrixXs> &Ut = condensedFacs.upFacs;
+    Dhat = diagonal;
+    for (size_t k = diagonal.size() - 1; k > 2; k--) {
+      condensedFacs.ldlt[k].compute(Dhat[k]);
+      Ut[k - 1] = condensedKktSystem.subdiagonal[k - 1];
+      condensedFacs.ldlt[k].solveInPlace(Ut[k - 1]);
+      Dhat[k - 1].noalias() -=
+          condensedKktSystem.superdiagonal[k - 1] * Ut[k - 1];
+    }
+  }
+
+  // the last leg is not parameterized
+  parallel_for(pool_, numThreads, numLegs - 1, [&](std::size_t i) {
+    auto [beg, end] = legs[i];
+    collapse_buffer_t &buf = collapseBuffers[i];
+    const size_t kth = 2 * (i + 1);
+    buf.x.head(problem_->stages[beg].nx) = condensedKktSolution[kth - 1];
+
+    for (uint t = beg; t < end; t++) {
+      StageFactor<Scalar> &d = datas[t];
+      const uint nx = problem_->stages[t].nx;
+      auto x = buf.x.head(nx);
+      auto M = buf.M.leftCols(nx);
+
+      // optimal parameter as a function of the state at stage t:
+      // th = th_sol - M * (x - x_sol)
+      buf.S = d.vm.Vtt - diagonal[kth] + Dhat[kth];
+      buf.Sfac.compute(buf.S);
+      M = d.vm.Vxt.transpose();
+      buf.Sfac.solveInPlace(M);
+      buf.th = condensedKktSolution[kth];
+      buf.th.noalias() += M * x;
+
+      d.ff.matrix().noalias() += d.fth.matrix() * buf.th;
+      d.fb.matrix().noalias() -= d.fth.matrix() * M;
+      d.fth.setZero();
+
+      if (t + 1 < end) {
+        auto xn = buf.xn.head(problem_->stages[t + 1].nx);
+        xn = d.ff[3];
+        xn.noalias() += d.fb.blockRow(3) * x;
+        buf.x.swap(buf.xn);
+      } else {
+        // the next costate is the leg parameter
+        d.ff[2] = buf.th;
+        d.fb.blockRow(2) = -M;
+      }
+    }
+  });
+}
+
 template <typename Scalar>
 bool ParallelRiccatiSolver<Scalar>::forward(
     VectorOfVectors &xs, VectorOfVectors &us, VectorOfVectors &vs,
     VectorOfVectors &lbdas, const std::optional<ConstVectorRef> &) const {
   ALIGATOR_NOMALLOC_SCOPED;
   ZoneScopedN("parallel_forward");
-  uint N = (uint)problem_->horizon();
-  for (uint i = 0; i < numThreads; i++) {
-    uint i0 = get_work(N, i, numThreads).beg;
+  for (uint i = 0; i < numLegs; i++) {
+    uint i0 = legs[i].beg;
     lbdas[i0] = condensedKktSolution[2 * i];
     xs[i0] = condensedKktSolution[2 * i + 1];
   }
-  Eigen::setNbThreads(1);
   const auto &stages = problem_->stages;
 
-#pragma omp parallel num_threads(numThreads)
-  {
-    uint i = (uint)omp::get_thread_id();
-    auto [beg, end] = get_work(N, i, numThreads);
+  parallel_for(pool_, numThreads, numLegs, [&](std::size_t j) {
+    uint i = uint(j);
+    auto [beg, end] = legs[i];
     auto xsview = make_span_from_indices(xs, beg, end);
     auto usview = make_span_from_indices(us, beg, end);
     auto vsview = make_span_from_indices(vs, beg, end);
     auto lsview = make_span_from_indices(lbdas, beg, end);
     auto stview = make_span_from_indices(stages, beg, end);
     auto dsview = make_span_from_indices(datas, beg, end);
-    if (i < numThreads - 1) {
+    if (i < numLegs - 1) {
       Impl::forwardImpl(stview, dsview, xsview, usview, vsview, lsview,
                         lbdas[end]);
     } else {
       Impl::forwardImpl(stview, dsview, xsview, usview, vsview, lsview);
     }
-  }
-  Eigen::setNbThreads(0);
+  });
   return true;
 }
 
@@ -212,7 +298,6 @@ void ParallelRiccatiSolver<Scalar>::initializeTridiagSystem(
 
   const auto emplace_factor = [](condensed_system_factor &f, Eigen::Index dim) {
     f.diagonalFacs.emplace_back(dim, dim);
-    f.upFacs.emplace_back(dim, dim);
     f.ldlt.emplace_back(dim);
   };
 
@@ -223,6 +308,7 @@ void ParallelRiccatiSolver<Scalar>::initializeTridiagSystem(
     condensedKktSystem.superdiagonal.emplace_back(dims[i], dims[i + 1]);
     condensedKktSystem.diagonal.emplace_back(dims[i + 1], dims[i + 1]);
     condensedKktSystem.subdiagonal.emplace_back(dims[i + 1], dims[i]);
+    condensedFacs.upFacs.emplace_back(dims[i + 1], dims[i]);
     emplace_factor(condensedFacs, dims[i + 1]);
   }
 }
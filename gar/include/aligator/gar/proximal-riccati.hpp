@@ -35,6 +35,15 @@ public:
   VectorRef getFeedforward(size_t i) { return datas[i].ff.matrix(); }
   RowMatrixRef getFeedback(size_t i) { return datas[i].fb.matrix(); }
 
+  bool cycleLeft() {
+    rotate_vec_left(datas, 0, 1);
+    return true;
+  }
+
+  bool updateInitialResidual();
+
+  bool backwardRhs(const Scalar mudyn, const Scalar mueq);
+
   kkt0_t kkt0;     //< initial stage KKT system
   VectorXs thGrad; //< optimal value gradient wrt parameter
   MatrixXs thHess; //< optimal value Hessian wrt parameter
@@ -60,6 +60,30 @@ bool ProximalRiccatiSolver<Scalar>::backward(const Scalar mudyn,
   return ret;
 }
 
+template <typename Scalar>
+bool ProximalRiccatiSolver<Scalar>::updateInitialResidual() {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  const value_t &vinit = datas[0].vm;
+  kkt0.ff.blockSegment(0) = -vinit.vx;
+  kkt0.ff.blockSegment(1) = -problem_->g0;
+  kkt0.chol.solveInPlace(kkt0.ff.matrix());
+  thGrad.noalias() =
+      vinit.vt + vinit.Vxt.transpose() * kkt0.ff.blockSegment(0);
+  return true;
+}
+
+template <typename Scalar>
+bool ProximalRiccatiSolver<Scalar>::backwardRhs(const Scalar mudyn,
+                                                const Scalar mueq) {
+  ALIGATOR_NOMALLOC_SCOPED;
+  ZoneScoped;
+  bool ret = Impl::backwardRhsImpl(problem_->stages, mudyn, mueq, datas);
+  value_t &vinit = datas[0].vm;
+  vinit.vx = vinit.pvec;
+  return ret && updateInitialResidual();
+}
+
 template <typename Scalar>
 bool ProximalRiccatiSolver<Scalar>::forward(
     std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
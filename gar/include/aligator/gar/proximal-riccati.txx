@@ -8,6 +8,7 @@ namespace aligator {
 namespace gar {
 
 extern template class ProximalRiccatiSolver<context::Scalar>;
+extern template class ProximalRiccatiSolver<float>;
 
 } // namespace gar
 } // namespace aligator
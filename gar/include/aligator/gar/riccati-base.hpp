@@ -3,6 +3,7 @@
 #pragma once
 
 #include "aligator/math.hpp"
+#include "aligator/utils/mpc-util.hpp"
 
 #include <optional>
 
@@ -21,12 +22,41 @@ public:
           std::vector<VectorXs> &vs, std::vector<VectorXs> &lbdas,
           const std::optional<ConstVectorRef> &theta_ = std::nullopt) const = 0;
 
-  /// For applicable solvers, updates the first feedback gain in-place to
-  /// correspond to the first Riccati gain.
+  /// For applicable solvers, updates the feedback gains in-place to
+  /// correspond to the Riccati gains of the full problem. Must be called
+  /// after forward().
   virtual void collapseFeedback() {}
   virtual VectorRef getFeedforward(size_t) = 0;
   virtual RowMatrixRef getFeedback(size_t) = 0;
 
+  /// @brief Rotate the stagewise buffers of the solver to the left (keeping
+  /// the terminal stage in place), to follow the same rotation of the knots
+  /// of the LQ problem. Used in receding-horizon applications.
+  /// @returns Whether the solver supports this operation.
+  virtual bool cycleLeft() { return false; }
+
+  /// @brief Recompute the solution of the initial stage after a change of the
+  /// initial constraint residual \f$g_0\f$ in the problem, reusing the
+  /// factorization from the last backward() call.
+  /// @details The solution of the LQ problem is affine in \f$g_0\f$, so a
+  /// forward() call afterwards returns the exact solution for the new
+  /// residual. This is much cheaper than a new backward pass, and is what the
+  /// feedback phase of real-time iteration schemes needs.
+  /// @returns Whether the solver supports this operation.
+  virtual bool updateInitialResidual() { return false; }
+
+  /// @brief Recompute the feedforward gains after a change of the vectors
+  /// \f$(q, r, f, d, g_0, \gamma)\f$ of the problem, reusing the
+  /// factorization from the last backward() call, which must have been made
+  /// with the same @p mudyn and @p mueq.
+  /// @details This is what iterative refinement of the solution needs.
+  /// @returns Whether the solver supports this operation.
+  virtual bool backwardRhs(const Scalar mudyn, const Scalar mueq) {
+    (void)mudyn;
+    (void)mueq;
+    return false;
+  }
+
   virtual ~RiccatiSolverBase() = default;
 };
 
@@ -6,5 +6,6 @@
 
 namespace aligator::gar {
 extern template class RiccatiSolverBase<context::Scalar>;
+extern template class RiccatiSolverBase<float>;
 
 }
@@ -30,8 +30,24 @@ inline boost::span<const T> make_span_from_indices(const std::vector<T, A> &vec,
   return boost::make_span(vec.data() + i0, i1 - i0);
 }
 
+/// @brief Per-node struct for all computations in the factorization.
+/// @details The default template arguments select dynamic-size storage.
+/// Variants with compile-time state, control and constraint dimensions are
+/// defined in fixed-size-riccati.hpp.
+template <typename Scalar, int NX = Eigen::Dynamic, int NU = Eigen::Dynamic,
+          int NC = Eigen::Dynamic>
+struct StageFactor;
+
+/// @brief Kernel for use in Riccati-like algorithms for the proximal LQ
+/// subproblem.
+/// @copydetails StageFactor
+template <typename Scalar, int NX = Eigen::Dynamic, int NU = Eigen::Dynamic,
+          int NC = Eigen::Dynamic>
+struct ProximalRiccatiKernel;
+
 /// Per-node struct for all computations in the factorization.
-template <typename _Scalar> struct StageFactor {
+template <typename _Scalar>
+struct StageFactor<_Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::Dynamic> {
   using Scalar = _Scalar;
   ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
   using RowMatrixXs = Eigen::Matrix<Scalar, -1, -1, Eigen::RowMajor>;
@@ -119,7 +135,9 @@ template <typename _Scalar> struct StageFactor {
 
 /// @brief Kernel for use in Riccati-like algorithms for the proximal LQ
 /// subproblem.
-template <typename Scalar> struct ProximalRiccatiKernel {
+template <typename Scalar>
+struct ProximalRiccatiKernel<Scalar, Eigen::Dynamic, Eigen::Dynamic,
+                             Eigen::Dynamic> {
   ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
   using RowMatrixXs = Eigen::Matrix<Scalar, -1, -1, Eigen::RowMajor>;
   using RowMatrixRef = Eigen::Ref<RowMatrixXs>;
@@ -145,6 +163,20 @@ template <typename Scalar> struct ProximalRiccatiKernel {
                                   const Scalar mudyn, const Scalar mueq,
                                   boost::span<StageFactorType> datas);
 
+  /// @brief Backward sweep for the vectors of the problem only, reusing the
+  /// factorizations and gains from the last backwardImpl() call (with the same
+  /// @p mudyn and @p mueq).
+  inline static bool backwardRhsImpl(boost::span<const KnotType> stages,
+                                     const Scalar mudyn, const Scalar mueq,
+                                     boost::span<StageFactorType> datas);
+
+  inline static void terminalSolveRhs(const KnotType &model, const Scalar mueq,
+                                      StageFactorType &d);
+
+  inline static void stageKernelSolveRhs(const KnotType &model,
+                                         StageFactorType &d, value_t &vn,
+                                         const Scalar mudyn);
+
   /// Solve initial stage
   inline static void
   computeInitial(VectorRef x0, VectorRef lbd0, const kkt0_t &kkt0,
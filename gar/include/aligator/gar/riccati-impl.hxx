@@ -48,7 +48,7 @@ void ProximalRiccatiKernel<Scalar>::terminalSolve(const KnotType &model,
   RowMatrixRef Kth = d.fth.blockRow(0);
   RowMatrixRef Zth = d.fth.blockRow(1);
 
-  Eigen::Transpose<const MatrixXs> Ct = model.C.transpose();
+  auto Ct = model.C.transpose();
 
   if (model.nu == 0) {
     Z = model.C / mueq;
@@ -79,7 +79,12 @@ void ProximalRiccatiKernel<Scalar>::terminalSolve(const KnotType &model,
     }
   }
 
-  vc.Pmat.noalias() = model.Q + Ct * Z;
+  if (model.structure.Q_diagonal) {
+    vc.Pmat.noalias() = Ct * Z;
+    vc.Pmat.diagonal() += model.Q.diagonal();
+  } else {
+    vc.Pmat.noalias() = model.Q + Ct * Z;
+  }
   vc.pvec.noalias() = model.q + Ct * zff;
 
   if (model.nu > 0) {
@@ -97,6 +102,103 @@ void ProximalRiccatiKernel<Scalar>::terminalSolve(const KnotType &model,
   }
 }
 
+template <typename Scalar>
+bool ProximalRiccatiKernel<Scalar>::backwardRhsImpl(
+    boost::span<const KnotType> stages, const Scalar mudyn, const Scalar mueq,
+    boost::span<StageFactorType> datas) {
+  ZoneScoped;
+  if (datas.size() == 0)
+    return true;
+  uint N = (uint)(datas.size() - 1);
+  terminalSolveRhs(stages[N], mueq, datas[N]);
+
+  for (uint t = N; t > 0; t--) {
+    stageKernelSolveRhs(stages[t - 1], datas[t - 1], datas[t].vm, mudyn);
+  }
+  return true;
+}
+
+template <typename Scalar>
+void ProximalRiccatiKernel<Scalar>::terminalSolveRhs(const KnotType &model,
+                                                     const Scalar mueq,
+                                                     StageFactorType &d) {
+  ZoneScoped;
+  value_t &vc = d.vm;
+  VectorRef kff = d.ff.blockSegment(0);
+  VectorRef zff = d.ff.blockSegment(1);
+
+  if (model.nu == 0) {
+    zff = model.d / mueq;
+  } else {
+    kff = -model.r;
+    zff = -model.d;
+    auto ffview = d.ff.template topBlkRows<2>();
+    d.kktChol.solveInPlace(ffview.matrix());
+  }
+
+  vc.pvec.noalias() = model.q + model.C.transpose() * zff;
+  if (model.nu > 0)
+    vc.pvec.noalias() += model.S * kff;
+
+  if (model.nth > 0) {
+    vc.vt = model.gamma;
+    vc.vt.noalias() += model.Gu.transpose() * kff;
+  }
+}
+
+template <typename Scalar>
+void ProximalRiccatiKernel<Scalar>::stageKernelSolveRhs(const KnotType &model,
+                                                        StageFactorType &d,
+                                                        value_t &vn,
+                                                        const Scalar mudyn) {
+  ZoneScoped;
+  const typename KnotType::Structure &st = model.structure;
+  const uint nb = model.nx2 - st.B_zero_rows;
+  const auto Bb = model.B.bottomRows(nb);
+
+  auto &ptilde = vn.vx; // just an alias
+  if (st.E_minus_identity) {
+    ptilde = vn.pvec;
+  } else {
+    ptilde.noalias() = d.Einv.transpose() * vn.pvec;
+    ptilde *= -1;
+  }
+  vn.vx.noalias() += d.Ptilde * model.f;
+  d.schurChol.solveInPlace(vn.vx);
+
+  d.qhat.noalias() = model.q + model.A.transpose() * vn.vx;
+  d.rhat.noalias() = model.r + Bb.transpose() * vn.vx.tail(nb);
+
+  VectorRef kff = d.ff.blockSegment(0);
+  VectorRef zff = d.ff.blockSegment(1);
+  VectorRef lff = d.ff.blockSegment(2);
+  VectorRef yff = d.ff.blockSegment(3);
+  kff = -d.rhat;
+  zff = -model.d;
+  auto ffview = d.ff.template topBlkRows<2>();
+  d.kktChol.solveInPlace(ffview.matrix());
+
+  lff.noalias() = vn.vx + d.BtV.transpose() * kff;
+  yff = model.f;
+  yff.tail(nb).noalias() += Bb * kff;
+  yff -= mudyn * lff;
+  if (!st.E_minus_identity) {
+    d.yff_pre = yff;
+    yff.noalias() = d.Einv * d.yff_pre;
+    yff *= -1;
+  }
+
+  value_t &vc = d.vm;
+  vc.pvec.noalias() = d.qhat + d.Shat * kff;
+  vc.pvec.noalias() += model.C.transpose() * zff;
+
+  if (model.nth > 0) {
+    vc.vt = vn.vt + model.gamma;
+    vc.vt.noalias() += model.Gu.transpose() * kff;
+    vc.vt.noalias() += vn.Vxt.transpose() * yff;
+  }
+}
+
 template <typename Scalar>
 void ProximalRiccatiKernel<Scalar>::computeInitial(
     VectorRef x0, VectorRef lbd0, const kkt0_t &kkt0,
@@ -118,15 +220,26 @@ void ProximalRiccatiKernel<Scalar>::stageKernelSolve(const KnotType &model,
                                                      const Scalar mudyn,
                                                      const Scalar mueq) {
   ZoneScoped;
+  const typename KnotType::Structure &st = model.structure;
+  // only the bottom rows of B can be nonzero
+  const uint nb = model.nx2 - st.B_zero_rows;
+  const auto Bb = model.B.bottomRows(nb);
+
   // step 1. compute decomposition of the E matrix
-  d.Efact.compute(model.E);
-  d.EinvP.setIdentity();
-  d.Einv = d.Efact.solve(d.EinvP);
   auto &ptilde = vn.vx; // just an alias
-  ptilde.noalias() = d.Einv.transpose() * vn.pvec;
-  ptilde *= -1;
-  d.EinvP.noalias() = d.Einv.transpose() * vn.Pmat;
-  d.Ptilde.noalias() = d.EinvP * d.Einv;
+  if (st.E_minus_identity) {
+    // Einv = -I
+    ptilde = vn.pvec;
+    d.Ptilde = vn.Pmat;
+  } else {
+    d.Efact.compute(model.E);
+    d.EinvP.setIdentity();
+    d.Einv = d.Efact.solve(d.EinvP);
+    ptilde.noalias() = d.Einv.transpose() * vn.pvec;
+    ptilde *= -1;
+    d.EinvP.noalias() = d.Einv.transpose() * vn.Pmat;
+    d.Ptilde.noalias() = d.EinvP * d.Einv;
+  }
   d.Ptilde = d.Ptilde.template selfadjointView<Eigen::Lower>();
 
   d.schurMat.setIdentity();
@@ -140,13 +253,23 @@ void ProximalRiccatiKernel<Scalar>::stageKernelSolve(const KnotType &model,
   vn.Vxx = vn.Vxx.template selfadjointView<Eigen::Lower>();
 
   d.AtV.noalias() = model.A.transpose() * vn.Vxx;
-  d.BtV.noalias() = model.B.transpose() * vn.Vxx;
+  d.BtV.noalias() = Bb.transpose() * vn.Vxx.bottomRows(nb);
 
-  d.Qhat.noalias() = model.Q + d.AtV * model.A;
-  d.Rhat.noalias() = model.R + d.BtV * model.B;
-  d.Shat.noalias() = model.S + d.AtV * model.B;
+  if (st.Q_diagonal) {
+    d.Qhat.noalias() = d.AtV * model.A;
+    d.Qhat.diagonal() += model.Q.diagonal();
+  } else {
+    d.Qhat.noalias() = model.Q + d.AtV * model.A;
+  }
+  if (st.R_diagonal) {
+    d.Rhat.noalias() = d.BtV.rightCols(nb) * Bb;
+    d.Rhat.diagonal() += model.R.diagonal();
+  } else {
+    d.Rhat.noalias() = model.R + d.BtV.rightCols(nb) * Bb;
+  }
+  d.Shat.noalias() = model.S + d.AtV.rightCols(nb) * Bb;
   d.qhat.noalias() = model.q + model.A.transpose() * vn.vx;
-  d.rhat.noalias() = model.r + model.B.transpose() * vn.vx;
+  d.rhat.noalias() = model.r + Bb.transpose() * vn.vx.tail(nb);
 
   // factorize reduced KKT system
   d.kktMat(0, 0) = d.Rhat;
@@ -179,20 +302,26 @@ void ProximalRiccatiKernel<Scalar>::stageKernelSolve(const KnotType &model,
 
   // set closed loop dynamics
   lff.noalias() = vn.vx + d.BtV.transpose() * kff;
-  yff.noalias() = model.f + model.B * kff;
+  yff = model.f;
+  yff.tail(nb).noalias() += Bb * kff;
   yff -= mudyn * lff;
-  d.yff_pre = yff;
-  yff.noalias() = d.Einv * d.yff_pre;
-  yff *= -1;
+  if (!st.E_minus_identity) {
+    d.yff_pre = yff;
+    yff.noalias() = d.Einv * d.yff_pre;
+    yff *= -1;
+  }
 
   L.noalias() = vn.Vxx * model.A;
   L.noalias() += d.BtV.transpose() * K;
 
-  A.noalias() = model.A + model.B * K;
+  A = model.A;
+  A.bottomRows(nb).noalias() += Bb * K;
   A -= mudyn * L;
-  d.A_pre = A;
-  A.noalias() = d.Einv * d.A_pre;
-  A *= -1;
+  if (!st.E_minus_identity) {
+    d.A_pre = A;
+    A.noalias() = d.Einv * d.A_pre;
+    A *= -1;
+  }
 
   value_t &vc = d.vm;
   Eigen::Transpose Ct = model.C.transpose();
@@ -208,14 +337,18 @@ void ProximalRiccatiKernel<Scalar>::stageKernelSolve(const KnotType &model,
 
     // store Pxttilde = -Einv * Pxt
     // this is like ptilde
-    Lth.noalias() = d.Einv.transpose() * vn.Vxt;
-    Lth *= -1;
+    if (st.E_minus_identity) {
+      Lth = vn.Vxt;
+    } else {
+      Lth.noalias() = d.Einv.transpose() * vn.Vxt;
+      Lth *= -1;
+    }
     auto &Pxttilde = Lth; // just an alias for clarity
     // store Lambda.inv * Pxttilde
     d.schurChol.solveInPlace(Lth);
 
     // d.Gxhat.noalias() = model.Gx + model.A.transpose() * Pxttilde;
-    d.Guhat.noalias() = model.Gu + model.B.transpose() * Pxttilde;
+    d.Guhat.noalias() = model.Gu + Bb.transpose() * Pxttilde.bottomRows(nb);
 
     // set rhs of 2x2 block system and solve
     Kth = -d.Guhat;
@@ -226,11 +359,14 @@ void ProximalRiccatiKernel<Scalar>::stageKernelSolve(const KnotType &model,
     // substitute into Xith, Ath gains
     Lth.noalias() += d.BtV.transpose() * Kth;
 
-    Yth.noalias() = model.B * Kth;
+    Yth.topRows(st.B_zero_rows).setZero();
+    Yth.bottomRows(nb).noalias() = Bb * Kth;
     Yth -= mudyn * Lth;
-    d.Yth_pre = Yth;
-    Yth.noalias() = d.Einv * d.Yth_pre;
-    Yth *= -1;
+    if (!st.E_minus_identity) {
+      d.Yth_pre = Yth;
+      Yth.noalias() = d.Einv * d.Yth_pre;
+      Yth *= -1;
+    }
 
     // update vt, Vxt, Vtt
     vc.vt = vn.vt + model.gamma;
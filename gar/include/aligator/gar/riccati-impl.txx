@@ -8,5 +8,7 @@ namespace aligator {
 namespace gar {
 extern template struct StageFactor<context::Scalar>;
 extern template struct ProximalRiccatiKernel<context::Scalar>;
+extern template struct StageFactor<float>;
+extern template struct ProximalRiccatiKernel<float>;
 } // namespace gar
 } // namespace aligator
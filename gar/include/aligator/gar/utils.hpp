@@ -2,6 +2,9 @@
 #pragma once
 
 #include "lqr-problem.hpp"
+#include "blk-matrix.hpp"
+#include "aligator/threads.hpp"
+#include "aligator/utils/mpc-util.hpp"
 #include "aligator/third-party/boost/core/span.hpp"
 
 namespace aligator {
@@ -105,6 +108,119 @@ auto lqrComputeKktError(
   return std::array{dynErr, cstErr, dualErr};
 }
 
+/// @brief Residuals of the KKT conditions of a LQ problem at a primal-dual
+/// point, stored in the layout of the vectors of the problem.
+/// @details Solving the LQ problem with its vectors \f$(q, r, f, d, g_0)\f$
+/// replaced by the residuals (see swapVectors()) yields the Newton correction
+/// of the point, which is how a solution is refined iteratively. The
+/// parametric part of the problem, if any, is not considered.
+template <typename Scalar> struct LQRKktResidualTpl {
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using KnotType = LQRKnotTpl<Scalar>;
+
+  std::vector<VectorXs> q; //< stationarity wrt the states
+  std::vector<VectorXs> r; //< stationarity wrt the controls
+  std::vector<VectorXs> f; //< dynamics
+  std::vector<VectorXs> d; //< path constraints
+  VectorXs g0;             //< initial constraint
+  /// Infinity norm of the residuals of each knot (including g0 for the first)
+  VectorXs knotNorms;
+
+  LQRKktResidualTpl() = default;
+
+  explicit LQRKktResidualTpl(const LQRProblemTpl<Scalar> &problem)
+      : g0(problem.nc0()), knotNorms(problem.horizon() + 1) {
+    for (const KnotType &knot : problem.stages) {
+      q.emplace_back(knot.nx);
+      r.emplace_back(knot.nu);
+      f.emplace_back(knot.nx2);
+      d.emplace_back(knot.nc);
+    }
+  }
+
+  /// @brief Compute the residuals at the point \f$(x, u, v, \lambda)\f$, in
+  /// parallel over the knots. Does not allocate, unlike lqrComputeKktError().
+  /// @param pool  Optional thread pool (see parallel_for()).
+  /// @returns The infinity norm of the residuals.
+  Scalar compute(const LQRProblemTpl<Scalar> &problem,
+                 const std::vector<VectorXs> &xs,
+                 const std::vector<VectorXs> &us,
+                 const std::vector<VectorXs> &vs,
+                 const std::vector<VectorXs> &lbdas, const Scalar mudyn,
+                 const Scalar mueq, ThreadPool *pool = nullptr,
+                 std::size_t num_threads = 1) {
+    ALIGATOR_NOMALLOC_SCOPED;
+    const std::size_t N = std::size_t(problem.horizon());
+    parallel_for(pool, num_threads, N + 1, [&](std::size_t t) {
+      const KnotType &knot = problem.stages[t];
+      d[t] = knot.d;
+      d[t].noalias() += knot.C * xs[t];
+      d[t] -= mueq * vs[t];
+      q[t] = knot.q;
+      q[t].noalias() += knot.Q * xs[t];
+      q[t].noalias() += knot.C.transpose() * vs[t];
+      r[t] = knot.r;
+      r[t].noalias() += knot.S.transpose() * xs[t];
+      r[t].noalias() += knot.D.transpose() * vs[t];
+      if (knot.nu > 0) {
+        d[t].noalias() += knot.D * us[t];
+        q[t].noalias() += knot.S * us[t];
+        r[t].noalias() += knot.R * us[t];
+      }
+
+      if (t == 0)
+        q[t].noalias() += problem.G0.transpose() * lbdas[0];
+      else
+        q[t].noalias() += problem.stages[t - 1].E.transpose() * lbdas[t];
+
+      Scalar norm = 0.;
+      if (t < N) {
+        f[t] = knot.f;
+        f[t].noalias() += knot.A * xs[t];
+        f[t].noalias() += knot.B * us[t];
+        f[t].noalias() += knot.E * xs[t + 1];
+        f[t] -= mudyn * lbdas[t + 1];
+        q[t].noalias() += knot.A.transpose() * lbdas[t + 1];
+        r[t].noalias() += knot.B.transpose() * lbdas[t + 1];
+        norm = math::infty_norm(f[t]);
+      } else {
+        f[t].setZero();
+      }
+      if (t == 0) {
+        g0 = problem.g0;
+        g0.noalias() += problem.G0 * xs[0];
+        g0 -= mudyn * lbdas[0];
+        norm = std::max(norm, math::infty_norm(g0));
+      }
+      knotNorms[t] = std::max({norm, math::infty_norm(q[t]),
+                               math::infty_norm(r[t]), math::infty_norm(d[t])});
+    });
+    return math::infty_norm(knotNorms);
+  }
+
+  /// Swap the residuals with the vectors of @p problem. Calling it twice
+  /// restores the problem.
+  void swapVectors(LQRProblemTpl<Scalar> &problem) {
+    for (std::size_t t = 0; t < problem.stages.size(); t++) {
+      KnotType &knot = problem.stages[t];
+      knot.q.swap(q[t]);
+      knot.r.swap(r[t]);
+      knot.f.swap(f[t]);
+      knot.d.swap(d[t]);
+    }
+    problem.g0.swap(g0);
+  }
+
+  /// Rotate the residuals to the left, following the knots of the problem
+  /// (see RiccatiSolverBase::cycleLeft()).
+  void cycleLeft() {
+    rotate_vec_left(q, 0, 1);
+    rotate_vec_left(r, 0, 1);
+    rotate_vec_left(f, 0, 1);
+    rotate_vec_left(d, 0, 1);
+  }
+};
+
 /// @brief Fill in a KKT constraint matrix and vector for the given LQ problem
 /// with the given dual-regularization parameters @p mudyn and @p mueq.
 /// @returns Whether the matrices were successfully allocated.
@@ -216,6 +332,93 @@ auto lqrDenseMatrix(const LQRProblemTpl<Scalar> &problem, Scalar mudyn,
   return std::make_pair(mat, rhs);
 }
 
+/// @brief Assemble the KKT matrix and right-hand side of the LQ problem, in
+/// the layout of lqrDenseMatrix().
+/// @details Each structurally nonzero coefficient `(i, j)` of the matrix is
+/// passed to `assign(i, j, value)`, always in the same order for problems with
+/// the same dimensions.
+template <typename Scalar, typename Assign>
+void lqrAssembleSparseMatrix(const LQRProblemTpl<Scalar> &problem,
+                             const Scalar mudyn, const Scalar mueq,
+                             Eigen::Matrix<Scalar, -1, 1> &rhs,
+                             Assign &&assign) {
+  using Eigen::Index;
+  using knot_t = LQRKnotTpl<Scalar>;
+  const auto &knots = problem.stages;
+  auto assignBlock = [&](Index i0, Index j0, const auto &input) {
+    for (Index i = 0; i < input.rows(); i++)
+      for (Index j = 0; j < input.cols(); j++)
+        assign(i0 + i, j0 + j, input(i, j));
+  };
+  auto assignDiagonal = [&](Index i0, Index i1, Scalar value) {
+    for (Index kk = i0; kk < i1; kk++)
+      assign(kk, kk, value);
+  };
+
+  rhs.setZero();
+  const size_t N = size_t(problem.horizon());
+  uint idx = 0;
+  {
+    uint nc0 = problem.nc0();
+    rhs.head(nc0) = problem.g0;
+    assignBlock(0, nc0, problem.G0);
+    assignBlock(nc0, 0, problem.G0.transpose());
+    assignDiagonal(0, nc0, -mudyn);
+    idx += nc0;
+  }
+
+  for (size_t t = 0; t <= N; t++) {
+    const knot_t &model = knots[t];
+    const uint n = model.nx + model.nu + model.nc;
+    // get block for current variables
+    auto rhsblk = rhs.segment(idx, n);
+
+    rhsblk.head(model.nx) = model.q;
+    rhsblk.segment(model.nx, model.nu) = model.r;
+    rhsblk.tail(model.nc) = model.d;
+
+    // fill-in Q block
+    assignBlock(idx, idx, model.Q);
+    const Index i0 = idx + model.nx; // u
+    // S block
+    assignBlock(i0, idx, model.S.transpose());
+    assignBlock(idx, i0, model.S);
+    // R block
+    assignBlock(i0, i0, model.R);
+
+    const Index i1 = i0 + model.nu; // v
+    // C block
+    assignBlock(i1, idx, model.C);
+    assignBlock(idx, i1, model.C.transpose());
+    // D block
+    assignBlock(i1, i0, model.D);
+    assignBlock(i0, i1, model.D.transpose());
+
+    const Index i2 = i1 + model.nc;
+    // dual block
+    assignDiagonal(i1, i2, -mueq);
+
+    if (t != N) {
+      rhs.segment(idx + n, model.nx2) = model.f;
+
+      // A
+      assignBlock(i2, idx, model.A);
+      assignBlock(idx, i2, model.A.transpose());
+      // B
+      assignBlock(i2, i0, model.B);
+      assignBlock(i0, i2, model.B.transpose());
+      // E
+      const Index i3 = i2 + model.nx2;
+      assignBlock(i2, i3, model.E);
+      assignBlock(i3, i2, model.E.transpose());
+
+      assignDiagonal(i2, i3, -mudyn);
+
+      idx += n + model.nx2;
+    }
+  }
+}
+
 /// @brief Convert dense RHS solution to its trajectory [x,u,v,lambda] solution.
 template <typename Scalar>
 void lqrDenseSolutionToTraj(
@@ -250,6 +453,44 @@ void lqrDenseSolutionToTraj(
   }
 }
 
+/// @brief Unpack the solution of the KKT system of lqrDenseMatrix() into the
+/// trajectory, and into feedforward gains with the layout
+/// \f$(u_t, v_t, \lambda_{t+1}, x_{t+1})\f$ of the Riccati solvers.
+/// @details This is for solvers which do not compute feedback gains. Unlike
+/// lqrDenseSolutionToTraj(), the trajectory is not resized: @p us may omit
+/// the terminal control.
+template <typename Scalar>
+void lqrSolutionToTrajAndGains(
+    const LQRProblemTpl<Scalar> &problem,
+    const typename math_types<Scalar>::ConstVectorRef solution,
+    std::vector<typename math_types<Scalar>::VectorXs> &xs,
+    std::vector<typename math_types<Scalar>::VectorXs> &us,
+    std::vector<typename math_types<Scalar>::VectorXs> &vs,
+    std::vector<typename math_types<Scalar>::VectorXs> &lbdas,
+    std::vector<BlkMatrix<typename math_types<Scalar>::VectorXs, 4, 1>> &ffs) {
+  const uint N = (uint)problem.horizon();
+  const uint nc0 = problem.nc0();
+  lbdas[0] = solution.head(nc0);
+  uint idx = nc0;
+  for (uint t = 0; t <= N; t++) {
+    const LQRKnotTpl<Scalar> &knot = problem.stages[t];
+    auto &ff = ffs[t];
+    xs[t] = solution.segment(idx, knot.nx);
+    idx += knot.nx;
+    ff[0] = solution.segment(idx, knot.nu);
+    if (t < us.size())
+      us[t] = ff[0];
+    idx += knot.nu;
+    vs[t] = ff[1] = solution.segment(idx, knot.nc);
+    idx += knot.nc;
+    if (t < N) {
+      lbdas[t + 1] = ff[2] = solution.segment(idx, knot.nx2);
+      ff[3] = solution.segment(idx + knot.nx2, knot.nx2);
+      idx += knot.nx2;
+    }
+  }
+}
+
 template <typename Scalar>
 auto lqrInitializeSolution(const LQRProblemTpl<Scalar> &problem) {
   using VectorXs = typename math_types<Scalar>::VectorXs;
@@ -292,6 +533,7 @@ extern template auto lqrComputeKktError<context::Scalar>(
 extern template auto
 lqrDenseMatrix<context::Scalar>(const LQRProblemTpl<context::Scalar> &,
                                 context::Scalar, context::Scalar);
+extern template struct LQRKktResidualTpl<context::Scalar>;
 #endif
 
 } // namespace gar
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <sys/types.h>
+#include <vector>
 
 namespace aligator {
 namespace gar {
@@ -18,5 +21,102 @@ inline workrange_t get_work(uint horz, uint tid, uint num_threads) {
   return {start, stop};
 }
 
+/// @brief Rough estimate of the number of flops in the backward Riccati
+/// recursion for an LQ knot (see LQRKnotTpl), from its dimensions, with
+/// @p nth parameters.
+template <typename KnotType>
+double estimate_knot_cost(const KnotType &knot, const double nth) {
+  const double nx = knot.nx;
+  const double nu = knot.nu;
+  const double nc = knot.nc;
+  const double nx2 = knot.nx2;
+  const double nxu = nx + nu;
+  // propagate the next value function through the dynamics
+  double cost = nxu * nx2 * (nxu + nx2);
+  // condense the constraints into the cost
+  cost += nc * nxu * nxu;
+  // factorize the control Hessian and compute the gains
+  cost += nu * nu * nu / 3. + nu * nu * (nx + nth + 1.);
+  // update the value function, including its parametric part
+  cost += nu * nx * (nx + nth) + nth * nxu * (nx + nth);
+  return cost;
+}
+
+/// @copybrief estimate_knot_cost()
+template <typename KnotType> double estimate_knot_cost(const KnotType &knot) {
+  return estimate_knot_cost(knot, knot.nth);
+}
+
+/// @brief Split a sequence of tasks with the given costs into @p num_parts
+/// contiguous ranges with balanced total costs.
+/// @details The boundaries are put where the cumulated cost is closest to a
+/// multiple of the mean cost per range. Every range is non-empty.
+inline std::vector<workrange_t>
+get_balanced_work(const std::vector<double> &costs, uint num_parts) {
+  const uint n = uint(costs.size());
+  assert(num_parts > 0);
+  assert(num_parts <= n);
+  std::vector<double> cumul(n + 1, 0.);
+  for (uint t = 0; t < n; t++)
+    cumul[t + 1] = cumul[t] + costs[t];
+
+  std::vector<workrange_t> out(num_parts);
+  uint beg = 0;
+  for (uint k = 0; k < num_parts; k++) {
+    uint end = n;
+    if (k + 1 < num_parts) {
+      const double target = cumul[n] * (k + 1) / num_parts;
+      auto it = std::lower_bound(cumul.begin() + beg + 1, cumul.end(), target);
+      end = uint(it - cumul.begin());
+      if (end > beg + 1 && (target - cumul[end - 1]) < (cumul[end] - target))
+        end--;
+      // leave at least one task to each of the remaining ranges
+      end = std::clamp(end, beg + 1, n - (num_parts - k - 1));
+    }
+    out[k] = {beg, end};
+    beg = end;
+  }
+  return out;
+}
+
+/// @brief Split the knots of an LQ problem into @p num_legs legs with
+/// balanced costs, for ParallelRiccatiSolver.
+/// @details The knots of all legs but the last get parameterized by the state
+/// of their leg, and are estimated with as many parameters as states. The
+/// start of the last leg, whose knots keep their own parameters, is chosen to
+/// balance its cost with the mean cost of the other legs, which are then split
+/// with get_balanced_work().
+template <typename KnotVec>
+std::vector<workrange_t> get_balanced_legs(const KnotVec &knots,
+                                           uint num_legs) {
+  const uint n = uint(knots.size());
+  assert(num_legs > 0);
+  assert(num_legs <= n);
+  if (num_legs == 1)
+    return {{0, n}};
+  // cost of the parameterized knots [0, s), and of the knots [s, n)
+  std::vector<double> costs(n), head(n + 1, 0.), tail(n + 1, 0.);
+  for (uint t = 0; t < n; t++) {
+    costs[t] = estimate_knot_cost(knots[t], knots[t].nx);
+    head[t + 1] = head[t] + costs[t];
+  }
+  for (uint t = n; t-- > 0;)
+    tail[t] = tail[t + 1] + estimate_knot_cost(knots[t]);
+
+  uint last_beg = num_legs - 1;
+  double best = std::numeric_limits<double>::infinity();
+  for (uint s = num_legs - 1; s < n; s++) {
+    const double c = std::max(head[s] / (num_legs - 1), tail[s]);
+    if (c < best) {
+      best = c;
+      last_beg = s;
+    }
+  }
+  costs.resize(last_beg);
+  std::vector<workrange_t> out = get_balanced_work(costs, num_legs - 1);
+  out.push_back({last_beg, n});
+  return out;
+}
+
 } // namespace gar
 } // namespace aligator
@@ -0,0 +1,11 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#include "aligator/gar/banded-ldlt.hpp"
+
+namespace aligator {
+namespace gar {
+
+template class BandedLDLT<context::Scalar>;
+template class BandedLDLTSolver<context::Scalar>;
+
+} // namespace gar
+} // namespace aligator
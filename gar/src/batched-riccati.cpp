@@ -0,0 +1,11 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#include "aligator/gar/batched-riccati.hpp"
+
+namespace aligator {
+namespace gar {
+
+template struct BatchedRiccatiKernel<context::Scalar, 4>;
+template class BatchedRiccatiSolver<context::Scalar, 4>;
+
+} // namespace gar
+} // namespace aligator
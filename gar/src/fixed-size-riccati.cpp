@@ -0,0 +1,17 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#include "aligator/gar/fixed-size-riccati.hpp"
+
+namespace aligator {
+namespace gar {
+
+template class ProximalRiccatiSolverFixed<context::Scalar, 4, 2, 0>;
+template class ProximalRiccatiSolverFixed<context::Scalar, 6, 3, 0>;
+template class ProximalRiccatiSolverFixed<context::Scalar, 12, 4, 0>;
+template class ProximalRiccatiSolverFixed<context::Scalar, 4, 2, 2>;
+template class ProximalRiccatiSolverFixed<context::Scalar, 6, 3, 3>;
+template class ProximalRiccatiSolverFixed<context::Scalar, 12, 4, 4>;
+template std::unique_ptr<RiccatiSolverBase<context::Scalar>>
+createProximalRiccatiSolver(const LQRProblemTpl<context::Scalar> &);
+
+} // namespace gar
+} // namespace aligator
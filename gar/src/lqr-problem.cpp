@@ -5,5 +5,7 @@ namespace aligator {
 namespace gar {
 template struct LQRKnotTpl<context::Scalar>;
 template struct LQRProblemTpl<context::Scalar>;
+template struct LQRKnotTpl<float>;
+template struct LQRProblemTpl<float>;
 } // namespace gar
 } // namespace aligator
@@ -0,0 +1,10 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#include "aligator/gar/mixed-precision-riccati.hpp"
+
+namespace aligator {
+namespace gar {
+
+template class MixedPrecisionRiccatiSolver<context::Scalar, float>;
+
+} // namespace gar
+} // namespace aligator
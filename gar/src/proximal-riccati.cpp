@@ -5,6 +5,7 @@ namespace aligator {
 namespace gar {
 
 template class ProximalRiccatiSolver<context::Scalar>;
+template class ProximalRiccatiSolver<float>;
 
 } // namespace gar
 } // namespace aligator
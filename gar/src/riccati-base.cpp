@@ -4,6 +4,7 @@ namespace aligator {
 namespace gar {
 
 template class RiccatiSolverBase<context::Scalar>;
+template class RiccatiSolverBase<float>;
 
 } // namespace gar
 } // namespace aligator
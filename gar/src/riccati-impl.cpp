@@ -5,6 +5,8 @@ namespace gar {
 
 template struct StageFactor<context::Scalar>;
 template struct ProximalRiccatiKernel<context::Scalar>;
+template struct StageFactor<float>;
+template struct ProximalRiccatiKernel<float>;
 
 } // namespace gar
 } // namespace aligator
@@ -12,5 +12,6 @@ template auto lqrComputeKktError<context::Scalar>(
 template auto
 lqrDenseMatrix<context::Scalar>(const LQRProblemTpl<context::Scalar> &,
                                 context::Scalar, context::Scalar);
+template struct LQRKktResidualTpl<context::Scalar>;
 } // namespace gar
 } // namespace aligator
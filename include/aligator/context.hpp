@@ -39,6 +39,7 @@ using ExplicitDynamics = ExplicitDynamicsModelTpl<Scalar>;
 using ExplicitDynamicsData = ExplicitDynamicsDataTpl<Scalar>;
 
 using SolverProxDDP = SolverProxDDPTpl<Scalar>;
+using SolverProxDDPBatch = SolverProxDDPBatchTpl<Scalar>;
 using SolverFDDP = SolverFDDPTpl<Scalar>;
 
 using Workspace = WorkspaceTpl<Scalar>;
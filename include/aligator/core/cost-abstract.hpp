@@ -44,6 +44,14 @@ template <typename _Scalar> struct CostAbstractTpl {
     return std::make_shared<CostData>(ndx(), nu);
   }
 
+  /// @brief Instantiate a data object which may read the data @p cache shared
+  /// by the functions of a stage (see StageCacheModelTpl). Defaults to
+  /// createData().
+  virtual shared_ptr<CostData>
+  createDataWithCache(const shared_ptr<StageCacheDataTpl<Scalar>> &) const {
+    return createData();
+  }
+
   virtual ~CostAbstractTpl() = default;
 };
 
@@ -68,6 +68,8 @@ struct ExplicitDynamicsDataTpl : StageFunctionDataTpl<_Scalar> {
   VectorXs dx_;
   /// Jacobian
   MatrixXs Jtmp_xnext;
+  /// Buffer for the product of Jtmp_xnext with the Jacobians wrt (x, u)
+  MatrixXs Jtmp_xu;
 
   VectorRef xnext_ref;
   VectorRef dx_ref;
@@ -3,11 +3,18 @@
 
 #include "aligator/core/explicit-dynamics.hpp"
 
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+
 namespace aligator {
 template <typename Scalar>
 ExplicitDynamicsModelTpl<Scalar>::ExplicitDynamicsModelTpl(
     ManifoldPtr next_state, const int nu)
-    : Base(next_state, nu, next_state) {}
+    : Base(next_state, nu, next_state) {
+  // on a vector space, the Jacobian wrt the next state is minus the identity
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<Scalar, Eigen::Dynamic>;
+  if (std::dynamic_pointer_cast<VectorSpace>(next_state))
+    this->jac_structure_.y = JacobianBlockStructure::diagonal();
+}
 
 template <typename Scalar>
 void ExplicitDynamicsModelTpl<Scalar>::evaluate(const ConstVectorRef &x,
@@ -31,8 +38,9 @@ void ExplicitDynamicsModelTpl<Scalar>::computeJacobians(const ConstVectorRef &x,
   // compose by jacobians of log (xout - y)
   this->space_next_->Jdifference(y, data_.xnext_, data_.Jy_, 0);
   this->space_next_->Jdifference(y, data_.xnext_, data_.Jtmp_xnext, 1);
-  data_.Jx_ = data_.Jtmp_xnext * data_.Jx_;
-  data_.Ju_ = data_.Jtmp_xnext * data_.Ju_;
+  auto Jxu = data_.jac_buffer_.leftCols(this->ndx1 + this->nu);
+  data_.Jtmp_xu.noalias() = data_.Jtmp_xnext * Jxu;
+  Jxu = data_.Jtmp_xu;
 }
 
 template <typename Scalar>
@@ -47,10 +55,12 @@ ExplicitDynamicsDataTpl<Scalar>::ExplicitDynamicsDataTpl(const int ndx1,
                                                          const int nx2,
                                                          const int ndx2)
     : Base(ndx1, nu, ndx2, ndx2), xnext_(nx2), dx_(ndx2),
-      Jtmp_xnext(ndx2, ndx2), xnext_ref(xnext_), dx_ref(dx_) {
+      Jtmp_xnext(ndx2, ndx2), Jtmp_xu(ndx2, ndx1 + nu), xnext_ref(xnext_),
+      dx_ref(dx_) {
   xnext_.setZero();
   dx_.setZero();
   Jtmp_xnext.setZero();
+  Jtmp_xu.setZero();
 }
 
 } // namespace aligator
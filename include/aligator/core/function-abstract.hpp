@@ -5,6 +5,7 @@
 
 #include "aligator/fwd.hpp"
 #include "aligator/core/clone.hpp"
+#include "aligator/core/jacobian-structure.hpp"
 
 #include <fmt/format.h>
 #include <ostream>
@@ -28,6 +29,11 @@ public:
   const int ndx2;
   /// @brief Function codimension
   const int nr;
+  /// @brief Structure of the Jacobians, which the solvers exploit to skip
+  /// products by known zero, identity or selection blocks. Nothing is assumed
+  /// by default; functions declare it in their constructor. A subclass which
+  /// overrides computeJacobians() must declare its own structure.
+  JacobianStructure jac_structure_;
 
   StageFunctionTpl(const int ndx1, const int nu, const int ndx2, const int nr);
 
@@ -53,6 +59,9 @@ public:
    *   \frac{\partial f}{\partial x'})
    * \f$
    *
+   * @pre       evaluate() was called at the same point with the same @p data,
+   *            whose intermediate results (e.g. kinematics) may be reused.
+   *
    * @param x     Current state.
    * @param u     Controls.
    * @param y     Next state.
@@ -80,6 +89,14 @@ public:
 
   /// @brief Instantiate a Data object.
   virtual shared_ptr<Data> createData() const;
+
+  /// @brief Instantiate a Data object which may read the data @p cache shared
+  /// by the functions of a stage (see StageCacheModelTpl). Defaults to
+  /// createData().
+  virtual shared_ptr<Data>
+  createDataWithCache(const shared_ptr<StageCacheDataTpl<Scalar>> &) const {
+    return createData();
+  }
 };
 
 /// @brief  Base struct for function data.
@@ -0,0 +1,117 @@
+/// @file jacobian-structure.hpp
+/// @brief Structure (sparsity pattern) of the Jacobians of a stage function.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/math.hpp"
+
+#include <vector>
+
+namespace aligator {
+
+/// @brief Known sparsity pattern of a block of a Jacobian matrix.
+enum class JacobianBlockType {
+  /// The block is zero.
+  ZERO,
+  /// The block is the identity matrix.
+  IDENTITY,
+  /// The block is square and diagonal.
+  DIAGONAL,
+  /// Each row of the block has (at most) one nonzero, in the column given by
+  /// JacobianBlockStructure::indices.
+  SELECTION,
+  /// No known structure.
+  DENSE
+};
+
+/// @brief Structure of a block of a Jacobian matrix.
+/// @details This only describes the pattern of the block: except for
+/// JacobianBlockType::IDENTITY, the values of its nonzero entries are still
+/// read from the dense Jacobian buffers of StageFunctionDataTpl.
+struct JacobianBlockStructure {
+  JacobianBlockType type = JacobianBlockType::DENSE;
+  /// Column of the nonzero entry of each row, for
+  /// JacobianBlockType::SELECTION.
+  std::vector<int> indices;
+
+  static JacobianBlockStructure zero() { return {JacobianBlockType::ZERO, {}}; }
+  static JacobianBlockStructure identity() {
+    return {JacobianBlockType::IDENTITY, {}};
+  }
+  static JacobianBlockStructure diagonal() {
+    return {JacobianBlockType::DIAGONAL, {}};
+  }
+  static JacobianBlockStructure selection(const std::vector<int> &indices) {
+    return {JacobianBlockType::SELECTION, indices};
+  }
+  static JacobianBlockStructure dense() { return {}; }
+
+  bool isZero() const { return type == JacobianBlockType::ZERO; }
+
+  /// @brief Structure of the block made of the given @p rows of this block.
+  JacobianBlockStructure rows(const std::vector<int> &rows) const {
+    switch (type) {
+    case JacobianBlockType::IDENTITY:
+    case JacobianBlockType::DIAGONAL:
+      return selection(rows);
+    case JacobianBlockType::SELECTION: {
+      std::vector<int> cols;
+      for (int r : rows)
+        cols.push_back(indices[std::size_t(r)]);
+      return selection(cols);
+    }
+    default:
+      return *this;
+    }
+  }
+};
+
+/// @brief Structure of the Jacobians \f$(J_x, J_u, J_y)\f$ of a function
+/// \f$f(x, u, y)\f$. Nothing is assumed by default.
+/// @details This is a sparsity pattern only: the Jacobians are stored in the
+/// dense StageFunctionDataTpl::jac_buffer_. It is used to skip products, and
+/// the structure of the dynamics sets the structure flags of the LQ knots
+/// (see SolverProxDDPTpl::updateLQStructure()).
+struct JacobianStructure {
+  JacobianBlockStructure x;
+  JacobianBlockStructure u;
+  JacobianBlockStructure y;
+
+  /// @brief Structure of the Jacobians of the given @p rows of the function.
+  JacobianStructure rows(const std::vector<int> &rows) const {
+    return {x.rows(rows), u.rows(rows), y.rows(rows)};
+  }
+};
+
+/// @brief Compute \f$ out \mathrel{+}= J^\top v \f$, only reading the
+/// structural nonzeros of the Jacobian block @p J.
+template <typename MatType, typename InType, typename OutType>
+void jacobianTransposeMultiplyAdd(const JacobianBlockStructure &structure,
+                                  const Eigen::MatrixBase<MatType> &J,
+                                  const Eigen::MatrixBase<InType> &v,
+                                  const Eigen::MatrixBase<OutType> &out_) {
+  OutType &out = out_.const_cast_derived();
+  switch (structure.type) {
+  case JacobianBlockType::ZERO:
+    break;
+  case JacobianBlockType::IDENTITY:
+    assert(J.isIdentity(0) && "Jacobian block declared identity is not.");
+    out += v;
+    break;
+  case JacobianBlockType::DIAGONAL:
+    out.array() += J.diagonal().array() * v.array();
+    break;
+  case JacobianBlockType::SELECTION:
+    for (std::size_t k = 0; k < structure.indices.size(); k++) {
+      const Eigen::Index i = Eigen::Index(k);
+      const Eigen::Index j = structure.indices[k];
+      out[j] += J(i, j) * v[i];
+    }
+    break;
+  case JacobianBlockType::DENSE:
+    out.noalias() += J.transpose() * v;
+    break;
+  }
+}
+
+} // namespace aligator
@@ -7,6 +7,8 @@
 namespace aligator {
 
 /// @brief  Compute the derivatives of the problem Lagrangian.
+/// @details The products by the transposed Jacobians skip the blocks which
+/// the functions declare as structured (see StageFunctionTpl::jac_structure_).
 template <typename Scalar> struct LagrangianDerivatives {
   ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
   using TrajOptProblem = TrajOptProblemTpl<Scalar>;
@@ -32,26 +34,32 @@ template <typename Scalar> struct LagrangianDerivatives {
 
     // initial condition
     const StageFunctionData &init_cond = *pd.init_data;
-    Lxs[0].noalias() = init_cond.Jx_.transpose() * lams[0];
+    jacobianTransposeMultiplyAdd(problem.init_condition_->jac_structure_.x,
+                                 init_cond.Jx_, lams[0], Lxs[0]);
 
     for (std::size_t i = 0; i < nsteps; i++) {
       const StageModel &sm = *problem.stages_[i];
       const StageData &sd = *pd.stage_data[i];
       const ConstraintStack &stack = sm.constraints_;
       const StageFunctionData &dd = *sd.dynamics_data;
-      Lxs[i].noalias() +=
-          sd.cost_data->Lx_ + dd.Jx_.transpose() * lams[i + 1]; // [1] eqn. 24c
-      Lus[i].noalias() =
-          sd.cost_data->Lu_ + dd.Ju_.transpose() * lams[i + 1]; // [1] eqn. 24b
+      const JacobianStructure &ds = sm.dynamics_->jac_structure_;
+      // [1] eqn. 24c
+      Lxs[i] += sd.cost_data->Lx_;
+      jacobianTransposeMultiplyAdd(ds.x, dd.Jx_, lams[i + 1], Lxs[i]);
+      // [1] eqn. 24b
+      Lus[i] = sd.cost_data->Lu_;
+      jacobianTransposeMultiplyAdd(ds.u, dd.Ju_, lams[i + 1], Lus[i]);
 
       BlkView v_(vs[i], stack.dims());
       for (std::size_t j = 0; j < stack.size(); j++) {
         const StageFunctionData &cd = *sd.constraint_data[j];
-        Lxs[i].noalias() += cd.Jx_.transpose() * v_[j]; // [1] eqn. 24c
-        Lus[i].noalias() += cd.Ju_.transpose() * v_[j]; // [1] eqn. 24b
+        const JacobianStructure &cs = stack[j].func->jac_structure_;
+        jacobianTransposeMultiplyAdd(cs.x, cd.Jx_, v_[j], Lxs[i]); // 24c
+        jacobianTransposeMultiplyAdd(cs.u, cd.Ju_, v_[j], Lus[i]); // 24b
       }
 
-      Lxs[i + 1].noalias() = dd.Jy_.transpose() * lams[i + 1]; // [1] eqn. 24b
+      // [1] eqn. 24b
+      jacobianTransposeMultiplyAdd(ds.y, dd.Jy_, lams[i + 1], Lxs[i + 1]);
     }
 
     // terminal node
@@ -62,7 +70,8 @@ template <typename Scalar> struct LagrangianDerivatives {
       BlkView vN(vs[nsteps], stack.dims());
       for (std::size_t j = 0; j < stack.size(); j++) {
         const StageFunctionData &cd = *pd.term_cstr_data[j];
-        Lxs[nsteps].noalias() += cd.Jx_.transpose() * vN[j];
+        jacobianTransposeMultiplyAdd(stack[j].func->jac_structure_.x, cd.Jx_,
+                                     vN[j], Lxs[nsteps]);
       }
     }
   }
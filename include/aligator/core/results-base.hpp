@@ -3,6 +3,7 @@
 #pragma once
 
 #include "aligator/fwd.hpp"
+#include "aligator/utils/mpc-util.hpp"
 
 namespace aligator {
 
@@ -77,6 +78,15 @@ public:
 
   void printBase(std::ostream &oss) const;
 
+  /// @brief   Cycle the trajectories and gains to the left.
+  /// @details Useful in model-predictive control (MPC) applications.
+  void cycleLeft() {
+    rotate_vec_left(xs);
+    rotate_vec_left(us);
+    // there might be an extra (terminal) gain
+    rotate_vec_left(gains_, 0, long(gains_.size() - us.size()));
+  }
+
 private:
   Eigen::Index get_ndx1(std::size_t i) const {
     return this->gains_[i].cols() - 1;
@@ -69,6 +69,17 @@ auto problemInitializeSolution(const TrajOptProblemTpl<Scalar> &problem) {
                          std::move(lbdas));
 }
 
+/// @brief Check whether two stages have the same state, control and constraint
+/// dimensions, i.e. whether one can reuse the data buffers of the other.
+template <typename Scalar>
+bool stage_dims_match(const StageModelTpl<Scalar> &a,
+                      const StageModelTpl<Scalar> &b) {
+  return (a.nx1() == b.nx1()) && (a.ndx1() == b.ndx1()) &&
+         (a.nu() == b.nu()) && (a.nx2() == b.nx2()) &&
+         (a.ndx2() == b.ndx2()) &&
+         (a.constraints_.dims() == b.constraints_.dims());
+}
+
 /// @brief Check the input state-control trajectory is a consistent warm-start
 /// for the output.
 template <typename Scalar>
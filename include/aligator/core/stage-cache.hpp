@@ -0,0 +1,47 @@
+/// @file
+/// @brief Data shared between the functions of a stage.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/fwd.hpp"
+
+namespace aligator {
+
+/// @brief Base struct for the data shared by the functions of a stage, see
+/// StageCacheModelTpl.
+template <typename _Scalar> struct StageCacheDataTpl {
+  using Scalar = _Scalar;
+  virtual ~StageCacheDataTpl() = default;
+};
+
+/** @brief    Intermediate quantities shared by the functions of a stage.
+ *
+ *  @details  Functions of the state which are costly and appear in several
+ *            residuals of a stage (e.g. the forward kinematics of a robot)
+ *            can be computed once by the stage, in StageModelTpl::evaluate()
+ *            and StageModelTpl::computeFirstOrderDerivatives(), before any
+ *            of its constraints or costs.
+ *            A StageDataTpl creates a single data object for its cache model,
+ *            and passes it to the data of its functions and costs through
+ *            their `createDataWithCache()` method. Functions which support the
+ *            cache then read the shared quantities instead of computing them.
+ */
+template <typename _Scalar> struct StageCacheModelTpl {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Data = StageCacheDataTpl<Scalar>;
+
+  /// @brief Compute the shared quantities at the current state @p x.
+  virtual void evaluate(const ConstVectorRef &x, Data &data) const = 0;
+
+  /// @brief Compute the derivatives of the shared quantities.
+  /// @pre   evaluate() was called at the same point, with the same @p data.
+  virtual void computeDerivatives(const ConstVectorRef &x,
+                                  Data &data) const = 0;
+
+  virtual shared_ptr<Data> createData() const = 0;
+
+  virtual ~StageCacheModelTpl() = default;
+};
+
+} // namespace aligator
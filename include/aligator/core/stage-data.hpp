@@ -5,6 +5,7 @@
 #include "aligator/fwd.hpp"
 #include "aligator/core/dynamics.hpp"
 #include "aligator/core/constraint.hpp"
+#include "aligator/core/stage-cache.hpp"
 #include "aligator/core/clone.hpp"
 
 namespace aligator {
@@ -19,7 +20,10 @@ struct StageDataTpl : Cloneable<StageDataTpl<_Scalar>> {
   using CostDataAbstract = CostDataAbstractTpl<Scalar>;
   using StageFunctionData = StageFunctionDataTpl<Scalar>;
   using DynamicsData = DynamicsDataTpl<Scalar>;
+  using CacheData = StageCacheDataTpl<Scalar>;
 
+  /// Data shared by the constraints and costs, if the stage has a cache model.
+  shared_ptr<CacheData> cache_data;
   /// Data structs for the functions involved in the constraints.
   std::vector<shared_ptr<StageFunctionData>> constraint_data;
   /// Data for the running costs.
@@ -32,14 +36,17 @@ struct StageDataTpl : Cloneable<StageDataTpl<_Scalar>> {
   /// @details  The constructor initializes or fills in the data members using
   /// move semantics.
   explicit StageDataTpl(const StageModel &stage_model)
-      : constraint_data(stage_model.numConstraints()),
-        cost_data(stage_model.cost_->createData()),
+      : cache_data(stage_model.cache_model_
+                       ? stage_model.cache_model_->createData()
+                       : nullptr),
+        constraint_data(stage_model.numConstraints()),
+        cost_data(stage_model.cost_->createDataWithCache(cache_data)),
         dynamics_data(stage_model.dynamics_->createData()) {
     const std::size_t nc = stage_model.numConstraints();
 
     for (std::size_t j = 0; j < nc; j++) {
       const auto &func = stage_model.constraints_[j].func;
-      constraint_data[j] = func->createData();
+      constraint_data[j] = func->createDataWithCache(cache_data);
     }
   }
 
@@ -5,6 +5,7 @@
 #include "aligator/core/function-abstract.hpp"
 #include "aligator/core/dynamics.hpp"
 #include "aligator/core/constraint.hpp"
+#include "aligator/core/stage-cache.hpp"
 
 #include "aligator/core/clone.hpp"
 
@@ -33,6 +34,7 @@ public:
   using Cost = CostAbstractTpl<Scalar>;
   using CostPtr = shared_ptr<Cost>;
   using Data = StageDataTpl<Scalar>;
+  using CacheModel = StageCacheModelTpl<Scalar>;
 
   /// State space for the current state \f$x_k\f$.
   ManifoldPtr xspace_;
@@ -46,6 +48,9 @@ public:
   CostPtr cost_;
   /// Dynamics model
   DynamicsPtr dynamics_;
+  /// Quantities shared by the constraints and costs of the stage, computed
+  /// first. Optional.
+  shared_ptr<CacheModel> cache_model_;
 
   /// Constructor assumes the control space is a Euclidean space of
   /// dimension @p nu.
@@ -96,6 +101,7 @@ public:
                         const ConstVectorRef &y, Data &data) const;
 
   /// @brief    Compute the first-order derivatives of the StageModelTpl.
+  /// @pre      evaluate() was called at the same point, with the same @p data.
   virtual void computeFirstOrderDerivatives(const ConstVectorRef &x,
                                             const ConstVectorRef &u,
                                             const ConstVectorRef &y,
@@ -67,6 +67,8 @@ void StageModelTpl<Scalar>::evaluate(const ConstVectorRef &x,
                                      const ConstVectorRef &u,
                                      const ConstVectorRef &y,
                                      Data &data) const {
+  if (cache_model_)
+    cache_model_->evaluate(x, *data.cache_data);
   dynamics_->evaluate(x, u, y, *data.dynamics_data);
   for (std::size_t j = 0; j < numConstraints(); j++) {
     const Constraint &cstr = constraints_[j];
@@ -79,6 +81,8 @@ template <typename Scalar>
 void StageModelTpl<Scalar>::computeFirstOrderDerivatives(
     const ConstVectorRef &x, const ConstVectorRef &u, const ConstVectorRef &y,
     Data &data) const {
+  if (cache_model_)
+    cache_model_->computeDerivatives(x, *data.cache_data);
   dynamics_->computeJacobians(x, u, y, *data.dynamics_data);
   for (std::size_t j = 0; j < numConstraints(); j++) {
     const Constraint &cstr = constraints_[j];
@@ -4,6 +4,7 @@
 
 #include "aligator/core/stage-model.hpp"
 #include "aligator/modelling/state-error.hpp"
+#include "aligator/threads.hpp"
 
 namespace aligator {
 
@@ -157,6 +158,12 @@ template <typename _Scalar> struct TrajOptProblemTpl {
                   const std::vector<VectorXs> &us, Data &prob_data,
                   std::size_t num_threads = 1) const;
 
+  /// @copybrief evaluate()
+  /// @details The stages are evaluated in parallel on the given thread pool.
+  Scalar evaluate(const std::vector<VectorXs> &xs,
+                  const std::vector<VectorXs> &us, Data &prob_data,
+                  ThreadPool &pool) const;
+
   /**
    * @brief Rollout the problem derivatives, stage per stage.
    *
@@ -171,6 +178,14 @@ template <typename _Scalar> struct TrajOptProblemTpl {
                           std::size_t num_threads = 1,
                           bool compute_second_order = true) const;
 
+  /// @copybrief computeDerivatives()
+  /// @details The stages are differentiated in parallel on the given thread
+  /// pool.
+  void computeDerivatives(const std::vector<VectorXs> &xs,
+                          const std::vector<VectorXs> &us, Data &prob_data,
+                          ThreadPool &pool,
+                          bool compute_second_order = true) const;
+
   /// @brief Pop out the first StageModel and replace by the supplied one;
   /// updates the supplied problem data (TrajOptDataTpl) object.
   void replaceStageCircular(const shared_ptr<StageModel> &model);
@@ -194,6 +209,15 @@ protected:
   /// @brief Check if all stages are non-null.
   void checkStages() const;
 
+  Scalar evaluateImpl(const std::vector<VectorXs> &xs,
+                      const std::vector<VectorXs> &us, Data &prob_data,
+                      ThreadPool *pool, std::size_t num_threads) const;
+
+  void computeDerivativesImpl(const std::vector<VectorXs> &xs,
+                              const std::vector<VectorXs> &us, Data &prob_data,
+                              ThreadPool *pool, std::size_t num_threads,
+                              bool compute_second_order) const;
+
 private:
   static auto createStateError(const ConstVectorRef &x0,
                                const shared_ptr<Manifold> &space,
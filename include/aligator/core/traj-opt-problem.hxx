@@ -54,9 +54,26 @@ TrajOptProblemTpl<Scalar>::TrajOptProblemTpl(const ConstVectorRef &x0,
     : TrajOptProblemTpl(createStateError(x0, space, nu), term_cost) {}
 
 template <typename Scalar>
-Scalar TrajOptProblemTpl<Scalar>::evaluate(
+Scalar TrajOptProblemTpl<Scalar>::evaluate(const std::vector<VectorXs> &xs,
+                                           const std::vector<VectorXs> &us,
+                                           Data &prob_data,
+                                           std::size_t num_threads) const {
+  return evaluateImpl(xs, us, prob_data, nullptr, num_threads);
+}
+
+template <typename Scalar>
+Scalar TrajOptProblemTpl<Scalar>::evaluate(const std::vector<VectorXs> &xs,
+                                           const std::vector<VectorXs> &us,
+                                           Data &prob_data,
+                                           ThreadPool &pool) const {
+  return evaluateImpl(xs, us, prob_data, &pool, pool.numThreads());
+}
+
+template <typename Scalar>
+Scalar TrajOptProblemTpl<Scalar>::evaluateImpl(
     const std::vector<VectorXs> &xs, const std::vector<VectorXs> &us,
-    Data &prob_data, ALIGATOR_MAYBE_UNUSED std::size_t num_threads) const {
+    Data &prob_data, ThreadPool *pool,
+    ALIGATOR_MAYBE_UNUSED std::size_t num_threads) const {
   ZoneScopedN("TrajOptProblem::evaluate");
   const std::size_t nsteps = numSteps();
   if (xs.size() != nsteps + 1)
@@ -70,12 +87,9 @@ Scalar TrajOptProblemTpl<Scalar>::evaluate(
 
   auto &sds = prob_data.stage_data;
 
-  Eigen::setNbThreads(1);
-#pragma omp parallel for num_threads(num_threads) schedule(auto)
-  for (std::size_t i = 0; i < nsteps; i++) {
+  parallel_for(pool, num_threads, nsteps, [&](std::size_t i) {
     stages_[i]->evaluate(xs[i], us[i], xs[i + 1], *sds[i]);
-  }
-  Eigen::setNbThreads(0);
+  });
 
   term_cost_->evaluate(xs[nsteps], unone_, *prob_data.term_cost_data);
 
@@ -91,7 +105,25 @@ Scalar TrajOptProblemTpl<Scalar>::evaluate(
 template <typename Scalar>
 void TrajOptProblemTpl<Scalar>::computeDerivatives(
     const std::vector<VectorXs> &xs, const std::vector<VectorXs> &us,
-    Data &prob_data, ALIGATOR_MAYBE_UNUSED std::size_t num_threads,
+    Data &prob_data, std::size_t num_threads,
+    bool compute_second_order) const {
+  computeDerivativesImpl(xs, us, prob_data, nullptr, num_threads,
+                         compute_second_order);
+}
+
+template <typename Scalar>
+void TrajOptProblemTpl<Scalar>::computeDerivatives(
+    const std::vector<VectorXs> &xs, const std::vector<VectorXs> &us,
+    Data &prob_data, ThreadPool &pool, bool compute_second_order) const {
+  computeDerivativesImpl(xs, us, prob_data, &pool, pool.numThreads(),
+                         compute_second_order);
+}
+
+template <typename Scalar>
+void TrajOptProblemTpl<Scalar>::computeDerivativesImpl(
+    const std::vector<VectorXs> &xs, const std::vector<VectorXs> &us,
+    Data &prob_data, ThreadPool *pool,
+    ALIGATOR_MAYBE_UNUSED std::size_t num_threads,
     bool compute_second_order) const {
   ZoneScopedN("TrajOptProblem::computeDerivatives");
   const std::size_t nsteps = numSteps();
@@ -106,15 +138,12 @@ void TrajOptProblemTpl<Scalar>::computeDerivatives(
 
   auto &sds = prob_data.stage_data;
 
-  Eigen::setNbThreads(1);
-#pragma omp parallel for num_threads(num_threads) schedule(auto)
-  for (std::size_t i = 0; i < nsteps; i++) {
+  parallel_for(pool, num_threads, nsteps, [&](std::size_t i) {
     stages_[i]->computeFirstOrderDerivatives(xs[i], us[i], xs[i + 1], *sds[i]);
     if (compute_second_order) {
       stages_[i]->computeSecondOrderDerivatives(xs[i], us[i], *sds[i]);
     }
-  }
-  Eigen::setNbThreads(0);
+  });
 
   if (term_cost_) {
     term_cost_->computeGradients(xs[nsteps], unone_, *prob_data.term_cost_data);
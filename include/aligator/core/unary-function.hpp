@@ -15,7 +15,15 @@ struct UnaryFunctionTpl : StageFunctionTpl<_Scalar> {
   using Base = StageFunctionTpl<Scalar>;
   using Data = StageFunctionDataTpl<Scalar>;
 
-  using Base::Base;
+  /// The Jacobians with respect to \f$u\f$ and \f$y\f$ are declared zero.
+  UnaryFunctionTpl(const int ndx1, const int nu, const int ndx2, const int nr)
+      : Base(ndx1, nu, ndx2, nr) {
+    this->jac_structure_.u = JacobianBlockStructure::zero();
+    this->jac_structure_.y = JacobianBlockStructure::zero();
+  }
+
+  UnaryFunctionTpl(const int ndx, const int nu, const int nr)
+      : UnaryFunctionTpl(ndx, nu, ndx, nr) {}
 
   virtual void evaluate(const ConstVectorRef &x, Data &data) const = 0;
   virtual void computeJacobians(const ConstVectorRef &x, Data &data) const = 0;
@@ -83,6 +83,12 @@ template <typename Scalar> struct StageModelTpl;
 // fwd StageDataTpl
 template <typename Scalar> struct StageDataTpl;
 
+// fwd StageCacheModelTpl
+template <typename Scalar> struct StageCacheModelTpl;
+
+// fwd StageCacheDataTpl
+template <typename Scalar> struct StageCacheDataTpl;
+
 // fwd CallbackBaseTpl
 template <typename Scalar> struct CallbackBaseTpl;
 
@@ -100,6 +106,9 @@ template <typename Scalar> struct TrajOptDataTpl;
 // fwd SolverProxDDP
 template <typename Scalar> struct SolverProxDDPTpl;
 
+// fwd SolverProxDDPBatchTpl
+template <typename Scalar> struct SolverProxDDPBatchTpl;
+
 // fwd SolverFDDP
 template <typename Scalar> struct SolverFDDPTpl;
 
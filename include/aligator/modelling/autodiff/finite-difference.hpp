@@ -4,12 +4,22 @@
 
 #include "aligator/core/dynamics.hpp"
 #include "aligator/core/cost-abstract.hpp"
+#include "aligator/threads.hpp"
 #include <proxsuite-nlp/manifold-base.hpp>
 #include <boost/mpl/bool.hpp>
 
 namespace aligator {
 namespace autodiff {
 
+/// @brief Finite difference scheme.
+enum class FiniteDifferenceScheme {
+  /// \f$(f(z \oplus h e_i) - f(z)) / h\f$: one evaluation per column.
+  FORWARD,
+  /// \f$(f(z \oplus h e_i) - f(z \ominus h e_i)) / 2h\f$: two evaluations
+  /// per column, but second-order accurate.
+  CENTRAL
+};
+
 namespace internal {
 
 // fwd declare the implementation of finite difference algorithms.
@@ -20,46 +30,114 @@ struct finite_difference_impl : virtual _Base<_Scalar> {
   using Base = _Base<Scalar>;
   using BaseData = typename Base::Data;
   using Manifold = ManifoldAbstractTpl<Scalar>;
+  using MatrixXb = Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>;
 
   shared_ptr<Manifold> space_;
   shared_ptr<Base> func_;
   Scalar fd_eps;
   int nx1, nx2;
-
-  struct Data : BaseData {
-    using BaseData::ndx1;
-    using BaseData::ndx2;
-    using BaseData::nr;
-    using BaseData::nu;
-    shared_ptr<BaseData> data_0;
-    shared_ptr<BaseData> data_1;
+  FiniteDifferenceScheme scheme = FiniteDifferenceScheme::FORWARD;
+  /// Number of threads over which the perturbed evaluations are distributed.
+  /// The colors are split into as many contiguous chunks, each with its own
+  /// clone of the function data. Must be set before createData().
+  std::size_t num_threads = 1;
+
+  /// Buffers for the perturbed evaluations of one chunk of colors.
+  struct ThreadData {
+    shared_ptr<BaseData> data_p;
+    shared_ptr<BaseData> data_m;
     VectorXs dx, du, dy;
     VectorXs xp, up, yp;
+    VectorXs diff;
 
-    Data(finite_difference_impl const &model)
-        : BaseData(model.ndx1, model.nu, model.ndx2, model.nr),
-          data_0(model.func_->createData()), data_1(model.func_->createData()),
-          dx(ndx1), du(nu), dy(ndx2), xp(model.nx1), up(model.nu),
-          yp(model.nx2) {
+    ThreadData(finite_difference_impl const &model)
+        : data_p(model.func_->createData()),
+          data_m(model.func_->createData()), dx(model.ndx1), du(model.nu),
+          dy(model.ndx2), xp(model.nx1), up(model.nu), yp(model.nx2),
+          diff(model.nr) {
       dx.setZero();
       du.setZero();
       dy.setZero();
     }
   };
 
+  struct Data : BaseData {
+    shared_ptr<BaseData> data_0;
+    std::vector<ThreadData> threads;
+
+    Data(finite_difference_impl const &model)
+        : BaseData(model.ndx1, model.nu, model.ndx2, model.nr),
+          data_0(model.func_->createData()) {
+      const std::size_t n = std::max<std::size_t>(model.num_threads, 1);
+      for (std::size_t i = 0; i < n; i++)
+        threads.emplace_back(model);
+    }
+  };
+
   template <typename U = Base, class = std::enable_if_t<
                                    std::is_same_v<U, StageFunctionTpl<Scalar>>>>
   finite_difference_impl(shared_ptr<Manifold> space, shared_ptr<U> func,
                          const Scalar fd_eps)
       : Base(func->ndx1, func->nu, func->ndx2, func->nr), space_(space),
-        func_(func), fd_eps(fd_eps), nx1(space->nx()), nx2(space->nx()) {}
+        func_(func), fd_eps(fd_eps), nx1(space->nx()), nx2(space->nx()) {
+    clearSparsityPattern();
+  }
 
   template <typename U = Base, class = std::enable_if_t<
                                    std::is_same_v<U, DynamicsModelTpl<Scalar>>>>
   finite_difference_impl(shared_ptr<Manifold> space, shared_ptr<U> func,
                          const Scalar fd_eps, boost::mpl::false_ = {})
       : Base(space, func->nu, space), space_(space), func_(func),
-        fd_eps(fd_eps), nx1(space->nx()), nx2(space->nx()) {}
+        fd_eps(fd_eps), nx1(space->nx()), nx2(space->nx()) {
+    clearSparsityPattern();
+  }
+
+  /// @brief Set the sparsity pattern of the full Jacobian with respect to
+  /// \f$(x, u, y)\f$, given by the nonzero entries of @p pattern (e.g. a
+  /// Jacobian computed at a generic point).
+  /// @details The columns are then colored greedily, so that the columns of
+  /// a color have no structural nonzero in a common row: the columns of each
+  /// color are perturbed simultaneously, with one evaluation (two for
+  /// central differences) per color.
+  void setSparsityPattern(const ConstMatrixRef &pattern) {
+    const int nvar = this->ndx1 + this->nu + this->ndx2;
+    if (pattern.rows() != this->nr || pattern.cols() != nvar)
+      ALIGATOR_DOMAIN_ERROR(fmt::format(
+          "Sparsity pattern should have dimensions ({:d}, {:d}).", this->nr,
+          nvar));
+    pattern_ = pattern.array() != Scalar(0);
+    colors_.clear();
+    std::vector<Eigen::Matrix<bool, Eigen::Dynamic, 1>> used_rows;
+    for (int j = 0; j < nvar; j++) {
+      std::size_t c = 0;
+      while (c < colors_.size() &&
+             (used_rows[c].array() && pattern_.col(j).array()).any())
+        c++;
+      if (c == colors_.size()) {
+        colors_.emplace_back();
+        used_rows.push_back(pattern_.col(j));
+      } else {
+        used_rows[c] = used_rows[c].array() || pattern_.col(j).array();
+      }
+      colors_[c].push_back(j);
+    }
+  }
+
+  /// @brief Perturb one column at a time.
+  void clearSparsityPattern() {
+    const int nvar = this->ndx1 + this->nu + this->ndx2;
+    pattern_.resize(0, 0);
+    colors_.resize(std::size_t(nvar));
+    for (int j = 0; j < nvar; j++)
+      colors_[std::size_t(j)] = {j};
+  }
+
+  /// Number of perturbed evaluations per Jacobian (times two for central
+  /// differences).
+  std::size_t numColors() const { return colors_.size(); }
+
+  /// Set the thread pool running the chunks of colors (null for OpenMP).
+  void setThreadPool(ThreadPool *pool) { pool_ = pool; }
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
                 const ConstVectorRef &y, BaseData &data) const {
@@ -68,35 +146,41 @@ struct finite_difference_impl : virtual _Base<_Scalar> {
     d.value_ = d.data_0->value_;
   }
 
+  /// @pre For forward differences, evaluate() was called at the same point.
   void computeJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
                         const ConstVectorRef &y, BaseData &data) const {
     Data &d = static_cast<Data &>(data);
-
-    VectorXs &v0 = d.data_0->value_;
-    VectorXs &vp = d.data_1->value_;
-
-    for (int i = 0; i < func_->ndx1; i++) {
-      d.dx[i] = fd_eps;
-      space_->integrate(x, d.dx, d.xp);
-      func_->evaluate(d.xp, u, y, *d.data_1);
-      data.Jx_.col(i) = (vp - v0) / fd_eps;
-      d.dx[i] = 0.;
-    }
-
-    for (int i = 0; i < func_->ndx2; i++) {
-      d.dy[i] = fd_eps;
-      space_->integrate(y, d.dy, d.yp);
-      func_->evaluate(x, u, d.yp, *d.data_1);
-      data.Jy_.col(i) = (vp - v0) / fd_eps;
-      d.dy[i] = 0.;
-    }
-
-    for (int i = 0; i < func_->nu; i++) {
-      d.du[i] = fd_eps;
-      d.up = u + d.du;
-      func_->evaluate(x, d.up, y, *d.data_1);
-      data.Ju_.col(i) = (vp - v0) / fd_eps;
-      d.du[i] = 0.;
+    const std::size_t num_colors = colors_.size();
+    const std::size_t num_chunks = std::min(d.threads.size(), num_colors);
+    auto compute_color = [&](std::size_t c, ThreadData &td) {
+      const std::vector<int> &cols = colors_[c];
+      evaluatePerturbed(x, u, y, cols, fd_eps, td, *td.data_p);
+      if (scheme == FiniteDifferenceScheme::CENTRAL) {
+        evaluatePerturbed(x, u, y, cols, -fd_eps, td, *td.data_m);
+        td.diff = (td.data_p->value_ - td.data_m->value_) / (2 * fd_eps);
+      } else {
+        td.diff = (td.data_p->value_ - d.data_0->value_) / fd_eps;
+      }
+      for (int j : cols) {
+        if (pattern_.size() == 0)
+          d.jac_buffer_.col(j) = td.diff;
+        else
+          d.jac_buffer_.col(j) = pattern_.col(j).select(td.diff, Scalar(0));
+      }
+    };
+
+    // the buffers belong to a chunk, whichever thread runs it
+    auto compute_chunk = [&](std::size_t k) {
+      const std::size_t c0 = k * num_colors / num_chunks;
+      const std::size_t c1 = (k + 1) * num_colors / num_chunks;
+      for (std::size_t c = c0; c < c1; c++)
+        compute_color(c, d.threads[k]);
+    };
+
+    if (num_chunks > 1) {
+      parallel_for(pool_, num_chunks, num_chunks, compute_chunk);
+    } else if (num_chunks == 1) {
+      compute_chunk(0);
     }
   }
 
@@ -108,6 +192,53 @@ struct finite_difference_impl : virtual _Base<_Scalar> {
   shared_ptr<BaseData> createData() const {
     return std::make_shared<Data>(*this);
   }
+
+protected:
+  /// Structural nonzeros of the Jacobian, empty if unknown.
+  MatrixXb pattern_;
+  /// Groups of columns which are perturbed simultaneously.
+  std::vector<std::vector<int>> colors_;
+  ThreadPool *pool_ = nullptr;
+
+  /// Evaluate the function with the coordinates @p cols of \f$(x, u, y)\f$
+  /// perturbed by @p h.
+  void evaluatePerturbed(const ConstVectorRef &x, const ConstVectorRef &u,
+                         const ConstVectorRef &y, const std::vector<int> &cols,
+                         const Scalar h, ThreadData &td,
+                         BaseData &out) const {
+    const int ndx1 = this->ndx1;
+    const int nu = this->nu;
+    bool px = false, pu = false, py = false;
+    for (int j : cols) {
+      if (j < ndx1) {
+        td.dx[j] = h;
+        px = true;
+      } else if (j < ndx1 + nu) {
+        td.du[j - ndx1] = h;
+        pu = true;
+      } else {
+        td.dy[j - ndx1 - nu] = h;
+        py = true;
+      }
+    }
+    if (px)
+      space_->integrate(x, td.dx, td.xp);
+    if (pu)
+      td.up = u + td.du;
+    if (py)
+      space_->integrate(y, td.dy, td.yp);
+    func_->evaluate(px ? ConstVectorRef(td.xp) : x,
+                    pu ? ConstVectorRef(td.up) : u,
+                    py ? ConstVectorRef(td.yp) : y, out);
+    for (int j : cols) {
+      if (j < ndx1)
+        td.dx[j] = 0.;
+      else if (j < ndx1 + nu)
+        td.du[j - ndx1] = 0.;
+      else
+        td.dy[j - ndx1 - nu] = 0.;
+    }
+  }
 };
 
 } // namespace internal
@@ -0,0 +1,240 @@
+/// @file forward-autodiff.hpp
+/// @brief Exact derivatives of functions and costs using forward-mode
+/// automatic differentiation.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/core/function-abstract.hpp"
+#include "aligator/core/cost-abstract.hpp"
+
+#include <unsupported/Eigen/AutoDiff>
+
+namespace aligator {
+namespace autodiff {
+
+/// @brief Scalar and vector types of the forward-mode automatic
+/// differentiation of a function of @p NVar variables.
+/// @details Each scalar carries the derivatives along all the @p NVar seed
+/// directions, so a single evaluation of the function yields its full
+/// Jacobian, and the operations on the derivatives are vectorized. A fixed
+/// @p NVar keeps the derivatives on the stack.
+template <typename Scalar, int NVar = Eigen::Dynamic> struct ForwardADTypes {
+  using Derivatives = Eigen::Matrix<Scalar, NVar, 1>;
+  using ADScalar = Eigen::AutoDiffScalar<Derivatives>;
+  using ADVector = Eigen::Matrix<ADScalar, Eigen::Dynamic, 1>;
+
+  /// @brief Set the values of @p xad to @p x, and its derivatives to the
+  /// seed directions \f$e_{k_0}, \ldots, e_{k_0 + n - 1}\f$ of a space of
+  /// dimension @p nvar.
+  static void seed(const typename math_types<Scalar>::ConstVectorRef &x,
+                   const Eigen::Index k0, const Eigen::Index nvar,
+                   ADVector &xad) {
+    xad.resize(x.size());
+    for (Eigen::Index i = 0; i < x.size(); i++) {
+      xad[i].value() = x[i];
+      xad[i].derivatives() = Derivatives::Unit(nvar, k0 + i);
+    }
+  }
+
+  /// @brief Copy the values and derivatives of @p rad, with @p nvar
+  /// variables, into @p value and @p jac.
+  template <typename VecType, typename MatType>
+  static void extract(const ADVector &rad, const Eigen::Index nvar,
+                      const Eigen::MatrixBase<VecType> &value_,
+                      const Eigen::MatrixBase<MatType> &jac_) {
+    VecType &value = value_.const_cast_derived();
+    MatType &jac = jac_.const_cast_derived();
+    for (Eigen::Index k = 0; k < rad.size(); k++) {
+      value[k] = rad[k].value();
+      // outputs which do not depend on the inputs have no derivatives
+      if (rad[k].derivatives().size() == nvar)
+        jac.row(k) = rad[k].derivatives().transpose();
+      else
+        jac.row(k).setZero();
+    }
+  }
+};
+
+/** @brief A function \f$f(x, u, y)\f$ whose Jacobians are computed by
+ * forward-mode automatic differentiation of a functor.
+ *
+ * @details The functor @p Functor is written once, templated on the scalar
+ * type:
+ * @code
+ * struct MyResidual {
+ *   template <typename T>
+ *   void operator()(const Eigen::Ref<const Eigen::VectorX<T>> &x,
+ *                   const Eigen::Ref<const Eigen::VectorX<T>> &u,
+ *                   const Eigen::Ref<const Eigen::VectorX<T>> &y,
+ *                   Eigen::Ref<Eigen::VectorX<T>> out) const;
+ * };
+ * @endcode
+ * computeJacobians() evaluates it once on dual numbers carrying the
+ * derivatives along all the @p NVar = ndx1 + nu + ndx2 variables, and sets
+ * the value along with the Jacobians. The arguments are treated as Euclidean
+ * vectors (\f$n_x = n_{dx}\f$).
+ *
+ * @warning With the default @p NVar = Eigen::Dynamic, the derivatives of each
+ * dual number, including the temporaries of the functor, are heap-allocated
+ * on every call to computeJacobians(), which breaks allocation-free solver
+ * iterations. Prefer a fixed @p NVar = ndx1 + nu + ndx2 when it is known at
+ * compile time.
+ */
+template <typename _Scalar, typename Functor, int NVar = Eigen::Dynamic>
+struct AutoDiffFunctionTpl : StageFunctionTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = StageFunctionTpl<Scalar>;
+  using BaseData = StageFunctionDataTpl<Scalar>;
+  using AD = ForwardADTypes<Scalar, NVar>;
+  using ADVector = typename AD::ADVector;
+  using ADVectorRef = Eigen::Ref<ADVector>;
+  using ConstADVectorRef = Eigen::Ref<const ADVector>;
+
+  struct Data : BaseData {
+    ADVector xad, uad, yad, rad;
+    Data(const AutoDiffFunctionTpl &model)
+        : BaseData(model.ndx1, model.nu, model.ndx2, model.nr),
+          rad(model.nr) {}
+  };
+
+  Functor functor_;
+
+  AutoDiffFunctionTpl(const int ndx1, const int nu, const int ndx2,
+                      const int nr, const Functor &functor = Functor{})
+      : Base(ndx1, nu, ndx2, nr), functor_(functor) {
+    if (NVar != Eigen::Dynamic && NVar != ndx1 + nu + ndx2)
+      ALIGATOR_DOMAIN_ERROR(
+          fmt::format("Number of variables NVar={:d} should be {:d}.", NVar,
+                      ndx1 + nu + ndx2));
+  }
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                const ConstVectorRef &y, BaseData &data) const override {
+    functor_(x, u, y, VectorRef(data.value_));
+  }
+
+  /// @details This also sets the function value.
+  void computeJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
+                        const ConstVectorRef &y,
+                        BaseData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    const int ndx1 = this->ndx1;
+    const int nu = this->nu;
+    const int nvar = ndx1 + nu + this->ndx2;
+    AD::seed(x, 0, nvar, d.xad);
+    AD::seed(u, ndx1, nvar, d.uad);
+    AD::seed(y, ndx1 + nu, nvar, d.yad);
+    functor_(ConstADVectorRef(d.xad), ConstADVectorRef(d.uad),
+             ConstADVectorRef(d.yad), ADVectorRef(d.rad));
+    AD::extract(d.rad, nvar, d.value_, d.jac_buffer_);
+  }
+
+  shared_ptr<BaseData> createData() const override {
+    return std::make_shared<Data>(*this);
+  }
+};
+
+/** @brief The cost
+ * \f$\ell(x, u) = \frac{1}{2} r(x, u)^\top W r(x, u)\f$ of a residual whose
+ * Jacobians are computed by forward-mode automatic differentiation of a
+ * functor.
+ *
+ * @details The functor has the same form as for AutoDiffFunctionTpl, without
+ * the next state argument. computeGradients() computes the residual and its
+ * Jacobian in a single evaluation on dual numbers, and computeHessians()
+ * reuses this Jacobian for the Gauss-Newton Hessian \f$J^\top W J\f$.
+ * The state space must be Euclidean (\f$n_x = n_{dx}\f$).
+ *
+ * @warning As for AutoDiffFunctionTpl, @p NVar = Eigen::Dynamic
+ * heap-allocates the derivatives on every call to computeGradients(). Prefer
+ * a fixed @p NVar = ndx + nu when it is known at compile time.
+ */
+template <typename _Scalar, typename Functor, int NVar = Eigen::Dynamic>
+struct AutoDiffResidualCostTpl : CostAbstractTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = CostAbstractTpl<Scalar>;
+  using CostData = CostDataAbstractTpl<Scalar>;
+  using Manifold = ManifoldAbstractTpl<Scalar>;
+  using AD = ForwardADTypes<Scalar, NVar>;
+  using ADVector = typename AD::ADVector;
+  using ADVectorRef = Eigen::Ref<ADVector>;
+  using ConstADVectorRef = Eigen::Ref<const ADVector>;
+
+  struct Data : CostData {
+    VectorXs residual_;
+    VectorXs weighted_residual_;
+    MatrixXs jac_;
+    MatrixXs JtW_buf;
+    ADVector xad, uad, rad;
+    Data(const AutoDiffResidualCostTpl &model)
+        : CostData(model), residual_(model.nr), weighted_residual_(model.nr),
+          jac_(model.nr, model.ndx() + model.nu),
+          JtW_buf(model.ndx() + model.nu, model.nr), rad(model.nr) {
+      residual_.setZero();
+      weighted_residual_.setZero();
+      jac_.setZero();
+      JtW_buf.setZero();
+    }
+  };
+
+  /// Residual dimension.
+  int nr;
+  MatrixXs weights_;
+  Functor functor_;
+
+  AutoDiffResidualCostTpl(shared_ptr<Manifold> space, const int nu,
+                          const ConstMatrixRef &weights,
+                          const Functor &functor = Functor{})
+      : Base(space, nu), nr(int(weights.rows())), weights_(weights),
+        functor_(functor) {
+    if (space->nx() != space->ndx())
+      ALIGATOR_DOMAIN_ERROR("The state space should be Euclidean.");
+    if (weights.rows() != weights.cols())
+      ALIGATOR_DOMAIN_ERROR("Weights matrix should be square.");
+    if (NVar != Eigen::Dynamic && NVar != this->ndx() + nu)
+      ALIGATOR_DOMAIN_ERROR(
+          fmt::format("Number of variables NVar={:d} should be {:d}.", NVar,
+                      this->ndx() + nu));
+  }
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                CostData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    functor_(x, u, VectorRef(d.residual_));
+    d.weighted_residual_.noalias() = weights_ * d.residual_;
+    d.value_ = Scalar(0.5) * d.residual_.dot(d.weighted_residual_);
+  }
+
+  /// @details This also sets the residual, but not the cost value.
+  void computeGradients(const ConstVectorRef &x, const ConstVectorRef &u,
+                        CostData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    const int ndx = this->ndx();
+    const int nvar = ndx + this->nu;
+    AD::seed(x, 0, nvar, d.xad);
+    AD::seed(u, ndx, nvar, d.uad);
+    functor_(ConstADVectorRef(d.xad), ConstADVectorRef(d.uad),
+             ADVectorRef(d.rad));
+    AD::extract(d.rad, nvar, d.residual_, d.jac_);
+    d.weighted_residual_.noalias() = weights_ * d.residual_;
+    d.grad_.noalias() = d.jac_.transpose() * d.weighted_residual_;
+  }
+
+  /// @pre computeGradients() was called at the same point.
+  void computeHessians(const ConstVectorRef &, const ConstVectorRef &,
+                       CostData &data) const override {
+    ALIGATOR_NOMALLOC_SCOPED;
+    Data &d = static_cast<Data &>(data);
+    d.JtW_buf.noalias() = d.jac_.transpose() * weights_;
+    d.hess_.noalias() = d.JtW_buf * d.jac_;
+  }
+
+  shared_ptr<CostData> createData() const override {
+    return std::make_shared<Data>(*this);
+  }
+};
+
+} // namespace autodiff
+} // namespace aligator
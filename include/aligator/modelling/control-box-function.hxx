@@ -12,6 +12,12 @@ ControlBoxFunctionTpl<Scalar>::ControlBoxFunctionTpl(const int ndx,
   if (umin.size() != umax.size()) {
     ALIGATOR_DOMAIN_ERROR("Size of umin and umax should be the same!");
   }
+  std::vector<int> cols(std::size_t(this->nr));
+  for (int i = 0; i < this->nr; i++)
+    cols[std::size_t(i)] = i % this->nu;
+  this->jac_structure_.x = JacobianBlockStructure::zero();
+  this->jac_structure_.u = JacobianBlockStructure::selection(cols);
+  this->jac_structure_.y = JacobianBlockStructure::zero();
 }
 
 template <typename Scalar>
@@ -0,0 +1,107 @@
+/// @file
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/modelling/costs/sum-of-costs.hpp"
+#include "aligator/modelling/costs/quad-residual-cost.hpp"
+#include "aligator/modelling/costs/quad-state-cost.hpp"
+#include "aligator/modelling/state-error.hpp"
+
+#include <array>
+#include <typeinfo>
+
+namespace aligator {
+
+template <typename Scalar> struct FusedCostStackDataTpl;
+
+/** @brief Weighted sum of cost components, where the Gauss-Newton quadratic
+ * residual costs are fused into stacked least-squares terms.
+ *
+ * @details The components of type QuadraticResidualCostTpl,
+ * QuadraticStateCostTpl or QuadraticControlCostTpl (exactly: classes derived
+ * from these are evaluated separately) which use the Gauss-Newton
+ * approximation are grouped by the arguments of their residual:
+ * state-only (unary functions), control-only (ControlErrorResidualTpl) and
+ * general residuals. Each group is a single term
+ * \f[
+ *    \frac{1}{2} r^\top W r, \quad
+ *    r = (r^{(k)})_k, \quad W = \mathrm{blkdiag}(w_k W^{(k)}),
+ * \f]
+ * with the stacked residual \f$r\f$ and Jacobian \f$J\f$, restricted to the
+ * columns of the arguments of the group. Its gradient and Gauss-Newton
+ * Hessian are computed with one product \f$J^\top W r\f$ and
+ * \f$J^\top W J\f$ each, into the state or control block only, instead of
+ * one product over all the variables and one dense addition per component.
+ * The other components are evaluated as in CostStackTpl.
+ * The components are grouped when the data is created: components added
+ * afterwards, or changes to their type of Hessian approximation, require new
+ * data. The sub-cost data of the fused components only hold the data of their
+ * residuals.
+ */
+template <typename _Scalar>
+struct FusedCostStackTpl : CostStackTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = CostStackTpl<Scalar>;
+  using CostData = CostDataAbstractTpl<Scalar>;
+  using Data = FusedCostStackDataTpl<Scalar>;
+
+  using Base::Base;
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                CostData &data) const;
+
+  void computeGradients(const ConstVectorRef &x, const ConstVectorRef &u,
+                        CostData &data) const;
+
+  void computeHessians(const ConstVectorRef &x, const ConstVectorRef &u,
+                       CostData &data) const;
+
+  shared_ptr<CostData> createData() const;
+
+  shared_ptr<CostData> createDataWithCache(
+      const shared_ptr<StageCacheDataTpl<Scalar>> &cache) const;
+};
+
+template <typename _Scalar>
+struct FusedCostStackDataTpl : CostStackDataTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = CostStackDataTpl<Scalar>;
+  using StageFunctionData = StageFunctionDataTpl<Scalar>;
+
+  /// Quadratic residual costs fused into one least-squares term.
+  struct ResidualGroup {
+    /// First column and number of columns of the Jacobians.
+    Eigen::Index col0, ncols;
+    /// Indices of the components.
+    std::vector<std::size_t> ids;
+    /// Residual data of the components.
+    std::vector<shared_ptr<StageFunctionData>> residual_data;
+    /// Offsets of the residuals in the stacked residual.
+    std::vector<Eigen::Index> offsets;
+    /// Stacked residual \f$r\f$, and \f$Wr\f$.
+    VectorXs residuals;
+    VectorXs weighted_residuals;
+    /// Stacked Jacobian \f$J\f$, and \f$WJ\f$.
+    MatrixXs jacobians;
+    MatrixXs weighted_jacobians;
+  };
+
+  /// Groups of state-only, control-only and general residuals.
+  std::array<ResidualGroup, 3> groups;
+  /// Indices of the components evaluated separately.
+  std::vector<std::size_t> other_ids;
+
+  FusedCostStackDataTpl(
+      const FusedCostStackTpl<Scalar> &obj,
+      const shared_ptr<StageCacheDataTpl<Scalar>> &cache = nullptr);
+};
+
+} // namespace aligator
+
+#include "aligator/modelling/costs/fused-cost-stack.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "./fused-cost-stack.txx"
+#endif
@@ -0,0 +1,176 @@
+/// @file
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/modelling/costs/fused-cost-stack.hpp"
+
+namespace aligator {
+
+template <typename Scalar>
+void FusedCostStackTpl<Scalar>::evaluate(const ConstVectorRef &x,
+                                         const ConstVectorRef &u,
+                                         CostData &data) const {
+  using QuadCost = QuadraticResidualCostTpl<Scalar>;
+  Data &d = static_cast<Data &>(data);
+  for (auto &g : d.groups) {
+    for (std::size_t k = 0; k < g.ids.size(); k++) {
+      const auto &c =
+          static_cast<const QuadCost &>(*this->components_[g.ids[k]]);
+      c.residual_->evaluate(x, u, x, *g.residual_data[k]);
+    }
+  }
+  for (std::size_t i : d.other_ids) {
+    this->components_[i]->evaluate(x, u, *d.sub_cost_data[i]);
+  }
+
+  ALIGATOR_NOMALLOC_SCOPED;
+  d.value_ = 0.;
+  for (auto &g : d.groups) {
+    for (std::size_t k = 0; k < g.ids.size(); k++) {
+      const std::size_t i = g.ids[k];
+      const auto &c = static_cast<const QuadCost &>(*this->components_[i]);
+      const Eigen::Index nr = g.offsets[k + 1] - g.offsets[k];
+      auto r = g.residuals.segment(g.offsets[k], nr);
+      r = g.residual_data[k]->value_;
+      g.weighted_residuals.segment(g.offsets[k], nr).noalias() =
+          this->weights_[i] * c.weights_ * r;
+    }
+    d.value_ += .5 * g.residuals.dot(g.weighted_residuals);
+  }
+  for (std::size_t i : d.other_ids) {
+    d.value_ += this->weights_[i] * d.sub_cost_data[i]->value_;
+  }
+}
+
+template <typename Scalar>
+void FusedCostStackTpl<Scalar>::computeGradients(const ConstVectorRef &x,
+                                                 const ConstVectorRef &u,
+                                                 CostData &data) const {
+  using QuadCost = QuadraticResidualCostTpl<Scalar>;
+  Data &d = static_cast<Data &>(data);
+  for (auto &g : d.groups) {
+    for (std::size_t k = 0; k < g.ids.size(); k++) {
+      const auto &c =
+          static_cast<const QuadCost &>(*this->components_[g.ids[k]]);
+      c.residual_->computeJacobians(x, u, x, *g.residual_data[k]);
+    }
+  }
+  for (std::size_t i : d.other_ids) {
+    this->components_[i]->computeGradients(x, u, *d.sub_cost_data[i]);
+  }
+
+  ALIGATOR_NOMALLOC_SCOPED;
+  d.grad_.setZero();
+  for (auto &g : d.groups) {
+    for (std::size_t k = 0; k < g.ids.size(); k++) {
+      const Eigen::Index nr = g.offsets[k + 1] - g.offsets[k];
+      g.jacobians.middleRows(g.offsets[k], nr) =
+          g.residual_data[k]->jac_buffer_.middleCols(g.col0, g.ncols);
+    }
+    // W r was computed by evaluate()
+    d.grad_.segment(g.col0, g.ncols).noalias() +=
+        g.jacobians.transpose() * g.weighted_residuals;
+  }
+  for (std::size_t i : d.other_ids) {
+    d.grad_.noalias() += this->weights_[i] * d.sub_cost_data[i]->grad_;
+  }
+}
+
+template <typename Scalar>
+void FusedCostStackTpl<Scalar>::computeHessians(const ConstVectorRef &x,
+                                                const ConstVectorRef &u,
+                                                CostData &data) const {
+  using QuadCost = QuadraticResidualCostTpl<Scalar>;
+  Data &d = static_cast<Data &>(data);
+  for (std::size_t i : d.other_ids) {
+    this->components_[i]->computeHessians(x, u, *d.sub_cost_data[i]);
+  }
+
+  ALIGATOR_NOMALLOC_SCOPED;
+  d.hess_.setZero();
+  for (auto &g : d.groups) {
+    for (std::size_t k = 0; k < g.ids.size(); k++) {
+      const std::size_t i = g.ids[k];
+      const auto &c = static_cast<const QuadCost &>(*this->components_[i]);
+      const Eigen::Index nr = g.offsets[k + 1] - g.offsets[k];
+      g.weighted_jacobians.middleRows(g.offsets[k], nr).noalias() =
+          this->weights_[i] * c.weights_ *
+          g.jacobians.middleRows(g.offsets[k], nr);
+    }
+    // J was stacked by computeGradients()
+    d.hess_.block(g.col0, g.col0, g.ncols, g.ncols).noalias() +=
+        g.jacobians.transpose() * g.weighted_jacobians;
+  }
+  for (std::size_t i : d.other_ids) {
+    d.hess_.noalias() += this->weights_[i] * d.sub_cost_data[i]->hess_;
+  }
+}
+
+template <typename Scalar>
+shared_ptr<CostDataAbstractTpl<Scalar>>
+FusedCostStackTpl<Scalar>::createData() const {
+  return std::make_shared<Data>(*this);
+}
+
+template <typename Scalar>
+shared_ptr<CostDataAbstractTpl<Scalar>>
+FusedCostStackTpl<Scalar>::createDataWithCache(
+    const shared_ptr<StageCacheDataTpl<Scalar>> &cache) const {
+  return std::make_shared<Data>(*this, cache);
+}
+
+template <typename Scalar>
+FusedCostStackDataTpl<Scalar>::FusedCostStackDataTpl(
+    const FusedCostStackTpl<Scalar> &obj,
+    const shared_ptr<StageCacheDataTpl<Scalar>> &cache)
+    : Base(obj, cache) {
+  using QuadCost = QuadraticResidualCostTpl<Scalar>;
+  using CompositeData = CompositeCostDataTpl<Scalar>;
+  const Eigen::Index ndx = obj.ndx();
+  const Eigen::Index nu = obj.nu;
+  ResidualGroup &state_group = groups[0];
+  ResidualGroup &control_group = groups[1];
+  ResidualGroup &full_group = groups[2];
+  state_group.col0 = 0;
+  state_group.ncols = ndx;
+  control_group.col0 = ndx;
+  control_group.ncols = nu;
+  full_group.col0 = 0;
+  full_group.ncols = ndx + nu;
+  for (ResidualGroup &g : groups)
+    g.offsets.push_back(0);
+
+  for (std::size_t i = 0; i < obj.size(); i++) {
+    // derived classes may override the evaluation, only fuse the exact types
+    const CostAbstractTpl<Scalar> &c = *obj.components_[i];
+    const std::type_info &type = typeid(c);
+    const bool is_quad = type == typeid(QuadCost) ||
+                         type == typeid(QuadraticStateCostTpl<Scalar>) ||
+                         type == typeid(QuadraticControlCostTpl<Scalar>);
+    auto cd = std::dynamic_pointer_cast<CompositeData>(this->sub_cost_data[i]);
+    if (!is_quad || !static_cast<const QuadCost &>(c).gauss_newton || !cd) {
+      other_ids.push_back(i);
+      continue;
+    }
+    const StageFunctionTpl<Scalar> *res =
+        static_cast<const QuadCost &>(c).residual_.get();
+    ResidualGroup *g = &full_group;
+    if (dynamic_cast<const UnaryFunctionTpl<Scalar> *>(res))
+      g = &state_group;
+    else if (dynamic_cast<const ControlErrorResidualTpl<Scalar> *>(res))
+      g = &control_group;
+    g->ids.push_back(i);
+    g->residual_data.push_back(cd->residual_data);
+    g->offsets.push_back(g->offsets.back() + res->nr);
+  }
+
+  for (ResidualGroup &g : groups) {
+    const Eigen::Index nr = g.offsets.back();
+    g.residuals.setZero(nr);
+    g.weighted_residuals.setZero(nr);
+    g.jacobians.setZero(nr, g.ncols);
+    g.weighted_jacobians.setZero(nr, g.ncols);
+  }
+}
+
+} // namespace aligator
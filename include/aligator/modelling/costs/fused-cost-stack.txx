@@ -0,0 +1,11 @@
+#pragma once
+
+#include "aligator/context.hpp"
+#include "aligator/modelling/costs/fused-cost-stack.hpp"
+
+namespace aligator {
+
+extern template struct FusedCostStackTpl<context::Scalar>;
+extern template struct FusedCostStackDataTpl<context::Scalar>;
+
+} // namespace aligator
@@ -38,6 +38,12 @@ template <typename Scalar> struct LogResidualCostTpl : CostAbstractTpl<Scalar> {
     return std::make_shared<Data>(this->ndx(), this->nu,
                                   residual_->createData());
   }
+
+  shared_ptr<CostDataAbstract> createDataWithCache(
+      const shared_ptr<StageCacheDataTpl<Scalar>> &cache) const {
+    return std::make_shared<Data>(this->ndx(), this->nu,
+                                  residual_->createDataWithCache(cache));
+  }
 };
 
 extern template struct LogResidualCostTpl<context::Scalar>;
@@ -44,6 +44,12 @@ struct QuadraticResidualCostTpl : CostAbstractTpl<_Scalar> {
     return std::make_shared<Data>(this->ndx(), this->nu,
                                   residual_->createData());
   }
+
+  shared_ptr<CostData> createDataWithCache(
+      const shared_ptr<StageCacheDataTpl<Scalar>> &cache) const {
+    return std::make_shared<Data>(this->ndx(), this->nu,
+                                  residual_->createDataWithCache(cache));
+  }
 };
 
 extern template struct QuadraticResidualCostTpl<context::Scalar>;
@@ -53,6 +53,9 @@ template <typename _Scalar> struct CostStackTpl : CostAbstractTpl<_Scalar> {
                        CostData &data) const;
 
   shared_ptr<CostData> createData() const;
+
+  shared_ptr<CostData>
+  createDataWithCache(const shared_ptr<StageCacheDataTpl<Scalar>> &cache) const;
 };
 
 namespace {
@@ -106,7 +109,9 @@ struct CostStackDataTpl : CostDataAbstractTpl<_Scalar> {
   using Scalar = _Scalar;
   using CostData = CostDataAbstractTpl<Scalar>;
   std::vector<shared_ptr<CostData>> sub_cost_data;
-  CostStackDataTpl(const CostStackTpl<Scalar> &obj);
+  CostStackDataTpl(
+      const CostStackTpl<Scalar> &obj,
+      const shared_ptr<StageCacheDataTpl<Scalar>> &cache = nullptr);
 };
 } // namespace aligator
 
@@ -95,13 +95,22 @@ CostStackTpl<Scalar>::createData() const {
   return std::make_shared<SumCostData>(*this);
 }
 
+template <typename Scalar>
+shared_ptr<CostDataAbstractTpl<Scalar>>
+CostStackTpl<Scalar>::createDataWithCache(
+    const shared_ptr<StageCacheDataTpl<Scalar>> &cache) const {
+  return std::make_shared<SumCostData>(*this, cache);
+}
+
 /* SumCostData */
 
 template <typename Scalar>
-CostStackDataTpl<Scalar>::CostStackDataTpl(const CostStackTpl<Scalar> &obj)
+CostStackDataTpl<Scalar>::CostStackDataTpl(
+    const CostStackTpl<Scalar> &obj,
+    const shared_ptr<StageCacheDataTpl<Scalar>> &cache)
     : CostData(obj.ndx(), obj.nu) {
   for (std::size_t i = 0; i < obj.size(); i++) {
-    sub_cost_data.push_back(obj.components_[i]->createData());
+    sub_cost_data.push_back(obj.components_[i]->createDataWithCache(cache));
   }
 }
 
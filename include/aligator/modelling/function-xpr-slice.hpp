@@ -25,7 +25,9 @@ struct FunctionSliceXprTpl : Base, detail::slice_impl_tpl<Base> {
 
   FunctionSliceXprTpl(shared_ptr<Base> func, std::vector<int> const &indices)
       : Base(func->ndx1, func->nu, func->ndx2, (int)indices.size()),
-        SliceImpl(func, indices) {}
+        SliceImpl(func, indices) {
+    this->jac_structure_ = func->jac_structure_.rows(indices);
+  }
 
   FunctionSliceXprTpl(shared_ptr<Base> func, const int idx)
       : FunctionSliceXprTpl(func, std::vector<int>{idx}) {}
@@ -67,7 +69,9 @@ struct FunctionSliceXprTpl<Scalar, UnaryFunctionTpl<Scalar>>
 
   FunctionSliceXprTpl(shared_ptr<Base> func, std::vector<int> const &indices)
       : Base(func->ndx1, func->nu, func->ndx2, (int)indices.size()),
-        SliceImpl(func, indices) {}
+        SliceImpl(func, indices) {
+    this->jac_structure_ = func->jac_structure_.rows(indices);
+  }
 
   FunctionSliceXprTpl(shared_ptr<Base> func, const int idx)
       : FunctionSliceXprTpl(func, std::vector<int>{idx}) {}
@@ -30,7 +30,9 @@ struct LinearDiscreteDynamicsTpl : ExplicitDynamicsModelTpl<_Scalar> {
 
   void forward(const ConstVectorRef &x, const ConstVectorRef &u,
                Data &data) const {
-    data.xnext_ = A_ * x + B_ * u + c_;
+    data.xnext_ = c_;
+    data.xnext_.noalias() += A_ * x;
+    data.xnext_.noalias() += B_ * u;
   }
 
   void dForward(const ConstVectorRef &, const ConstVectorRef &, Data &) const {}
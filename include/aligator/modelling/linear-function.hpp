@@ -5,6 +5,9 @@
 namespace aligator {
 /** @brief Linear function \f$f(x,u,y) = Ax + Bu + Cy + d\f$.
  *
+ * @details The zero blocks among \f$A, B, C\f$ are declared in the Jacobian
+ * structure (StageFunctionTpl::jac_structure_). The matrices can hence only
+ * be changed through setA(), setB() and setC(), which update it.
  */
 template <typename Scalar> struct LinearFunctionTpl : StageFunctionTpl<Scalar> {
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -12,25 +15,24 @@ template <typename Scalar> struct LinearFunctionTpl : StageFunctionTpl<Scalar> {
   using Base = StageFunctionTpl<Scalar>;
   using Data = StageFunctionDataTpl<Scalar>;
 
-  MatrixXs A_;
-  MatrixXs B_;
-  MatrixXs C_;
   VectorXs d_;
 
   LinearFunctionTpl(const int ndx, const int nu, const int ndx2, const int nr)
-      : Base(ndx, nu, ndx2, nr), A_(nr, ndx), B_(nr, nu), C_(nr, ndx2), d_(nr) {
+      : Base(ndx, nu, ndx2, nr), d_(nr), A_(nr, ndx), B_(nr, nu), C_(nr, ndx2) {
     A_.setZero();
     B_.setZero();
     C_.setZero();
     d_.setZero();
+    updateStructure();
   }
 
   LinearFunctionTpl(const ConstMatrixRef A, const ConstMatrixRef B,
                     const ConstMatrixRef C, const ConstVectorRef d)
-      : Base((int)A.cols(), (int)B.cols(), (int)C.cols(), (int)d.rows()), A_(A),
-        B_(B), C_(C), d_(d) {
+      : Base((int)A.cols(), (int)B.cols(), (int)C.cols(), (int)d.rows()),
+        d_(d), A_(A), B_(B), C_(C) {
     assert((A_.rows() == d_.rows()) && (B_.rows() == d_.rows()) &&
            (C_.rows() == d_.rows()) && "Number of rows not consistent.");
+    updateStructure();
   }
 
   /// @brief Constructor where \f$C = 0\f$ is assumed.
@@ -40,7 +42,10 @@ template <typename Scalar> struct LinearFunctionTpl : StageFunctionTpl<Scalar> {
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
                 const ConstVectorRef &y, Data &data) const {
-    data.value_ = A_ * x + B_ * u + C_ * y + d_;
+    data.value_ = d_;
+    data.value_.noalias() += A_ * x;
+    data.value_.noalias() += B_ * u;
+    data.value_.noalias() += C_ * y;
   }
 
   /**
@@ -65,6 +70,50 @@ template <typename Scalar> struct LinearFunctionTpl : StageFunctionTpl<Scalar> {
     data->Jy_ = C_;
     return data;
   }
+
+  ConstMatrixRef getA() const { return A_; }
+  ConstMatrixRef getB() const { return B_; }
+  ConstMatrixRef getC() const { return C_; }
+
+  void setA(const ConstMatrixRef &A) {
+    checkDims(A, this->ndx1, "A");
+    A_ = A;
+    updateStructure();
+  }
+  void setB(const ConstMatrixRef &B) {
+    checkDims(B, this->nu, "B");
+    B_ = B;
+    updateStructure();
+  }
+  void setC(const ConstMatrixRef &C) {
+    checkDims(C, this->ndx2, "C");
+    C_ = C;
+    updateStructure();
+  }
+
+protected:
+  MatrixXs A_;
+  MatrixXs B_;
+  MatrixXs C_;
+
+  void checkDims(const ConstMatrixRef &M, const int cols,
+                 const char *name) const {
+    if (M.rows() != this->nr || M.cols() != cols)
+      ALIGATOR_DOMAIN_ERROR(
+          fmt::format("Matrix {} should have dimensions ({:d}, {:d}).", name,
+                      this->nr, cols));
+  }
+
+  /// Declare the zero blocks of the Jacobians, and the others as dense.
+  void updateStructure() {
+    auto block = [](const MatrixXs &M) {
+      return M.isZero(Scalar(0)) ? JacobianBlockStructure::zero()
+                                 : JacobianBlockStructure::dense();
+    };
+    this->jac_structure_.x = block(A_);
+    this->jac_structure_.u = block(B_);
+    this->jac_structure_.y = block(C_);
+  }
 };
 
 } // namespace aligator
@@ -2,6 +2,7 @@
 
 #include "aligator/core/unary-function.hpp"
 #include "./fwd.hpp"
+#include "./kinematics-cache.hpp"
 
 #include <pinocchio/multibody/model.hpp>
 
@@ -48,6 +49,13 @@ public:
     return allocate_shared_eigen_aligned<Data>(this);
   }
 
+  shared_ptr<BaseData> createDataWithCache(
+      const shared_ptr<StageCacheDataTpl<Scalar>> &cache) const {
+    auto d = allocate_shared_eigen_aligned<Data>(this);
+    d->shared_kinematics_ = getSharedKinematics(cache, *pin_model_, false);
+    return d;
+  }
+
 protected:
   Vector3s p_ref_;
 };
@@ -60,9 +68,19 @@ struct CenterOfMassTranslationDataTpl : StageFunctionDataTpl<Scalar> {
 
   /// Pinocchio data object.
   PinData pin_data_;
+  /// Kinematics shared by the stage, used instead of @ref pin_data_ if set.
+  shared_ptr<KinematicsCacheDataTpl<Scalar>> shared_kinematics_;
+  /// Whether the last evaluation read the shared kinematics, which is only
+  /// the case if they were computed at the same state.
+  bool use_shared_kinematics_ = false;
 
   CenterOfMassTranslationDataTpl(
       const CenterOfMassTranslationResidualTpl<Scalar> *model);
+
+  /// The pinocchio data in use: the shared one, if valid.
+  pinocchio::DataTpl<Scalar> &pinData() {
+    return use_shared_kinematics_ ? shared_kinematics_->pin_data_ : pin_data_;
+  }
 };
 
 } // namespace aligator
@@ -2,6 +2,7 @@
 
 #include "aligator/modelling/multibody/center-of-mass-translation.hpp"
 #include <pinocchio/algorithm/center-of-mass.hpp>
+#include <pinocchio/algorithm/kinematics.hpp>
 
 namespace aligator {
 
@@ -10,8 +11,11 @@ void CenterOfMassTranslationResidualTpl<Scalar>::evaluate(
     const ConstVectorRef &x, BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::centerOfMass(model, pdata, x.head(model.nq));
+  d.use_shared_kinematics_ =
+      d.shared_kinematics_ && d.shared_kinematics_->isValidAt(x, false);
+  pinocchio::DataTpl<Scalar> &pdata = d.pinData();
+  if (!d.use_shared_kinematics_)
+    pinocchio::centerOfMass(model, pdata, x.head(model.nq));
 
   d.value_ = pdata.com[0] - p_ref_;
 }
@@ -21,8 +25,15 @@ void CenterOfMassTranslationResidualTpl<Scalar>::computeJacobians(
     const ConstVectorRef &x, BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::jacobianCenterOfMass(model, pdata, x.head(model.nq));
+  if (d.use_shared_kinematics_ && !d.shared_kinematics_->isValidAt(x, true)) {
+    // the stage did not differentiate its kinematics at x
+    d.use_shared_kinematics_ = false;
+    pinocchio::forwardKinematics(model, d.pin_data_, x.head(model.nq));
+  }
+  pinocchio::DataTpl<Scalar> &pdata = d.pinData();
+  // otherwise, the joint placements were computed by evaluate()
+  if (!d.use_shared_kinematics_)
+    pinocchio::jacobianCenterOfMass(model, pdata);
 
   d.Jx_.leftCols(model.nv) = pdata.Jcom;
 }
@@ -20,17 +20,16 @@ void CenterOfMassVelocityResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
 
 template <typename Scalar>
 void CenterOfMassVelocityResidualTpl<Scalar>::computeJacobians(
-    const ConstVectorRef &x, BaseData &data) const {
+    const ConstVectorRef &, BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
   pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
 
-  pinocchio::centerOfMass(model, pdata, x.head(model.nq),
-                          x.segment(model.nq, model.nv));
+  // the joint placements, center of mass and its velocity were computed by evaluate()
   pinocchio::getCenterOfMassVelocityDerivatives(model, pdata, d.fJf_);
   d.Jx_.leftCols(model.nv) = d.fJf_;
 
-  pinocchio::jacobianCenterOfMass(model, pdata, x.head(model.nq));
+  pinocchio::jacobianCenterOfMass(model, pdata);
   d.Jx_.rightCols(model.nv) = pdata.Jcom;
 }
 
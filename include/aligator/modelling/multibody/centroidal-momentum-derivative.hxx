@@ -18,7 +18,6 @@ void CentroidalMomentumDerivativeResidualTpl<Scalar>::evaluate(
   const auto q = x.head(pin_model_.nq);
   const auto v = x.tail(pin_model_.nv);
 
-  pinocchio::forwardKinematics(pin_model_, pdata, q);
   pinocchio::centerOfMass(pin_model_, pdata, q, v);
 
   d.value_.template head<3>() = mass_ * gravity_;
@@ -53,14 +52,13 @@ void CentroidalMomentumDerivativeResidualTpl<Scalar>::evaluate(
 
 template <typename Scalar>
 void CentroidalMomentumDerivativeResidualTpl<Scalar>::computeJacobians(
-    const ConstVectorRef &x, const ConstVectorRef &u, const ConstVectorRef &,
+    const ConstVectorRef &, const ConstVectorRef &u, const ConstVectorRef &,
     BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
 
-  const auto q = x.head(pin_model_.nq);
-
-  pinocchio::jacobianCenterOfMass(pin_model_, pdata, q);
+  // the joint placements were computed by evaluate()
+  pinocchio::jacobianCenterOfMass(pin_model_, pdata);
   pinocchio::computeJointJacobians(pin_model_, pdata);
 
   d.Jx_.setZero();
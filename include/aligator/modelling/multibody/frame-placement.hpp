@@ -2,6 +2,7 @@
 
 #include "aligator/core/unary-function.hpp"
 #include "./fwd.hpp"
+#include "./kinematics-cache.hpp"
 
 #include <pinocchio/multibody/model.hpp>
 #include <pinocchio/multibody/frame.hpp>
@@ -47,6 +48,13 @@ public:
     return allocate_shared_eigen_aligned<Data>(*this);
   }
 
+  shared_ptr<BaseData> createDataWithCache(
+      const shared_ptr<StageCacheDataTpl<Scalar>> &cache) const {
+    auto d = allocate_shared_eigen_aligned<Data>(*this);
+    d->shared_kinematics_ = getSharedKinematics(cache, *pin_model_, false);
+    return d;
+  }
+
 protected:
   SE3 p_ref_;
   SE3 p_ref_inverse_;
@@ -61,6 +69,11 @@ struct FramePlacementDataTpl : StageFunctionDataTpl<Scalar> {
 
   /// Pinocchio data object.
   PinData pin_data_;
+  /// Kinematics shared by the stage, used instead of @ref pin_data_ if set.
+  shared_ptr<KinematicsCacheDataTpl<Scalar>> shared_kinematics_;
+  /// Whether the last evaluation read the shared kinematics, which is only
+  /// the case if they were computed at the same state.
+  bool use_shared_kinematics_ = false;
   /// Placement error of the frame.
   SE3 rMf_;
   /// Jacobian of the error
@@ -69,6 +82,11 @@ struct FramePlacementDataTpl : StageFunctionDataTpl<Scalar> {
   typename math_types<Scalar>::Matrix6Xs fJf_;
 
   FramePlacementDataTpl(const FramePlacementResidualTpl<Scalar> &model);
+
+  /// The pinocchio data in use: the shared one, if valid.
+  PinData &pinData() {
+    return use_shared_kinematics_ ? shared_kinematics_->pin_data_ : pin_data_;
+  }
 };
 
 } // namespace aligator
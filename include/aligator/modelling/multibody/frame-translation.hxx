@@ -18,20 +18,30 @@ void FrameTranslationResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
                                                    BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::forwardKinematics(model, pdata, x.head(model.nq));
-  pinocchio::updateFramePlacement(model, pdata, pin_frame_id_);
+  d.use_shared_kinematics_ =
+      d.shared_kinematics_ && d.shared_kinematics_->isValidAt(x, false);
+  if (!d.use_shared_kinematics_) {
+    pinocchio::forwardKinematics(model, d.pin_data_, x.head(model.nq));
+    pinocchio::updateFramePlacement(model, d.pin_data_, pin_frame_id_);
+  }
+  pinocchio::DataTpl<Scalar> &pdata = d.pinData();
 
   d.value_ = pdata.oMf[pin_frame_id_].translation() - p_ref_;
 }
 
 template <typename Scalar>
 void FrameTranslationResidualTpl<Scalar>::computeJacobians(
-    const ConstVectorRef &, BaseData &data) const {
+    const ConstVectorRef &x, BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::computeJointJacobians(model, pdata);
+  if (d.use_shared_kinematics_ && !d.shared_kinematics_->isValidAt(x, true)) {
+    // the stage did not differentiate its kinematics at x
+    d.use_shared_kinematics_ = false;
+    pinocchio::forwardKinematics(model, d.pin_data_, x.head(model.nq));
+  }
+  pinocchio::DataTpl<Scalar> &pdata = d.pinData();
+  if (!d.use_shared_kinematics_)
+    pinocchio::computeJointJacobians(model, pdata);
   pinocchio::getFrameJacobian(model, pdata, pin_frame_id_,
                               pinocchio::LOCAL_WORLD_ALIGNED, d.fJf_);
   d.Jx_.leftCols(model.nv) = d.fJf_.topRows(3);
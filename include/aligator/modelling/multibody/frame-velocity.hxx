@@ -25,12 +25,16 @@ void FrameVelocityResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
                                                 BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  auto q = x.head(model.nq);
-  auto v = x.segment(model.nq, model.nv);
-  pinocchio::forwardKinematics(model, d.pin_data_, q, v);
-  pinocchio::updateFramePlacement(model, d.pin_data_, pin_frame_id_);
+  d.use_shared_kinematics_ =
+      d.shared_kinematics_ && d.shared_kinematics_->isValidAt(x, false);
+  if (!d.use_shared_kinematics_) {
+    auto q = x.head(model.nq);
+    auto v = x.segment(model.nq, model.nv);
+    pinocchio::forwardKinematics(model, d.pin_data_, q, v);
+    pinocchio::updateFramePlacement(model, d.pin_data_, pin_frame_id_);
+  }
   d.value_ =
-      (pinocchio::getFrameVelocity(model, d.pin_data_, pin_frame_id_, type_) -
+      (pinocchio::getFrameVelocity(model, d.pinData(), pin_frame_id_, type_) -
        vref_)
           .toVector();
 }
@@ -40,11 +44,17 @@ void FrameVelocityResidualTpl<Scalar>::computeJacobians(const ConstVectorRef &x,
                                                         BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  auto q = x.head(model.nq);
-  auto v = x.segment(model.nq, model.nv);
-  VectorXs a = VectorXs::Zero(model.nv);
-  pinocchio::computeForwardKinematicsDerivatives(model, d.pin_data_, q, v, a);
-  pinocchio::getFrameVelocityDerivatives(model, d.pin_data_, pin_frame_id_,
+  if (d.use_shared_kinematics_ && !d.shared_kinematics_->isValidAt(x, true))
+    // the stage did not differentiate its kinematics at x
+    d.use_shared_kinematics_ = false;
+  if (!d.use_shared_kinematics_) {
+    auto q = x.head(model.nq);
+    auto v = x.segment(model.nq, model.nv);
+    VectorXs a = VectorXs::Zero(model.nv);
+    pinocchio::computeForwardKinematicsDerivatives(model, d.pin_data_, q, v,
+                                                   a);
+  }
+  pinocchio::getFrameVelocityDerivatives(model, d.pinData(), pin_frame_id_,
                                          type_, d.Jx_.leftCols(model.nv),
                                          d.Jx_.rightCols(model.nv));
 }
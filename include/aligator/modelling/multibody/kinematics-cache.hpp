@@ -0,0 +1,123 @@
+/// @file
+/// @brief Forward kinematics shared by the multibody functions of a stage.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/core/stage-cache.hpp"
+
+#include <pinocchio/multibody/model.hpp>
+#include <pinocchio/multibody/data.hpp>
+
+namespace aligator {
+
+template <typename Scalar> struct KinematicsCacheDataTpl;
+
+/** @brief    Forward kinematics of a robot, computed once per stage and shared
+ *            by its multibody residuals.
+ *
+ *  @details  Set an instance as the StageModelTpl::cache_model_ of a stage:
+ *            the frame residuals (FramePlacementResidualTpl,
+ *            FrameTranslationResidualTpl, FrameVelocityResidualTpl) and
+ *            CenterOfMassTranslationResidualTpl of this stage which hold the
+ *            same model (the same pointer) then read the shared pinocchio
+ *            data instead of running the forward kinematics and computing the
+ *            joint Jacobians themselves. FlyHighResidualTpl holds a copy of
+ *            the model, and does not use the cache.
+ *            The state is assumed to be \f$x = (q, v)\f$, as in
+ *            proxsuite::nlp::MultibodyPhaseSpace.
+ *            The evaluation computes the placements of all joints and frames,
+ *            and the center of mass. The derivatives are the joint Jacobians
+ *            and the Jacobian of the center of mass, and the derivatives of
+ *            the joint velocities if @ref with_velocity_ is true.
+ *  @note     The residuals can only share the kinematics if they are evaluated
+ *            at the state of the stage: the data records the state of the last
+ *            evaluation, and a residual evaluated (or differentiated) at any
+ *            other state, e.g. outside StageModelTpl::evaluate(), falls back
+ *            to its own pinocchio data.
+ */
+template <typename _Scalar>
+struct KinematicsCacheModelTpl : StageCacheModelTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = StageCacheModelTpl<Scalar>;
+  using BaseData = typename Base::Data;
+  using Data = KinematicsCacheDataTpl<Scalar>;
+  using Model = pinocchio::ModelTpl<Scalar>;
+
+  shared_ptr<Model> pin_model_;
+  /// Whether to compute the velocities, and their derivatives.
+  bool with_velocity_;
+
+  KinematicsCacheModelTpl(const shared_ptr<Model> &model,
+                          bool with_velocity = false)
+      : pin_model_(model), with_velocity_(with_velocity) {}
+
+  void evaluate(const ConstVectorRef &x, BaseData &data) const;
+
+  void computeDerivatives(const ConstVectorRef &x, BaseData &data) const;
+
+  shared_ptr<BaseData> createData() const {
+    return allocate_shared_eigen_aligned<Data>(*this);
+  }
+};
+
+template <typename Scalar>
+struct KinematicsCacheDataTpl : StageCacheDataTpl<Scalar> {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Model = pinocchio::ModelTpl<Scalar>;
+  using PinData = pinocchio::DataTpl<Scalar>;
+
+  /// Model the data was created for.
+  shared_ptr<Model> pin_model_;
+  bool with_velocity_;
+  /// Pinocchio data object, shared by the residuals.
+  PinData pin_data_;
+  /// Zero joint acceleration.
+  VectorXs a_zero_;
+  /// State of the last evaluation.
+  VectorXs x_;
+  /// Whether the derivatives were computed at @ref x_.
+  bool has_derivatives_ = false;
+
+  KinematicsCacheDataTpl(const KinematicsCacheModelTpl<Scalar> &model);
+
+  /// @brief Whether the data holds the kinematics of @p model, with the
+  /// velocities if @p needs_velocity is true.
+  /// @details The models are compared by address: the residuals must be built
+  /// from the same model as the cache.
+  bool isCompatible(const Model &model, bool needs_velocity) const {
+    if (needs_velocity && !with_velocity_)
+      return false;
+    return pin_model_.get() == &model;
+  }
+
+  /// @brief Whether the data holds the kinematics at state @p x, and their
+  /// derivatives if @p derivatives is true.
+  bool isValidAt(const ConstVectorRef &x, bool derivatives) const {
+    if (derivatives && !has_derivatives_)
+      return false;
+    return x.size() == x_.size() && x == x_;
+  }
+};
+
+/// @brief The kinematics of @p model held in the data @p cache shared by the
+/// functions of a stage, if any; nullptr otherwise.
+template <typename Scalar>
+shared_ptr<KinematicsCacheDataTpl<Scalar>>
+getSharedKinematics(const shared_ptr<StageCacheDataTpl<Scalar>> &cache,
+                    const pinocchio::ModelTpl<Scalar> &model,
+                    bool needs_velocity) {
+  auto kin = std::dynamic_pointer_cast<KinematicsCacheDataTpl<Scalar>>(cache);
+  if (kin && kin->isCompatible(model, needs_velocity))
+    return kin;
+  return nullptr;
+}
+
+} // namespace aligator
+
+#include "aligator/modelling/multibody/kinematics-cache.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "./kinematics-cache.txx"
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "aligator/modelling/multibody/kinematics-cache.hpp"
+#include <pinocchio/algorithm/center-of-mass.hpp>
+#include <pinocchio/algorithm/frames.hpp>
+#include <pinocchio/algorithm/jacobian.hpp>
+#include <pinocchio/algorithm/kinematics.hpp>
+#include <pinocchio/algorithm/kinematics-derivatives.hpp>
+
+namespace aligator {
+
+template <typename Scalar>
+void KinematicsCacheModelTpl<Scalar>::evaluate(const ConstVectorRef &x,
+                                               BaseData &data) const {
+  Data &d = static_cast<Data &>(data);
+  const Model &model = *pin_model_;
+  auto q = x.head(model.nq);
+  if (with_velocity_) {
+    auto v = x.segment(model.nq, model.nv);
+    pinocchio::forwardKinematics(model, d.pin_data_, q, v);
+  } else {
+    pinocchio::forwardKinematics(model, d.pin_data_, q);
+  }
+  pinocchio::updateFramePlacements(model, d.pin_data_);
+  pinocchio::centerOfMass(model, d.pin_data_, pinocchio::POSITION);
+  d.x_ = x;
+  d.has_derivatives_ = false;
+}
+
+template <typename Scalar>
+void KinematicsCacheModelTpl<Scalar>::computeDerivatives(
+    const ConstVectorRef &x, BaseData &data) const {
+  Data &d = static_cast<Data &>(data);
+  const Model &model = *pin_model_;
+  if (with_velocity_) {
+    auto q = x.head(model.nq);
+    auto v = x.segment(model.nq, model.nv);
+    // also computes the joint Jacobians
+    pinocchio::computeForwardKinematicsDerivatives(model, d.pin_data_, q, v,
+                                                   d.a_zero_);
+  } else {
+    pinocchio::computeJointJacobians(model, d.pin_data_);
+  }
+  pinocchio::jacobianCenterOfMass(model, d.pin_data_);
+  d.has_derivatives_ = true;
+}
+
+template <typename Scalar>
+KinematicsCacheDataTpl<Scalar>::KinematicsCacheDataTpl(
+    const KinematicsCacheModelTpl<Scalar> &model)
+    : pin_model_(model.pin_model_), with_velocity_(model.with_velocity_),
+      pin_data_(*model.pin_model_), a_zero_(model.pin_model_->nv),
+      x_(model.pin_model_->nq + model.pin_model_->nv) {
+  a_zero_.setZero();
+  // not a valid state until the first evaluation
+  x_.setConstant(std::numeric_limits<Scalar>::quiet_NaN());
+}
+
+} // namespace aligator
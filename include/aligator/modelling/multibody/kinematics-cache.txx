@@ -0,0 +1,11 @@
+#pragma once
+
+#include "./kinematics-cache.hpp"
+#include "aligator/context.hpp"
+
+namespace aligator {
+
+extern template struct KinematicsCacheModelTpl<context::Scalar>;
+extern template struct KinematicsCacheDataTpl<context::Scalar>;
+
+} // namespace aligator
@@ -36,6 +36,9 @@ struct StateOrControlErrorResidual<_Scalar, 0> : UnaryFunctionTpl<_Scalar> {
       ALIGATOR_RUNTIME_ERROR(
           "Target parameter invalid (not a viable element of state manifold.)");
     }
+    // on a vector space, the Jacobian of x - target is the identity
+    if (std::dynamic_pointer_cast<VectorSpace>(space_))
+      this->jac_structure_.x = JacobianBlockStructure::diagonal();
   }
 
   void evaluate(const ConstVectorRef &x, Data &data) const override {
@@ -74,6 +77,7 @@ struct StateOrControlErrorResidual : StageFunctionTpl<_Scalar> {
       : Base(ndx, uspace->nx(), uspace->ndx()), space_(uspace),
         target_(target) {
     check_target_viable();
+    declare_jacobian_structure();
   }
 
   /// @brief Constructor using state space and control space dimensions,
@@ -88,6 +92,7 @@ struct StateOrControlErrorResidual : StageFunctionTpl<_Scalar> {
       : Base(ndx, nu, ndx, nu), space_(std::make_shared<VectorSpace>(nu)),
         target_(space_->neutral()) {
     check_target_viable();
+    declare_jacobian_structure();
   }
 
   void evaluate(const ConstVectorRef &, const ConstVectorRef &u,
@@ -125,6 +130,16 @@ private:
           "Target parameter invalid (not a viable element of state manifold.)");
     }
   }
+
+  inline void declare_jacobian_structure() {
+    JacobianStructure &s = this->jac_structure_;
+    s.x = JacobianBlockStructure::zero();
+    (arg == 1 ? s.y : s.u) = JacobianBlockStructure::zero();
+    // on a vector space, the Jacobian is the identity: declare it diagonal,
+    // so that its values are still read
+    if (std::dynamic_pointer_cast<VectorSpace>(space_))
+      (arg == 1 ? s.u : s.y) = JacobianBlockStructure::diagonal();
+  }
 };
 
 template <typename Scalar, unsigned int arg>
@@ -134,6 +149,7 @@ StateOrControlErrorResidual<Scalar, arg>::StateOrControlErrorResidual(
     const ConstVectorRef &target)
     : Base(xspace->ndx(), nu, xspace->ndx()), space_(xspace), target_(target) {
   check_target_viable();
+  declare_jacobian_structure();
 }
 } // namespace detail
 
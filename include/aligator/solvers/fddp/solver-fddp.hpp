@@ -75,15 +75,27 @@ template <typename Scalar> struct SolverFDDPTpl {
 
   Logger logger{};
 
-  void setNumThreads(const std::size_t num_threads) {
+  /// Threading backend for evaluating the problem. Takes effect on the next
+  /// call to setup().
+  ThreadingBackend threading_backend_ = ThreadingBackend::OPENMP;
+  /// Pin the worker threads of the ThreadingBackend::THREAD_POOL backend to
+  /// CPU cores (Linux only). Takes effect on the next call to setup().
+  bool pin_threads_ = false;
+
+  /// @brief Set the number of threads, and whether to pin the worker threads
+  /// of the thread pool (see pin_threads_).
+  void setNumThreads(const std::size_t num_threads,
+                     const bool pin_threads = false) {
     num_threads_ = num_threads;
-    omp::set_default_options(num_threads);
+    pin_threads_ = pin_threads;
   }
   std::size_t getNumThreads() const { return num_threads_; }
 
 protected:
   /// Number of threads to use when evaluating the problem or its derivatives.
   std::size_t num_threads_;
+  /// Persistent worker threads, when using ThreadingBackend::THREAD_POOL.
+  unique_ptr<ThreadPool> thread_pool_;
   /// Callbacks
   CallbackMap callbacks_;
 
@@ -196,6 +208,19 @@ public:
   bool run(const Problem &problem, const std::vector<VectorXs> &xs_init = {},
            const std::vector<VectorXs> &us_init = {});
 
+  /// @brief Receding-horizon update: drop the first stage of @p problem,
+  /// append @p stage at the end of the horizon, shift the solver's data
+  /// accordingly and resume solving from the shifted solution.
+  /// @details See SolverProxDDPTpl::shiftAndResume(). The regularization
+  /// parameter is kept from the previous solve.
+  bool shiftAndResume(Problem &problem, const shared_ptr<StageModel> &stage);
+
+protected:
+  /// @brief Main loop of the algorithm, starting from the current results.
+  bool iterate(const Problem &problem);
+
+public:
+
   static const ExplicitDynamicsData &
   stage_get_dynamics_data(const StageDataTpl<Scalar> &data) {
     const DynamicsDataTpl<Scalar> &dd = *data.dynamics_data;
@@ -23,6 +23,13 @@ void SolverFDDPTpl<Scalar>::setup(const Problem &problem) {
   problem.checkIntegrity();
   results_ = Results(problem);
   workspace_ = Workspace(problem);
+  if (threading_backend_ == ThreadingBackend::THREAD_POOL && num_threads_ > 1) {
+    if (!thread_pool_ || thread_pool_->numThreads() != num_threads_ ||
+        thread_pool_->pinsThreads() != pin_threads_)
+      thread_pool_ = std::make_unique<ThreadPool>(num_threads_, pin_threads_);
+  } else {
+    thread_pool_.reset();
+  }
   // check if there are any constraints other than dynamics and throw a warning
   std::vector<std::size_t> idx_where_constraints;
   for (std::size_t i = 0; i < problem.numSteps(); i++) {
@@ -95,7 +102,7 @@ Scalar SolverFDDPTpl<Scalar>::forwardPass(const Problem &problem,
   CostData &cd_term = *prob_data.term_cost_data;
 
   ALIGATOR_NOMALLOC_END;
-  problem.term_cost_->evaluate(xs_try.back(), us_try.back(), cd_term);
+  problem.term_cost_->evaluate(xs_try.back(), problem.unone_, cd_term);
   ALIGATOR_NOMALLOC_BEGIN;
 
   traj_cost_ += cd_term.value_;
@@ -164,13 +171,12 @@ Scalar SolverFDDPTpl<Scalar>::computeInfeasibility(const Problem &problem) {
   const auto &space = problem.stages_[0]->xspace_;
   space->difference(xs[0], problem.getInitState(), fs[0]);
 
-#pragma omp parallel for num_threads(num_threads_)
-  for (std::size_t i = 0; i < nsteps; i++) {
+  parallel_for(thread_pool_.get(), num_threads_, nsteps, [&](std::size_t i) {
     const StageModel &sm = *problem.stages_[i];
     const auto &sd = *pd.stage_data[i];
     const ExplicitDynamicsData &dd = stage_get_dynamics_data(sd);
     sm.xspace_->difference(xs[i + 1], dd.xnext_, fs[i + 1]);
-  }
+  });
   Scalar res = math::infty_norm(fs);
   ALIGATOR_NOMALLOC_END;
   return res;
@@ -303,6 +309,7 @@ bool SolverFDDPTpl<Scalar>::run(const Problem &problem,
   results_.conv = false;
 
   logger.active = verbose_ > 0;
+  logger.reset();
   logger.addColumn(BASIC_KEYS[0]);
   logger.addColumn(BASIC_KEYS[1]);
   logger.addColumn(BASIC_KEYS[3]);
@@ -313,6 +320,68 @@ bool SolverFDDPTpl<Scalar>::run(const Problem &problem,
   logger.addColumn(BASIC_KEYS[8]);
   logger.printHeadline();
 
+  return iterate(problem);
+}
+
+template <typename Scalar>
+bool SolverFDDPTpl<Scalar>::shiftAndResume(
+    Problem &problem, const shared_ptr<StageModel> &new_stage) {
+  // copy the pointer, which may refer to an element of problem.stages_
+  const shared_ptr<StageModel> stage = new_stage;
+  if (!results_.isInitialized() || !workspace_.isInitialized()) {
+    ALIGATOR_RUNTIME_ERROR(
+        "Either results or workspace not allocated. Call setup() first!");
+  }
+  const std::size_t N = workspace_.nsteps;
+  if (problem.numSteps() != N || N == 0) {
+    ALIGATOR_RUNTIME_ERROR(
+        "Problem does not match the allocated workspace, or is empty.");
+  }
+  if (stage == nullptr)
+    ALIGATOR_RUNTIME_ERROR("Input stage is null.");
+
+  const shared_ptr<StageModel> dropped = problem.stages_[0];
+  if (!stage_dims_match(*dropped, *stage)) {
+    ALIGATOR_RUNTIME_ERROR(
+        "New stage does not have the same dimensions as the stage it "
+        "replaces. Call setup() again instead.");
+  }
+
+  problem.replaceStageCircular(stage);
+  if (stage == dropped) {
+    workspace_.cycleLeft();
+  } else {
+    // same as cycleAppend(), but rotating the solver-specific buffers too
+    auto &stage_data = workspace_.problem_data.stage_data;
+    stage_data.emplace_back(stage->createData());
+    workspace_.cycleLeft();
+    stage_data.pop_back();
+  }
+
+  // warm-start the new last stage by repeating the end of the previous
+  // solution
+  results_.cycleLeft();
+  if (results_.xs[N - 1].size() == stage->xspace_next().nx())
+    results_.xs[N] = results_.xs[N - 1];
+  else
+    set_neutral_element(stage->xspace_next(), results_.xs[N]);
+  if (N > 1 && results_.us[N - 1].size() == results_.us[N - 2].size())
+    results_.us[N - 1] = results_.us[N - 2];
+
+  if (force_initial_condition_) {
+    results_.xs[0] = problem.getInitState();
+    workspace_.trial_xs[0] = results_.xs[0];
+  }
+
+  logger.active = verbose_ > 0;
+  logger.printHeadline();
+
+  return iterate(problem);
+}
+
+template <typename Scalar>
+bool SolverFDDPTpl<Scalar>::iterate(const Problem &problem) {
+  results_.conv = false;
   // in Crocoddyl, linesearch xs is primed to use problem x0
 
   const auto linesearch_fun = [&](const Scalar alpha) {
@@ -329,13 +398,20 @@ bool SolverFDDPTpl<Scalar>::run(const Problem &problem,
   };
 
   std::size_t &iter = results_.num_iters;
-  results_.traj_cost_ = problem.evaluate(results_.xs, results_.us,
-                                         workspace_.problem_data, num_threads_);
+  results_.traj_cost_ =
+      thread_pool_ ? problem.evaluate(results_.xs, results_.us,
+                                      workspace_.problem_data, *thread_pool_)
+                   : problem.evaluate(results_.xs, results_.us,
+                                      workspace_.problem_data, num_threads_);
 
   for (iter = 0; iter < max_iters; ++iter) {
 
-    problem.computeDerivatives(results_.xs, results_.us,
-                               workspace_.problem_data, num_threads_);
+    if (thread_pool_)
+      problem.computeDerivatives(results_.xs, results_.us,
+                                 workspace_.problem_data, *thread_pool_);
+    else
+      problem.computeDerivatives(results_.xs, results_.us,
+                                 workspace_.problem_data, num_threads_);
     results_.prim_infeas = computeInfeasibility(problem);
     ALIGATOR_RAISE_IF_NAN(results_.prim_infeas);
 
@@ -374,8 +450,9 @@ bool SolverFDDPTpl<Scalar>::run(const Problem &problem,
     logger.addEntry("merit", phi_new);
     logger.addEntry("ΔM", phi_new - phi0);
 
-    results_.xs = workspace_.trial_xs;
-    results_.us = workspace_.trial_us;
+    // the trial buffers are overwritten by the next forward pass
+    results_.xs.swap(workspace_.trial_xs);
+    results_.us.swap(workspace_.trial_us);
     if (std::abs(d1_phi) < th_grad_) {
       results_.conv = true;
       break;
@@ -71,7 +71,8 @@ template <typename Scalar> void WorkspaceFDDPTpl<Scalar>::cycleLeft() {
   rotate_vec_left(llts_);
   rotate_vec_left(JtH_temp_);
 
-  rotate_vec_left(value_params);
+  // the terminal value function stays in place
+  rotate_vec_left(value_params, 0, 1);
   rotate_vec_left(q_params);
 }
 
@@ -0,0 +1,105 @@
+/// @file batch-solver.hpp
+/// @brief Solve batches of independent trajectory optimization problems.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "solver-proxddp.hpp"
+
+namespace aligator {
+
+/// @brief A front-end solving a batch of independent problems concurrently
+/// using a pool of SolverProxDDPTpl instances.
+///
+/// @details Each problem in the batch gets its own solver, workspace and
+/// results. Problems are dispatched dynamically over the worker threads (each
+/// worker picks up the next unsolved problem once it is done with its current
+/// one), so that problems with heterogeneous solve times are balanced across
+/// the threads of a ThreadPool. Parallelism is across problems: the parallel
+/// loops of each solver in the batch run serially.
+template <typename _Scalar> struct SolverProxDDPBatchTpl {
+public:
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Solver = SolverProxDDPTpl<Scalar>;
+  using Problem = TrajOptProblemTpl<Scalar>;
+  using Results = ResultsTpl<Scalar>;
+  using Workspace = WorkspaceTpl<Scalar>;
+
+  /// Whether to warm-start each solver from the last solution it computed.
+  bool warm_start_ = true;
+
+  /// @brief Create a batch of @p batch_size solvers, all sharing the same
+  /// settings.
+  SolverProxDDPBatchTpl(const std::size_t batch_size, const Scalar tol = 1e-6,
+                        const Scalar mu_init = 0.01, const Scalar rho_init = 0.,
+                        const std::size_t max_iters = 1000,
+                        VerboseLevel verbose = VerboseLevel::QUIET,
+                        HessianApprox hess_approx = HessianApprox::GAUSS_NEWTON);
+
+  std::size_t size() const { return solvers_.size(); }
+
+  /// @brief Get the i-th solver in the batch, e.g. to change its settings.
+  Solver &getSolver(std::size_t i) { return *solvers_[i]; }
+  const Solver &getSolver(std::size_t i) const { return *solvers_[i]; }
+
+  /// @brief Get the results of the i-th problem.
+  const Results &getResults(std::size_t i) const {
+    return solvers_[i]->results_;
+  }
+
+  /// @brief Get the i-th problem in the batch.
+  const Problem &getProblem(std::size_t i) const { return *problems_[i]; }
+
+  /// @brief Set the number of worker threads used to dispatch the problems.
+  /// @param pin_threads  Pin the worker threads to CPU cores (Linux only).
+  void setNumThreads(const std::size_t num_threads,
+                     const bool pin_threads = false) {
+    num_threads_ = std::max(num_threads, std::size_t(1));
+    if (num_threads_ > 1)
+      thread_pool_ = std::make_unique<ThreadPool>(num_threads_, pin_threads);
+    else
+      thread_pool_.reset();
+  }
+  std::size_t getNumThreads() const { return num_threads_; }
+  bool getPinThreads() const {
+    return thread_pool_ && thread_pool_->pinsThreads();
+  }
+
+  /// @brief Allocate each solver in the batch for the corresponding problem.
+  /// @details The number of problems must match the batch size.
+  void setup(const std::vector<shared_ptr<Problem>> &problems);
+
+  /// @brief Allocate the batch for copies of a single @p problem, which only
+  /// differ by their initial state (see run(const std::vector<VectorXs>&)).
+  /// @details The copies share the stages and terminal cost of @p problem,
+  /// but own their initial condition.
+  /// @pre The initial condition of @p problem is a StateErrorResidualTpl.
+  void setup(const Problem &problem);
+
+  /// @brief Solve all the problems in the batch.
+  /// @returns Whether all the solvers converged.
+  bool run();
+
+  /// @brief Set the initial state of each problem in the batch, then solve.
+  /// @param x0s  Initial states, one per problem in the batch.
+  bool run(const std::vector<VectorXs> &x0s);
+
+protected:
+  /// Solvers, one per problem. These are stored by pointer since the solvers
+  /// keep internal references to their own data after setup().
+  std::vector<unique_ptr<Solver>> solvers_;
+  /// Problems solved by each solver.
+  std::vector<shared_ptr<Problem>> problems_;
+  /// Number of worker threads.
+  std::size_t num_threads_ = 1;
+  /// Worker threads, if there is more than one.
+  unique_ptr<ThreadPool> thread_pool_;
+};
+
+} // namespace aligator
+
+#include "batch-solver.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "batch-solver.txx"
+#endif
@@ -0,0 +1,126 @@
+/// @file batch-solver.hxx
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "batch-solver.hpp"
+#include "aligator/threads.hpp"
+
+#include <exception>
+#include <tracy/Tracy.hpp>
+
+namespace aligator {
+
+template <typename Scalar>
+SolverProxDDPBatchTpl<Scalar>::SolverProxDDPBatchTpl(
+    const std::size_t batch_size, const Scalar tol, const Scalar mu_init,
+    const Scalar rho_init, const std::size_t max_iters, VerboseLevel verbose,
+    HessianApprox hess_approx) {
+  solvers_.reserve(batch_size);
+  for (std::size_t i = 0; i < batch_size; i++) {
+    solvers_.emplace_back(std::make_unique<Solver>(
+        tol, mu_init, rho_init, max_iters, verbose, hess_approx));
+  }
+}
+
+template <typename Scalar>
+void SolverProxDDPBatchTpl<Scalar>::setup(
+    const std::vector<shared_ptr<Problem>> &problems) {
+  ZoneScoped;
+  if (problems.size() != solvers_.size()) {
+    ALIGATOR_RUNTIME_ERROR(
+        fmt::format("Number of problems ({:d}) does not match batch size "
+                    "({:d}).",
+                    problems.size(), solvers_.size()));
+  }
+  problems_ = problems;
+  for (std::size_t i = 0; i < solvers_.size(); i++) {
+    if (!problems_[i]) {
+      ALIGATOR_RUNTIME_ERROR(fmt::format("Problem {:d} is null.", i));
+    }
+    solvers_[i]->setup(*problems_[i]);
+  }
+}
+
+template <typename Scalar>
+void SolverProxDDPBatchTpl<Scalar>::setup(const Problem &problem) {
+  if (!problem.initCondIsStateError()) {
+    ALIGATOR_RUNTIME_ERROR(
+        "Initial condition is not a StateErrorResidual: cannot create copies "
+        "of the problem with distinct initial states.");
+  }
+  std::vector<shared_ptr<Problem>> problems;
+  problems.reserve(solvers_.size());
+  for (std::size_t i = 0; i < solvers_.size(); i++) {
+    // do not copy the problem: copies would share the initial condition
+    auto p = std::make_shared<Problem>(problem.getInitState(), problem.stages_,
+                                       problem.term_cost_);
+    p->term_cstrs_ = problem.term_cstrs_;
+    problems.push_back(std::move(p));
+  }
+  setup(problems);
+}
+
+template <typename Scalar>
+bool SolverProxDDPBatchTpl<Scalar>::run(const std::vector<VectorXs> &x0s) {
+  if (x0s.size() != solvers_.size()) {
+    ALIGATOR_RUNTIME_ERROR(
+        fmt::format("Number of initial states ({:d}) does not match batch "
+                    "size ({:d}).",
+                    x0s.size(), solvers_.size()));
+  }
+  for (std::size_t i = 0; i < problems_.size(); i++) {
+    problems_[i]->setInitState(x0s[i]);
+  }
+  return run();
+}
+
+template <typename Scalar> bool SolverProxDDPBatchTpl<Scalar>::run() {
+  ZoneScoped;
+  const std::size_t batch_size = solvers_.size();
+  if (problems_.size() != batch_size) {
+    ALIGATOR_RUNTIME_ERROR("Batch was not set up: call setup() first.");
+  }
+
+  std::vector<std::exception_ptr> errors(batch_size);
+  // catch the exceptions per problem, and rethrow the one of the first failed
+  // problem afterwards.
+  auto solve_one = [&](std::size_t i) {
+    Solver &solver = *solvers_[i];
+    const Problem &problem = *problems_[i];
+    try {
+      if (warm_start_) {
+        Results &res = solver.results_;
+        // the initial state may have changed since the last solve
+        if (solver.force_initial_condition_ && problem.initCondIsStateError())
+          res.xs[0] = problem.getInitState();
+        solver.run(problem, res.xs, res.us, res.lams);
+      } else {
+        solver.run(problem);
+      }
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+
+  // idle threads grab the next problem, which balances problems with
+  // different solve times.
+  if (thread_pool_) {
+    parallel_for(thread_pool_.get(), num_threads_, batch_size, solve_one);
+  } else {
+    for (std::size_t i = 0; i < batch_size; i++)
+      solve_one(i);
+  }
+
+  for (std::size_t i = 0; i < batch_size; i++) {
+    if (errors[i])
+      std::rethrow_exception(errors[i]);
+  }
+
+  bool conv = true;
+  for (std::size_t i = 0; i < batch_size; i++) {
+    conv &= solvers_[i]->results_.conv;
+  }
+  return conv;
+}
+
+} // namespace aligator
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "aligator/context.hpp"
+#include "batch-solver.hpp"
+
+namespace aligator {
+
+extern template struct SolverProxDDPBatchTpl<context::Scalar>;
+
+} // namespace aligator
@@ -35,6 +35,13 @@ template <typename _Scalar> struct ResultsTpl : ResultsBaseTpl<_Scalar> {
   /// @brief    Create the results struct from a problem (TrajOptProblemTpl)
   /// instance.
   explicit ResultsTpl(const TrajOptProblemTpl<Scalar> &problem);
+
+  /// @copydoc ResultsBaseTpl::cycleLeft()
+  void cycleLeft() {
+    Base::cycleLeft();
+    rotate_vec_left(lams, 1);
+    rotate_vec_left(vs, 0, 1);
+  }
 };
 
 template <typename Scalar>
@@ -32,7 +32,13 @@ template <typename Scalar> struct DefaultScaling {
   static constexpr Scalar scale = 10.;
 };
 
-enum class LQSolverChoice { SERIAL, PARALLEL, STAGEDENSE };
+/// @brief Solver for the LQ subproblem.
+/// @details `CHOLMOD` solves the sparse KKT system of the subproblem with
+/// CHOLMOD, reusing its symbolic analysis across iterations. It requires
+/// Aligator to be built with CHOLMOD support. `BANDED` factorizes the KKT
+/// matrix as a band matrix (see gar::BandedLDLTSolver). Neither computes
+/// feedback gains, so they only support the linear rollout.
+enum class LQSolverChoice { SERIAL, PARALLEL, STAGEDENSE, CHOLMOD, BANDED };
 
 /// @brief A proximal, augmented Lagrangian-type solver for trajectory
 /// optimization.
@@ -47,7 +53,7 @@ public:
   // typedefs
 
   using Scalar = _Scalar;
-  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  ALIGATOR_DYNAMIC_TYPEDEFS_WITH_ROW_TYPES(Scalar);
   using Problem = TrajOptProblemTpl<Scalar>;
   using Workspace = WorkspaceTpl<Scalar>;
   using Results = ResultsTpl<Scalar>;
@@ -101,6 +107,15 @@ public:
   VerboseLevel verbose_;
   /// Choice of linear solver
   LQSolverChoice linear_solver_choice = LQSolverChoice::SERIAL;
+  /// Threading backend for evaluating the problem and for the parallel linear
+  /// solver. Takes effect on the next call to setup().
+  ThreadingBackend threading_backend_ = ThreadingBackend::OPENMP;
+  /// Pin the worker threads of the ThreadingBackend::THREAD_POOL backend to
+  /// CPU cores (Linux only). Takes effect on the next call to setup().
+  bool pin_threads_ = false;
+  /// Number of legs for the parallel linear solver (zero for one leg per
+  /// thread). Takes effect on the next call to setup().
+  uint lq_num_legs_ = 0;
   bool lq_print_detailed = false;
   /// Type of Hessian approximation. Default is Gauss-Newton.
   HessianApprox hess_approx_ = HessianApprox::GAUSS_NEWTON;
@@ -120,13 +135,28 @@ public:
   BCLParamsTpl<Scalar> bcl_params;
   /// Step acceptance mode.
   StepAcceptanceStrategy sa_strategy = StepAcceptanceStrategy::LINESEARCH;
+  /// @brief Number of step sizes the linesearch evaluates concurrently.
+  /// @details With more than one candidate, the Armijo linesearch is replaced
+  /// by a speculative backtracking linesearch: the step sizes
+  /// \f$\alpha, \beta\alpha, \ldots\f$ (with \f$\beta\f$ =
+  /// `ls_params.contraction_min`) are tried in parallel, each in its own
+  /// workspace, and the largest one satisfying the Armijo condition is kept.
+  /// These geometric steps ignore `ls_params.interp_type`: they differ from
+  /// those of the serial linesearch, which interpolates the merit function
+  /// (cubic interpolation by default), unless it is set to bisection.
+  /// setup() warns when this is not the case.
+  /// @warning Each extra candidate holds a full copy of the WorkspaceTpl,
+  /// including the problem data and the LQ subproblem, so the memory footprint
+  /// grows linearly with this number. Takes effect on the next call to setup().
+  std::size_t ls_num_candidates_ = 1;
 
   /// Force the initial state @f$ x_0 @f$ to be fixed to the problem initial
   /// condition.
   bool force_initial_condition_ = true;
 
-  std::size_t maxRefinementSteps_ =
-      0; //< Max number of KKT system refinement iters
+  /// @brief Max number of iterative refinement steps of the solution of the
+  /// LQ subproblem (see refineLQSolution()).
+  std::size_t maxRefinementSteps_ = 0;
   Scalar refinementThreshold_ = 1e-13; //< Target tol. for the KKT system.
   std::size_t max_iters;               //< Max number of Newton iterations.
   std::size_t max_al_iters = 100;      //< Maximum number of ALM iterations.
@@ -144,6 +174,8 @@ public:
 private:
   /// Number of threads
   std::size_t num_threads_ = 1;
+  /// Persistent worker threads, when using ThreadingBackend::THREAD_POOL.
+  unique_ptr<ThreadPool> thread_pool_;
   /// Dual proximal/ALM penalty parameter \f$\mu\f$
   /// This is the global parameter: scales may be applied for stagewise
   /// constraints, dynamicals...
@@ -152,6 +184,21 @@ private:
   Scalar rho_penal_ = rho_init;
   /// Linesearch function
   LinesearchType linesearch_;
+  /// Workspaces for the extra candidates of the speculative linesearch.
+  std::vector<Workspace> ls_workspaces_;
+  /// Step sizes and merit values of the speculative linesearch candidates.
+  std::vector<Scalar> ls_alphas_, ls_phis_;
+  /// Exception raised by the evaluation of each candidate, if any.
+  std::vector<std::exception_ptr> ls_errors_;
+
+  /// @brief Outer (BCL) loop of the algorithm, starting from the current
+  /// state of the results and solver parameters.
+  bool outerLoop(const Problem &problem);
+
+  /// @brief Speculative backtracking linesearch, see ls_num_candidates_.
+  /// @returns The merit function value at the accepted step size.
+  Scalar speculativeLinesearch(const Problem &problem, const Scalar phi0,
+                               const Scalar dphi0, Scalar &alpha_opt);
 
 public:
   SolverProxDDPTpl(const Scalar tol = 1e-6, const Scalar mu_init = 0.01,
@@ -160,7 +207,10 @@ public:
                    VerboseLevel verbose = VerboseLevel::QUIET,
                    HessianApprox hess_approx = HessianApprox::GAUSS_NEWTON);
 
-  void setNumThreads(const std::size_t num_threads) {
+  /// @brief Set the number of threads, and whether to pin the worker threads
+  /// of the thread pool (see pin_threads_).
+  void setNumThreads(const std::size_t num_threads,
+                     const bool pin_threads = false) {
     if (linearSolver_) {
       ALIGATOR_WARNING(
           "SolverProxDDP",
@@ -168,7 +218,7 @@ public:
           "you call setup() if you want to use the parallel linear solver.\n");
     }
     num_threads_ = num_threads;
-    omp::set_default_options(num_threads);
+    pin_threads_ = pin_threads;
   }
   std::size_t getNumThreads() const { return num_threads_; }
 
@@ -180,19 +230,48 @@ public:
   ///           \f$(\bfx \oplus\alpha\delta\bfx, \bfu+\alpha\delta\bfu,
   ///           \bmlam+\alpha\delta\bmlam)\f$
   /// @returns  The trajectory cost.
+  /// @details  The problem is evaluated on @p pool if it is non-null,
+  /// otherwise using @p num_threads OpenMP threads.
   static Scalar tryLinearStep(const Problem &problem, Workspace &workspace,
-                              const Results &results, const Scalar alpha);
+                              const Results &results, const Scalar alpha,
+                              ThreadPool *pool = nullptr,
+                              std::size_t num_threads = 1);
 
   /// @brief    Policy rollout using the full nonlinear dynamics. The feedback
-  /// gains need to be computed first. This will evaluate all the terms in the
+  /// gains need to be computed first and stored in the results (see
+  /// updateGains() and refineLQSolution()). This will evaluate all the terms in the
   /// problem into the problem data, similar to TrajOptProblemTpl::evaluate().
   /// @returns  The trajectory cost.
-  Scalar tryNonlinearRollout(const Problem &problem, const Scalar alpha);
+  Scalar tryNonlinearRollout(const Problem &problem, const Scalar alpha) {
+    return tryNonlinearRollout(problem, alpha, workspace_);
+  }
+  /// @copybrief tryNonlinearRollout()
+  /// @details Uses the trial buffers of @p workspace.
+  Scalar tryNonlinearRollout(const Problem &problem, const Scalar alpha,
+                             Workspace &workspace);
 
-  Scalar forwardPass(const Problem &problem, const Scalar alpha);
+  Scalar forwardPass(const Problem &problem, const Scalar alpha) {
+    return forwardPass(problem, alpha, workspace_);
+  }
+  /// @brief Compute the trial point of step size @p alpha, and the merit
+  /// function there, in @p workspace.
+  /// @param nested  Whether this is called from within a parallel region, in
+  /// which case the linear rollout evaluates the problem serially.
+  Scalar forwardPass(const Problem &problem, const Scalar alpha,
+                     Workspace &workspace, bool nested = false);
 
   void updateLQSubproblem();
 
+  /// @brief Set the structure flags of the LQ knot @p t from the models of
+  /// @p problem (see gar::LQRKnotTpl::Structure), and the blocks which this
+  /// structure fixes.
+  /// @details The flags only depend on the problem, so they are set in
+  /// setup() and shiftHorizon() instead of being detected from the knot data
+  /// at every iteration. The dynamics Jacobians are described by their
+  /// StageFunctionTpl::jac_structure_, and Q, R are known to be diagonal for
+  /// quadratic costs with diagonal weights.
+  void updateLQStructure(const Problem &problem, std::size_t t);
+
   /// @brief Allocate new workspace and results instances according to the
   /// specifications of @p problem.
   /// @param problem  The problem instance with respect to which memory will be
@@ -210,6 +289,56 @@ public:
            const std::vector<VectorXs> &us_init = {},
            const std::vector<VectorXs> &lams_init = {});
 
+  /// @brief Receding-horizon update: drop the first stage of @p problem,
+  /// append @p stage at the end of the horizon and shift the solver's data
+  /// and current solution accordingly.
+  /// @details The AL penalty, proximal and regularization parameters,
+  /// tolerances and the filter are kept.
+  ///
+  /// No memory is allocated if @p stage is the stage being dropped (e.g. when
+  /// the same stage models are cycled through); otherwise, data for @p stage
+  /// is created. In either case, @p stage must have the same dimensions as
+  /// the stage it replaces.
+  /// @pre  The solver ran on @p problem before.
+  void shiftHorizon(Problem &problem, const shared_ptr<StageModel> &stage);
+
+  /// @brief Shift the horizon (see shiftHorizon()), then resume solving from
+  /// the shifted solution. The new initial state should be set on @p problem
+  /// beforehand.
+  bool shiftAndResume(Problem &problem, const shared_ptr<StageModel> &stage);
+
+  /// @name Real-time iteration
+  /// @brief Split a single SQP iteration into a preparation phase, run
+  /// before the new state measurement is available, and a cheap feedback
+  /// phase once it has arrived.
+  /// @details The preparation phase evaluates the problem and its
+  /// derivatives at the current solution, builds the LQ subproblem and
+  /// factorizes it. The LQ solution is affine in the initial-constraint
+  /// residual, so the feedback phase only has to update the initial stage and
+  /// run the forward sweep of the linear solver, before taking a full step.
+  /// The AL penalty parameter is kept fixed.
+  ///
+  /// A typical control loop is: rtiPreparation(), wait for the state,
+  /// rtiFeedback(), send `results_.us[0]`, shiftHorizon(), and so on.
+  /// @{
+
+  /// @brief Preparation phase of the real-time iteration.
+  /// @pre  The solver ran on @p problem before (e.g. to convergence, as an
+  /// initialization).
+  void rtiPreparation(const Problem &problem);
+
+  /// @brief Feedback phase of the real-time iteration: set the initial state
+  /// of @p problem to @p x0 and update the solution.
+  /// @pre  rtiPreparation() was called on @p problem.
+  void rtiFeedback(Problem &problem, const ConstVectorRef &x0);
+
+  /// Wall-clock duration of the last preparation phase, in microseconds.
+  Scalar rti_preparation_time_ = 0.;
+  /// Wall-clock duration of the last feedback phase, in microseconds. This is
+  /// the latency between the state measurement and the updated controls.
+  Scalar rti_feedback_time_ = 0.;
+  /// @}
+
   /// @brief    Perform the inner loop of the algorithm (augmented Lagrangian
   /// minimization).
   bool innerLoop(const Problem &problem);
@@ -256,7 +385,15 @@ public:
   /// projected constraints.
   void computeMultipliers(const Problem &problem,
                           const std::vector<VectorXs> &lams,
-                          const std::vector<VectorXs> &vs);
+                          const std::vector<VectorXs> &vs) {
+    computeMultipliers(problem, lams, vs, workspace_);
+  }
+  /// @copybrief computeMultipliers()
+  /// @details Writes into the buffers of @p workspace.
+  void computeMultipliers(const Problem &problem,
+                          const std::vector<VectorXs> &lams,
+                          const std::vector<VectorXs> &vs,
+                          Workspace &workspace);
 
   /// @copydoc mu_penal_
   ALIGATOR_INLINE Scalar mu() const { return mu_penal_; }
@@ -271,6 +408,16 @@ public:
   /// multiplier)
   inline void updateGains();
 
+  /// @brief Refine the solution of the LQ subproblem (the primal-dual step)
+  /// and the feedforward gains, until the infinity norm of its KKT residual
+  /// is below refinementThreshold_ or maxRefinementSteps_ steps are taken.
+  /// @details Each step solves the LQ subproblem with the residual as its
+  /// right-hand side, reusing the factorization of the linear solver when it
+  /// supports it. Must be called after updateGains(); the refined
+  /// feedforward gains are accumulated in the results, which the nonlinear
+  /// rollout reads.
+  void refineLQSolution();
+
 protected:
   void updateTolsOnFailure() noexcept {
     prim_tol_ = prim_tol0 * std::pow(mu_penal_, bcl_params.prim_alpha);
@@ -6,22 +6,34 @@
 #include "solver-proxddp.hpp"
 #include "aligator/core/lagrangian.hpp"
 #include "aligator/utils/forward-dyn.hpp"
+#include "aligator/modelling/costs/quad-costs.hpp"
 
 #include "aligator/gar/proximal-riccati.hpp"
+#include "aligator/gar/fixed-size-riccati.hpp"
 #include "aligator/gar/parallel-solver.hpp"
 #include "aligator/gar/dense-riccati.hpp"
+#include "aligator/gar/cholmod-solver.hpp"
+#include "aligator/gar/banded-ldlt.hpp"
 
 #include <tracy/Tracy.hpp>
 
+#include <chrono>
+#include <limits>
+
 namespace aligator {
 
 // [1], realted to Appendix A, details on aug. Lagrangian method
 // interpretation as shifted-penalty method
+// The blocks which the constraint functions declare zero are skipped. Since
+// the normal cone projection can mix the rows of a constraint, only the zero
+// blocks are known to be preserved by the projection.
 template <typename Scalar>
 void computeProjectedJacobians(const TrajOptProblemTpl<Scalar> &problem,
                                WorkspaceTpl<Scalar> &workspace) {
   ZoneScoped;
   using ProductOp = ConstraintSetProductTpl<Scalar>;
+  using VectorXs = typename math_types<Scalar>::VectorXs;
+  using BlkView = BlkMatrix<Eigen::Ref<const VectorXs>, -1, 1>;
   auto &sif = workspace.shifted_constraints;
 
   const TrajOptDataTpl<Scalar> &prob_data = workspace.problem_data;
@@ -31,37 +43,66 @@ void computeProjectedJacobians(const TrajOptProblemTpl<Scalar> &problem,
     const StageDataTpl<Scalar> &sd = *prob_data.stage_data[i];
     const auto &sc = workspace.cstr_scalers[i];
     auto &jac = workspace.cstr_proj_jacs[i];
-
+    VectorXs &Lv = workspace.cstr_scaled_Lvs[i];
+    VectorXs &lx_corr = workspace.cstr_lx_corr[i];
+    VectorXs &lu_corr = workspace.cstr_lu_corr[i];
+    Lv = sc.applyInverse(workspace.Lvs[i]);
+    lx_corr.setZero();
+    lu_corr.setZero();
+
+    BlkView Lv_(Lv, sm.constraints_.dims());
     for (std::size_t j = 0; j < sm.numConstraints(); j++) {
-      jac(j, 0) = sd.constraint_data[j]->Jx_;
-      jac(j, 1) = sd.constraint_data[j]->Ju_;
+      const JacobianStructure &cs = sm.constraints_[j].func->jac_structure_;
+      const StageFunctionDataTpl<Scalar> &cd = *sd.constraint_data[j];
+      if (cs.x.isZero())
+        jac(j, 0).setZero();
+      else
+        jac(j, 0) = cd.Jx_;
+      if (cs.u.isZero())
+        jac(j, 1).setZero();
+      else
+        jac(j, 1) = cd.Ju_;
+      jacobianTransposeMultiplyAdd(cs.x, cd.Jx_, Lv_[j], lx_corr);
+      jacobianTransposeMultiplyAdd(cs.u, cd.Ju_, Lv_[j], lu_corr);
     }
 
-    auto Px = jac.blockCol(0);
-    auto Pu = jac.blockCol(1);
-    auto Lv = sc.applyInverse(workspace.Lvs[i]);
-    workspace.cstr_lx_corr[i].noalias() = Px.transpose() * Lv;
-    workspace.cstr_lu_corr[i].noalias() = Pu.transpose() * Lv;
     const ProductOp &op = workspace.cstr_product_sets[i];
     op.applyNormalConeProjectionJacobian(sif[i], jac.matrix());
-    workspace.cstr_lx_corr[i].noalias() -= Px.transpose() * Lv;
-    workspace.cstr_lu_corr[i].noalias() -= Pu.transpose() * Lv;
+    for (std::size_t j = 0; j < sm.numConstraints(); j++) {
+      const JacobianStructure &cs = sm.constraints_[j].func->jac_structure_;
+      if (!cs.x.isZero())
+        lx_corr.noalias() -= jac(j, 0).transpose() * Lv_[j];
+      if (!cs.u.isZero())
+        lu_corr.noalias() -= jac(j, 1).transpose() * Lv_[j];
+    }
   }
 
   if (!problem.term_cstrs_.empty()) {
+    const ConstraintStackTpl<Scalar> &stack = problem.term_cstrs_;
     auto &jac = workspace.cstr_proj_jacs[N];
     const auto &sc = workspace.cstr_scalers[N];
     const auto &cds = prob_data.term_cstr_data;
+    VectorXs &Lv = workspace.cstr_scaled_Lvs[N];
+    VectorXs &lx_corr = workspace.cstr_lx_corr[N];
+    Lv = sc.applyInverse(workspace.Lvs[N]);
+    lx_corr.setZero();
+
+    BlkView Lv_(Lv, stack.dims());
     for (std::size_t j = 0; j < cds.size(); j++) {
-      jac(j, 0) = cds[j]->Jx_;
+      const JacobianBlockStructure &cs = stack[j].func->jac_structure_.x;
+      if (cs.isZero())
+        jac(j, 0).setZero();
+      else
+        jac(j, 0) = cds[j]->Jx_;
+      jacobianTransposeMultiplyAdd(cs, cds[j]->Jx_, Lv_[j], lx_corr);
     }
 
-    auto Px = jac.blockCol(0);
-    auto Lv = sc.applyInverse(workspace.Lvs[N]);
-    workspace.cstr_lx_corr[N].noalias() = Px.transpose() * Lv;
     const ProductOp &op = workspace.cstr_product_sets[N];
     op.applyNormalConeProjectionJacobian(sif[N], jac.matrix());
-    workspace.cstr_lx_corr[N].noalias() -= Px.transpose() * Lv;
+    for (std::size_t j = 0; j < cds.size(); j++) {
+      if (!stack[j].func->jac_structure_.x.isZero())
+        lx_corr.noalias() -= jac(j, 0).transpose() * Lv_[j];
+    }
   }
 }
 
@@ -79,13 +120,56 @@ SolverProxDDPTpl<Scalar>::SolverProxDDPTpl(const Scalar tol,
   ls_params.interp_type = proxsuite::nlp::LSInterpolation::CUBIC;
 }
 
+template <typename Scalar> void SolverProxDDPTpl<Scalar>::refineLQSolution() {
+  ZoneScoped;
+  ALIGATOR_NOMALLOC_SCOPED;
+  LQProblem &prob = workspace_.lqr_problem;
+  gar::LQRKktResidualTpl<Scalar> &res = workspace_.lqr_residual;
+  const Scalar mudyn = mu();
+  const Scalar mueq = DefaultScaling<Scalar>::scale * mu();
+  const std::size_t N = workspace_.nsteps;
+
+  for (std::size_t k = 0; k < maxRefinementSteps_; k++) {
+    Scalar err = res.compute(prob, workspace_.dxs, workspace_.dus,
+                             workspace_.dvs, workspace_.dlams, mudyn, mueq,
+                             thread_pool_.get(), num_threads_);
+    if (err <= refinementThreshold_)
+      break;
+
+    // solve for the correction, with the residual as right-hand side
+    res.swapVectors(prob);
+    if (!linearSolver_->backwardRhs(mudyn, mueq))
+      linearSolver_->backward(mudyn, mueq);
+    linearSolver_->forward(workspace_.dxs_corr, workspace_.dus_corr,
+                           workspace_.dvs_corr, workspace_.dlams_corr);
+    linearSolver_->collapseFeedback();
+    res.swapVectors(prob);
+
+    math::vectorMultiplyAdd(workspace_.dxs, workspace_.dxs_corr,
+                            workspace_.dxs, 1.);
+    math::vectorMultiplyAdd(workspace_.dus, workspace_.dus_corr,
+                            workspace_.dus, 1.);
+    math::vectorMultiplyAdd(workspace_.dvs, workspace_.dvs_corr,
+                            workspace_.dvs, 1.);
+    math::vectorMultiplyAdd(workspace_.dlams, workspace_.dlams_corr,
+                            workspace_.dlams, 1.);
+    // the feedback gains do not depend on the right-hand side
+    for (std::size_t i = 0; i < N; i++)
+      results_.getFeedforward(i) += linearSolver_->getFeedforward(i);
+    VectorRef ff = results_.getFeedforward(N);
+    ff += linearSolver_->getFeedforward(N).tail(ff.rows());
+  }
+}
+
 // [1] Section IV. Proximal Differential Dynamic Programming
 // C. Forward pass
 template <typename Scalar>
 Scalar SolverProxDDPTpl<Scalar>::tryLinearStep(const Problem &problem,
                                                Workspace &workspace,
                                                const Results &results,
-                                               const Scalar alpha) {
+                                               const Scalar alpha,
+                                               ThreadPool *pool,
+                                               std::size_t num_threads) {
   ZoneScoped;
 
   const std::size_t nsteps = workspace.nsteps;
@@ -110,8 +194,11 @@ Scalar SolverProxDDPTpl<Scalar>::tryLinearStep(const Problem &problem,
                                 alpha * workspace.dxs[nsteps],
                                 workspace.trial_xs[nsteps]);
   TrajOptData &prob_data = workspace.problem_data;
-  prob_data.cost_ =
-      problem.evaluate(workspace.trial_xs, workspace.trial_us, prob_data);
+  if (pool)
+    problem.evaluate(workspace.trial_xs, workspace.trial_us, prob_data, *pool);
+  else
+    problem.evaluate(workspace.trial_xs, workspace.trial_us, prob_data,
+                     num_threads);
   return prob_data.cost_;
 }
 
@@ -123,62 +210,152 @@ void SolverProxDDPTpl<Scalar>::setup(const Problem &problem) {
   linesearch_.setOptions(ls_params);
 
   workspace_.configureScalers(problem, mu_penal_, DefaultScaling<Scalar>{});
+  ls_workspaces_.clear();
+  for (std::size_t k = 1; k < ls_num_candidates_; k++) {
+    ls_workspaces_.emplace_back(problem);
+    ls_workspaces_.back().configureScalers(problem, mu_penal_,
+                                           DefaultScaling<Scalar>{});
+  }
+  ls_alphas_.resize(ls_num_candidates_);
+  ls_phis_.resize(ls_num_candidates_);
+  ls_errors_.resize(ls_num_candidates_);
+  if (ls_num_candidates_ > 1 &&
+      ls_params.interp_type != proxsuite::nlp::LSInterpolation::BISECTION) {
+    ALIGATOR_WARNING(
+        "SolverProxDDP",
+        "The speculative linesearch tries the step sizes alpha = "
+        "contraction_min^k and ignores ls_params.interp_type: set it to "
+        "BISECTION for the serial linesearch to take the same steps.\n");
+  }
+  if (threading_backend_ == ThreadingBackend::THREAD_POOL && num_threads_ > 1) {
+    if (!thread_pool_ || thread_pool_->numThreads() != num_threads_ ||
+        thread_pool_->pinsThreads() != pin_threads_)
+      thread_pool_ = std::make_unique<ThreadPool>(num_threads_, pin_threads_);
+  } else {
+    thread_pool_.reset();
+  }
   switch (linear_solver_choice) {
   case LQSolverChoice::SERIAL: {
-    linearSolver_ = std::make_unique<gar::ProximalRiccatiSolver<Scalar>>(
-        workspace_.lqr_problem);
+    // uses the fixed-size kernel for common problem dimensions
+    linearSolver_ = gar::createProximalRiccatiSolver(workspace_.lqr_problem);
     break;
   }
   case LQSolverChoice::PARALLEL: {
-    if (rollout_type_ == RolloutType::NONLINEAR) {
-      ALIGATOR_RUNTIME_ERROR(
-          "Nonlinear rollouts not supported with the parallel solver.");
-    }
 #ifndef ALIGATOR_MULTITHREADING
     ALIGATOR_RUNTIME_ERROR(
         "Aligator was not compiled with OpenMP support. The parallel Riccati "
         "solver is not available.");
 #else
     linearSolver_ = std::make_unique<gar::ParallelRiccatiSolver<Scalar>>(
-        workspace_.lqr_problem, num_threads_);
+        workspace_.lqr_problem, uint(num_threads_), thread_pool_.get(),
+        lq_num_legs_);
 #endif
     break;
   case LQSolverChoice::STAGEDENSE:
     linearSolver_ = std::make_unique<gar::RiccatiSolverDense<Scalar>>(
         workspace_.lqr_problem);
     break;
+  case LQSolverChoice::CHOLMOD:
+#ifndef ALIGATOR_WITH_CHOLMOD
+    ALIGATOR_RUNTIME_ERROR(
+        "Aligator was not compiled with CHOLMOD support. The CHOLMOD linear "
+        "solver is not available.");
+#else
+    if (rollout_type_ == RolloutType::NONLINEAR)
+      ALIGATOR_RUNTIME_ERROR(
+          "The CHOLMOD linear solver computes no feedback gains, and only "
+          "supports the linear rollout.");
+    linearSolver_ = std::make_unique<gar::CholmodLqSolver<Scalar>>(
+        workspace_.lqr_problem);
+#endif
+    break;
+  case LQSolverChoice::BANDED:
+    if (rollout_type_ == RolloutType::NONLINEAR)
+      ALIGATOR_RUNTIME_ERROR(
+          "The banded linear solver computes no feedback gains, and only "
+          "supports the linear rollout.");
+    linearSolver_ = std::make_unique<gar::BandedLDLTSolver<Scalar>>(
+        workspace_.lqr_problem);
+    break;
   }
   }
+  for (std::size_t t = 0; t <= workspace_.nsteps; t++)
+    updateLQStructure(problem, t);
   filter_.resetFilter(0.0, ls_params.alpha_min, ls_params.max_num_steps);
 }
 
+/// Set the blocks of @p knot which its structure flags fix: these are not
+/// copied by updateLQSubproblem().
+template <typename Scalar>
+void setStructuredLQBlocks(gar::LQRKnotTpl<Scalar> &knot) {
+  if (knot.structure.E_minus_identity) {
+    knot.E.setIdentity();
+    knot.E *= Scalar(-1);
+  }
+  if (knot.structure.B_zero_rows == knot.nx2)
+    knot.B.setZero();
+}
+
+template <typename Scalar>
+void SolverProxDDPTpl<Scalar>::updateLQStructure(const Problem &problem,
+                                                 std::size_t t) {
+  using QuadraticCost = QuadraticCostTpl<Scalar>;
+  const std::size_t N = workspace_.nsteps;
+  gar::LQRKnotTpl<Scalar> &knot = workspace_.lqr_problem.stages[t];
+  auto &s = knot.structure;
+  s = {};
+
+  // the data of a quadratic cost holds its weights, see createData().
+  // the initial condition adds its Hessian to the first knot.
+  const CostAbstractTpl<Scalar> &cost =
+      t < N ? *problem.stages_[t]->cost_ : *problem.term_cost_;
+  if (const auto *qc = dynamic_cast<const QuadraticCost *>(&cost)) {
+    s.Q_diagonal = (t > 0) && qc->Wxx_.isDiagonal(Scalar(0));
+    s.R_diagonal = (t < N) && qc->Wuu_.isDiagonal(Scalar(0));
+  }
+  if (t == N)
+    return;
+
+  const StageModel &stage = *problem.stages_[t];
+  if (!stage.has_dyn_model())
+    return;
+  const JacobianStructure &js = stage.dynamics_->jac_structure_;
+  // explicit dynamics on a vector space: E = -I
+  s.E_minus_identity = stage.dynamics_->is_explicit() &&
+                       js.y.type == JacobianBlockType::DIAGONAL &&
+                       knot.nx2 == knot.nx;
+  if (js.u.isZero())
+    s.B_zero_rows = knot.nx2;
+  setStructuredLQBlocks(knot);
+}
+
 /// TODO: REWORK FOR NEW MULTIPLIERS
 template <typename Scalar>
 void SolverProxDDPTpl<Scalar>::computeMultipliers(
     const Problem &problem, const std::vector<VectorXs> &lams,
-    const std::vector<VectorXs> &vs) {
+    const std::vector<VectorXs> &vs, Workspace &workspace) {
   ZoneScoped;
   using BlkView = BlkMatrix<VectorRef, -1, 1>;
 
-  const TrajOptData &prob_data = workspace_.problem_data;
-  const std::size_t nsteps = workspace_.nsteps;
+  const TrajOptData &prob_data = workspace.problem_data;
+  const std::size_t nsteps = workspace.nsteps;
 
   // TODO: make clear with the naming prev_x, x_plus, x_pdal means ?
   // [1] Section B. Augmented Lagrangian methods eqn. 5a and 5b for x_plus
   // and in subsection Primal-dual search x_k is prev_x. Then, more precisely
   // eqn. 39 gives the formula for first-order multiplier estimates in the
   // DDP setup
-  const std::vector<VectorXs> &lams_prev = workspace_.prev_lams;
-  std::vector<VectorXs> &lams_plus = workspace_.lams_plus;
-  std::vector<VectorXs> &lams_pdal = workspace_.lams_pdal;
+  const std::vector<VectorXs> &lams_prev = workspace.prev_lams;
+  std::vector<VectorXs> &lams_plus = workspace.lams_plus;
+  std::vector<VectorXs> &lams_pdal = workspace.lams_pdal;
 
-  const std::vector<VectorXs> &vs_prev = workspace_.prev_vs;
-  std::vector<VectorXs> &vs_plus = workspace_.vs_plus;
-  std::vector<VectorXs> &vs_pdal = workspace_.vs_pdal;
+  const std::vector<VectorXs> &vs_prev = workspace.prev_vs;
+  std::vector<VectorXs> &vs_plus = workspace.vs_plus;
+  std::vector<VectorXs> &vs_pdal = workspace.vs_pdal;
 
-  std::vector<VectorXs> &Lds = workspace_.Lds;
-  std::vector<VectorXs> &Lvs = workspace_.Lvs;
-  std::vector<VectorXs> &shifted_constraints = workspace_.shifted_constraints;
+  std::vector<VectorXs> &Lds = workspace.Lds;
+  std::vector<VectorXs> &Lvs = workspace.Lvs;
+  std::vector<VectorXs> &shifted_constraints = workspace.shifted_constraints;
 
   assert(Lds.size() == lams_prev.size());
   assert(Lds.size() == nsteps + 1);
@@ -191,7 +368,7 @@ void SolverProxDDPTpl<Scalar>::computeMultipliers(
     lams_plus[0] = lams_prev[0] + mu_inv() * dd.value_;
     lams_pdal[0] = 2 * lams_plus[0] - lams[0];
     /// TODO: generalize to the other types of initial constraint (non-equality)
-    workspace_.dyn_slacks[0] = dd.value_;
+    workspace.dyn_slacks[0] = dd.value_;
     Lds[0] = mu() * (lams_plus[0] - lams[0]);
     ALIGATOR_RAISE_IF_NAN(Lds[0]);
   }
@@ -202,13 +379,13 @@ void SolverProxDDPTpl<Scalar>::computeMultipliers(
     const StageData &sd = *prob_data.stage_data[i];
     const StageFunctionData &dd = *sd.dynamics_data;
     const ConstraintStack &cstr_stack = stage.constraints_;
-    const CstrProximalScaler &scaler = workspace_.cstr_scalers[i];
+    const CstrProximalScaler &scaler = workspace.cstr_scalers[i];
 
     assert(vs[i].size() == stage.nc());
     assert(lams[i + 1].size() == stage.ndx2());
 
     // 1. compute shifted dynamics error
-    workspace_.dyn_slacks[i + 1] = dd.value_;
+    workspace.dyn_slacks[i + 1] = dd.value_;
     lams_plus[i + 1] = lams_prev[i + 1] + mu_inv() * dd.value_;
     lams_pdal[i + 1] = 2 * lams_plus[i + 1] - lams[i + 1];
     Lds[i + 1] = mu() * (lams_plus[i + 1] - lams[i + 1]);
@@ -216,7 +393,7 @@ void SolverProxDDPTpl<Scalar>::computeMultipliers(
 
     // 2. use product constraint operator
     // to compute the new multiplier estimates
-    const ConstraintSetProductTpl<Scalar> &op = workspace_.cstr_product_sets[i];
+    const ConstraintSetProductTpl<Scalar> &op = workspace.cstr_product_sets[i];
 
     // fill in shifted constraints buffer
     BlkView scvView(shifted_constraints[i], cstr_stack.dims());
@@ -227,7 +404,7 @@ void SolverProxDDPTpl<Scalar>::computeMultipliers(
     shifted_constraints[i] += scaler.apply(vs_prev[i]);
     op.normalConeProjection(shifted_constraints[i], vs_plus[i]);
     op.computeActiveSet(shifted_constraints[i],
-                        workspace_.active_constraints[i]);
+                        workspace.active_constraints[i]);
     Lvs[i] = vs_plus[i];
     Lvs[i].noalias() -= scaler.apply(vs[i]);
     vs_plus[i] = scaler.applyInverse(vs_plus[i]);
@@ -238,10 +415,10 @@ void SolverProxDDPTpl<Scalar>::computeMultipliers(
   if (!problem.term_cstrs_.empty()) {
     assert(problem.term_cstrs_.size() == prob_data.term_cstr_data.size());
     const ConstraintStack &cstr_stack = problem.term_cstrs_;
-    const CstrProximalScaler &scaler = workspace_.cstr_scalers[nsteps];
+    const CstrProximalScaler &scaler = workspace.cstr_scalers[nsteps];
 
     const ConstraintSetProductTpl<Scalar> &op =
-        workspace_.cstr_product_sets[nsteps];
+        workspace.cstr_product_sets[nsteps];
 
     BlkView scvView(shifted_constraints[nsteps], cstr_stack.dims());
     for (size_t j = 0; j < cstr_stack.size(); j++) {
@@ -251,7 +428,7 @@ void SolverProxDDPTpl<Scalar>::computeMultipliers(
     shifted_constraints[nsteps] += scaler.apply(vs_prev[nsteps]);
     op.normalConeProjection(shifted_constraints[nsteps], vs_plus[nsteps]);
     op.computeActiveSet(shifted_constraints[nsteps],
-                        workspace_.active_constraints[nsteps]);
+                        workspace.active_constraints[nsteps]);
     Lvs[nsteps] = vs_plus[nsteps];
     Lvs[nsteps].noalias() -= scaler.apply(vs[nsteps]);
     vs_plus[nsteps] = scaler.applyInverse(vs_plus[nsteps]);
@@ -284,31 +461,33 @@ template <typename Scalar> void SolverProxDDPTpl<Scalar>::updateGains() {
 // C. Forward pass
 template <typename Scalar>
 Scalar SolverProxDDPTpl<Scalar>::tryNonlinearRollout(const Problem &problem,
-                                                     const Scalar alpha) {
+                                                     const Scalar alpha,
+                                                     Workspace &workspace) {
   ZoneScoped;
   using ExplicitDynData = ExplicitDynamicsDataTpl<Scalar>;
   using gar::StageFactor;
 
-  const std::size_t nsteps = workspace_.nsteps;
-  std::vector<VectorXs> &xs = workspace_.trial_xs;
-  std::vector<VectorXs> &us = workspace_.trial_us;
-  std::vector<VectorXs> &vs = workspace_.trial_vs;
-  std::vector<VectorXs> &lams = workspace_.trial_lams;
-  std::vector<VectorXs> &dxs = workspace_.dxs;
-  std::vector<VectorXs> &dus = workspace_.dus;
-  std::vector<VectorXs> &dvs = workspace_.dvs;
-  std::vector<VectorXs> &dlams = workspace_.dlams;
-
-  const std::vector<VectorXs> &lams_prev = workspace_.prev_lams;
-  std::vector<VectorXs> &dyn_slacks = workspace_.dyn_slacks;
-  TrajOptData &prob_data = workspace_.problem_data;
+  const std::size_t nsteps = workspace.nsteps;
+  std::vector<VectorXs> &xs = workspace.trial_xs;
+  std::vector<VectorXs> &us = workspace.trial_us;
+  std::vector<VectorXs> &vs = workspace.trial_vs;
+  std::vector<VectorXs> &lams = workspace.trial_lams;
+  std::vector<VectorXs> &dxs = workspace.dxs;
+  std::vector<VectorXs> &dus = workspace.dus;
+  std::vector<VectorXs> &dvs = workspace.dvs;
+  std::vector<VectorXs> &dlams = workspace.dlams;
+
+  const std::vector<VectorXs> &lams_prev = workspace.prev_lams;
+  std::vector<VectorXs> &dyn_slacks = workspace.dyn_slacks;
+  TrajOptData &prob_data = workspace.problem_data;
 
   {
     const StageModel &stage = *problem.stages_[0];
     // use lams[0] as a tmp var for alpha * dx0
     lams[0] = alpha * dxs[0];
     stage.xspace().integrate(results_.xs[0], lams[0], xs[0]);
-    lams[0] = results_.lams[0] + alpha * workspace_.dlams[0];
+    lams[0] = results_.lams[0] + alpha * workspace.dlams[0];
+    problem.init_condition_->evaluate(xs[0], *prob_data.init_data);
 
     ALIGATOR_RAISE_IF_NAN_NAME(xs[0], fmt::format("xs[{:d}]", 0));
   }
@@ -319,10 +498,10 @@ Scalar SolverProxDDPTpl<Scalar>::tryNonlinearRollout(const Problem &problem,
 
     const std::array<long, 4> _dims{stage.nu(), stage.nc(), stage.ndx2(),
                                     stage.ndx2()};
-    BlkMatrix<ConstVectorRef, 4, 1> ff{
-        linearSolver_->getFeedforward(t), _dims, {1}};
+    // the gains stored in the results include the iterative refinement
+    BlkMatrix<ConstVectorRef, 4, 1> ff{results_.getFeedforward(t), _dims, {1}};
     BlkMatrix<ConstMatrixRef, 4, 1> fb{
-        linearSolver_->getFeedback(t), _dims, {stage.ndx1()}};
+        results_.getFeedback(t), _dims, {stage.ndx1()}};
     ConstVectorRef kff = ff[0];
     ConstVectorRef zff = ff[1];
     ConstVectorRef lff = ff[2];
@@ -359,6 +538,12 @@ Scalar SolverProxDDPTpl<Scalar>::tryNonlinearRollout(const Problem &problem,
                                    xs[t + 1], dyn_slacks[t], rollout_max_iters);
     }
 
+    // the constraints were evaluated at the previous next state
+    for (std::size_t j = 0; j < stage.numConstraints(); j++) {
+      const ConstraintType &cstr = stage.constraints_[j];
+      cstr.func->evaluate(xs[t], us[t], xs[t + 1], *data.constraint_data[j]);
+    }
+
     stage.xspace_next().difference(results_.xs[t + 1], xs[t + 1], dxs[t + 1]);
 
     ALIGATOR_RAISE_IF_NAN_NAME(xs[t + 1], fmt::format("xs[{:d}]", t + 1));
@@ -378,17 +563,9 @@ Scalar SolverProxDDPTpl<Scalar>::tryNonlinearRollout(const Problem &problem,
 
   // update multiplier
   if (!problem.term_cstrs_.empty()) {
-    const std::array<long, 2> _dims{
-        workspace_.lqr_problem.stages[nsteps].nu,
-        workspace_.lqr_problem.stages[nsteps].nc,
-    };
-    const uint ndx = workspace_.lqr_problem.stages[nsteps].nx;
-    BlkMatrix<ConstVectorRef, 2, 1> ff{
-        linearSolver_->getFeedforward(nsteps), _dims, {1}};
-    BlkMatrix<ConstMatrixRef, 2, 1> fb{
-        linearSolver_->getFeedback(nsteps), _dims, {ndx}};
-    ConstVectorRef zff = ff[1];
-    ConstMatrixRef Zfb = fb.blockRow(1);
+    const Results &res = results_;
+    ConstVectorRef zff = res.getFeedforward(nsteps);
+    ConstMatrixRef Zfb = res.getFeedback(nsteps);
 
     dvs[nsteps] = alpha * zff;
     dvs[nsteps].noalias() += Zfb * dxs[nsteps];
@@ -426,6 +603,7 @@ bool SolverProxDDPTpl<Scalar>::run(const Problem &problem,
   }
 
   logger.active = (verbose_ > 0);
+  logger.reset();
   for (const auto &col : BASIC_KEYS) {
     logger.addColumn(col);
   }
@@ -438,6 +616,7 @@ bool SolverProxDDPTpl<Scalar>::run(const Problem &problem,
   workspace_.prev_us = results_.us;
   workspace_.prev_vs = results_.vs;
   workspace_.prev_lams = results_.lams;
+  workspace_.problem_data_status = Workspace::DataStatus::STALE;
 
   inner_tol_ = inner_tol0;
   prim_tol_ = prim_tol0;
@@ -446,6 +625,220 @@ bool SolverProxDDPTpl<Scalar>::run(const Problem &problem,
   inner_tol_ = std::max(inner_tol_, target_tol_);
   prim_tol_ = std::max(prim_tol_, target_tol_);
 
+  return outerLoop(problem);
+}
+
+template <typename Scalar>
+void SolverProxDDPTpl<Scalar>::shiftHorizon(
+    Problem &problem, const shared_ptr<StageModel> &new_stage) {
+  ZoneScoped;
+  // copy the pointer, which may refer to an element of problem.stages_
+  const shared_ptr<StageModel> stage = new_stage;
+  if (!workspace_.isInitialized() || !results_.isInitialized()) {
+    ALIGATOR_RUNTIME_ERROR("workspace and results were not allocated yet!");
+  }
+  const std::size_t N = workspace_.nsteps;
+  if (problem.numSteps() != N || N == 0) {
+    ALIGATOR_RUNTIME_ERROR(
+        "Problem does not match the allocated workspace, or is empty.");
+  }
+  if (stage == nullptr)
+    ALIGATOR_RUNTIME_ERROR("Input stage is null.");
+
+  const shared_ptr<StageModel> dropped = problem.stages_[0];
+  if (!stage_dims_match(*dropped, *stage)) {
+    ALIGATOR_RUNTIME_ERROR(
+        "New stage does not have the same dimensions as the stage it "
+        "replaces. Call setup() again instead.");
+  }
+  if (linear_solver_choice == LQSolverChoice::PARALLEL) {
+    // the parallel solver's legs cannot be rotated: the knots need to keep
+    // their dimensions
+    for (std::size_t i = 0; i + 1 < N; i++) {
+      if (!stage_dims_match(*problem.stages_[i], *problem.stages_[i + 1]))
+        ALIGATOR_RUNTIME_ERROR(
+            "The parallel linear solver only supports shifting problems "
+            "where all stages have the same dimensions.");
+    }
+  }
+
+  problem.replaceStageCircular(stage);
+  const auto cycle_workspace = [&](Workspace &ws) {
+    if (stage == dropped) {
+      // reuse the data of the dropped stage
+      ws.cycleLeft();
+    } else {
+      // same as cycleAppend(), but rotating the solver-specific buffers too
+      auto &stage_data = ws.problem_data.stage_data;
+      stage_data.emplace_back(stage->createData());
+      ws.cycleLeft();
+      stage_data.pop_back();
+      auto &scaler = ws.cstr_scalers[N - 1];
+      scaler = ConstraintProximalScalerTpl<Scalar>(stage->constraints_,
+                                                   mu_penal_);
+      DefaultScaling<Scalar>{}(scaler);
+    }
+  };
+  cycle_workspace(workspace_);
+  for (Workspace &ws : ls_workspaces_)
+    cycle_workspace(ws);
+  auto &knots = workspace_.lqr_problem.stages;
+  if (linearSolver_->cycleLeft()) {
+    rotate_vec_left(knots, 0, 1);
+  } else {
+    // the knots stay in place: shift the structure of their stages
+    for (std::size_t t = 0; t + 1 < N; t++) {
+      knots[t].structure = knots[t + 1].structure;
+      setStructuredLQBlocks(knots[t]);
+    }
+  }
+  updateLQStructure(problem, 0);
+  updateLQStructure(problem, N - 1);
+
+  // warm-start the new last stage by repeating the end of the previous
+  // solution
+  results_.cycleLeft();
+  const auto copy_if_fits = [](VectorXs &dst, const VectorXs &src) {
+    if (dst.size() == src.size())
+      dst = src;
+    else
+      dst.setZero();
+  };
+  if (results_.xs[N - 1].size() == stage->xspace_next().nx())
+    results_.xs[N] = results_.xs[N - 1];
+  else
+    set_neutral_element(stage->xspace_next(), results_.xs[N]);
+  if (N > 1) {
+    if (results_.us[N - 1].size() == results_.us[N - 2].size())
+      results_.us[N - 1] = results_.us[N - 2];
+    copy_if_fits(results_.vs[N - 1], results_.vs[N - 2]);
+  }
+  copy_if_fits(results_.lams[N], results_.lams[N - 1]);
+
+  workspace_.prev_xs = results_.xs;
+  workspace_.prev_us = results_.us;
+  workspace_.prev_vs = results_.vs;
+  workspace_.prev_lams = results_.lams;
+}
+
+template <typename Scalar>
+bool SolverProxDDPTpl<Scalar>::shiftAndResume(
+    Problem &problem, const shared_ptr<StageModel> &stage) {
+  shiftHorizon(problem, stage);
+  workspace_.problem_data_status = Workspace::DataStatus::STALE;
+
+  if (force_initial_condition_) {
+    results_.xs[0] = problem.getInitState();
+    workspace_.prev_xs[0] = results_.xs[0];
+    workspace_.trial_xs[0] = results_.xs[0];
+    workspace_.trial_lams[0].setZero();
+  }
+
+  logger.active = (verbose_ > 0);
+  logger.printHeadline();
+
+  return outerLoop(problem);
+}
+
+template <typename Scalar>
+void SolverProxDDPTpl<Scalar>::rtiPreparation(const Problem &problem) {
+  ZoneScoped;
+  const auto start = std::chrono::steady_clock::now();
+  if (!workspace_.isInitialized() || !results_.isInitialized()) {
+    ALIGATOR_RUNTIME_ERROR("workspace and results were not allocated yet!");
+  }
+  if (problem.numSteps() != workspace_.nsteps) {
+    ALIGATOR_RUNTIME_ERROR("Problem does not match the allocated workspace.");
+  }
+
+  // same as the beginning of an inner iteration, linearizing around the
+  // current solution
+  results_.traj_cost_ =
+      thread_pool_ ? problem.evaluate(results_.xs, results_.us,
+                                      workspace_.problem_data, *thread_pool_)
+                   : problem.evaluate(results_.xs, results_.us,
+                                      workspace_.problem_data, num_threads_);
+  if (thread_pool_)
+    problem.computeDerivatives(results_.xs, results_.us,
+                               workspace_.problem_data, *thread_pool_);
+  else
+    problem.computeDerivatives(results_.xs, results_.us,
+                               workspace_.problem_data, num_threads_);
+  workspace_.problem_data_status = Workspace::DataStatus::DIFFERENTIATED;
+  computeMultipliers(problem, results_.lams, results_.vs);
+  LagrangianDerivatives<Scalar>::compute(problem, workspace_.problem_data,
+                                         results_.lams, results_.vs,
+                                         workspace_.Lxs, workspace_.Lus);
+  if (force_initial_condition_) {
+    workspace_.Lxs[0].setZero();
+    workspace_.Lds[0].setZero();
+  }
+  computeProjectedJacobians(problem, workspace_);
+  initializeRegularization();
+  updateLQSubproblem();
+  linearSolver_->backward(mu(), DefaultScaling<Scalar>::scale * mu());
+
+  const std::chrono::duration<Scalar, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  rti_preparation_time_ = elapsed.count();
+}
+
+template <typename Scalar>
+void SolverProxDDPTpl<Scalar>::rtiFeedback(Problem &problem,
+                                           const ConstVectorRef &x0) {
+  ZoneScoped;
+  const auto start = std::chrono::steady_clock::now();
+  problem.setInitState(x0);
+
+  // the initial-constraint residual is the only part of the LQ subproblem
+  // which depends on the new state; keep the proximal term of Lds[0], as in
+  // computeMultipliers()
+  TrajOptData &prob_data = workspace_.problem_data;
+  StageFunctionData &init_data = *prob_data.init_data;
+  problem.init_condition_->evaluate(results_.xs[0], init_data);
+  workspace_.Lds[0] =
+      init_data.value_ + mu() * (workspace_.prev_lams[0] - results_.lams[0]);
+  workspace_.lqr_problem.g0 = workspace_.Lds[0];
+  if (!linearSolver_->updateInitialResidual()) {
+    linearSolver_->backward(mu(), DefaultScaling<Scalar>::scale * mu());
+  }
+  linearSolver_->forward(workspace_.dxs, workspace_.dus, workspace_.dvs,
+                         workspace_.dlams);
+  updateGains();
+
+  // take the full step
+  const std::size_t N = workspace_.nsteps;
+  math::vectorMultiplyAdd(results_.lams, workspace_.dlams, results_.lams, 1.);
+  math::vectorMultiplyAdd(results_.vs, workspace_.dvs, results_.vs, 1.);
+  for (std::size_t i = 0; i < N; i++) {
+    const StageModel &stage = *problem.stages_[i];
+    stage.xspace_->integrate(results_.xs[i], workspace_.dxs[i],
+                             workspace_.trial_xs[i]);
+    stage.uspace_->integrate(results_.us[i], workspace_.dus[i],
+                             workspace_.trial_us[i]);
+    results_.xs[i].swap(workspace_.trial_xs[i]);
+    results_.us[i].swap(workspace_.trial_us[i]);
+  }
+  problem.stages_[N - 1]->xspace_next_->integrate(
+      results_.xs[N], workspace_.dxs[N], workspace_.trial_xs[N]);
+  results_.xs[N].swap(workspace_.trial_xs[N]);
+  if (force_initial_condition_) {
+    results_.xs[0] = x0;
+  }
+
+  workspace_.prev_xs = results_.xs;
+  workspace_.prev_us = results_.us;
+  workspace_.prev_vs = results_.vs;
+  workspace_.prev_lams = results_.lams;
+  workspace_.problem_data_status = Workspace::DataStatus::STALE;
+
+  const std::chrono::duration<Scalar, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  rti_feedback_time_ = elapsed.count();
+}
+
+template <typename Scalar>
+bool SolverProxDDPTpl<Scalar>::outerLoop(const Problem &problem) {
   bool &conv = results_.conv = false;
 
   results_.al_iter = 0;
@@ -471,13 +864,16 @@ bool SolverProxDDPTpl<Scalar>::run(const Problem &problem,
         workspace_.prev_vs = results_.vs;
         workspace_.prev_lams = results_.lams;
         break;
+      // the first-order estimates are recomputed from prev_{vs,lams} at the
+      // start of the next inner loop, so they can be swapped in
       case MultiplierUpdateMode::PRIMAL:
-        workspace_.prev_vs = workspace_.vs_plus;
-        workspace_.prev_lams = workspace_.lams_plus;
+        workspace_.prev_vs.swap(workspace_.vs_plus);
+        workspace_.prev_lams.swap(workspace_.lams_plus);
         break;
       case MultiplierUpdateMode::PRIMAL_DUAL:
+        // vs_pdal is not recomputed: copy it
         workspace_.prev_vs = workspace_.vs_pdal;
-        workspace_.prev_lams = workspace_.lams_pdal;
+        workspace_.prev_lams.swap(workspace_.lams_pdal);
         break;
       default:
         break;
@@ -513,19 +909,95 @@ bool SolverProxDDPTpl<Scalar>::run(const Problem &problem,
 // is performed on.
 template <typename Scalar>
 Scalar SolverProxDDPTpl<Scalar>::forwardPass(const Problem &problem,
-                                             const Scalar alpha) {
+                                             const Scalar alpha,
+                                             Workspace &workspace,
+                                             bool nested) {
   ZoneScoped;
+  workspace.trial_alpha = alpha;
   switch (rollout_type_) {
   case RolloutType::LINEAR:
-    tryLinearStep(problem, workspace_, results_, alpha);
+    if (nested)
+      tryLinearStep(problem, workspace, results_, alpha, nullptr, 1);
+    else
+      tryLinearStep(problem, workspace, results_, alpha, thread_pool_.get(),
+                    num_threads_);
     break;
   case RolloutType::NONLINEAR:
-    tryNonlinearRollout(problem, alpha);
+    tryNonlinearRollout(problem, alpha, workspace);
     break;
   }
-  computeMultipliers(problem, workspace_.trial_lams, workspace_.trial_vs);
-  return PDALFunction<Scalar>::evaluate(mu(), problem, workspace_.trial_lams,
-                                        workspace_.trial_vs, workspace_);
+  computeMultipliers(problem, workspace.trial_lams, workspace.trial_vs,
+                     workspace);
+  return PDALFunction<Scalar>::evaluate(mu(), problem, workspace.trial_lams,
+                                        workspace.trial_vs, workspace);
+}
+
+template <typename Scalar>
+Scalar SolverProxDDPTpl<Scalar>::speculativeLinesearch(const Problem &problem,
+                                                       const Scalar phi0,
+                                                       const Scalar dphi0,
+                                                       Scalar &alpha_opt) {
+  ZoneScoped;
+  const std::size_t num_cand = ls_workspaces_.size() + 1;
+  const Scalar beta = ls_params.contraction_min;
+  // the auxiliary workspaces need the search direction and proximal
+  // multipliers of the main one
+  for (Workspace &ws : ls_workspaces_) {
+    ws.dxs = workspace_.dxs;
+    ws.dus = workspace_.dus;
+    ws.dvs = workspace_.dvs;
+    ws.dlams = workspace_.dlams;
+    ws.prev_vs = workspace_.prev_vs;
+    ws.prev_lams = workspace_.prev_lams;
+  }
+
+  Scalar alpha = 1.;
+  while (true) {
+    // candidates alpha, beta * alpha, ..., down to alpha_min
+    std::size_t n = 0;
+    for (; n < num_cand; n++) {
+      ls_alphas_[n] = std::max(alpha, ls_params.alpha_min);
+      if (alpha <= ls_params.alpha_min) {
+        n++;
+        break;
+      }
+      alpha *= beta;
+    }
+
+    // the largest step is evaluated in the main workspace; the candidates
+    // run concurrently, so each one evaluates the problem serially
+    const bool nested = n > 1;
+    parallel_for(thread_pool_.get(), std::min(n, num_threads_), n,
+                 [&](std::size_t k) {
+                   Workspace &ws = k == 0 ? workspace_ : ls_workspaces_[k - 1];
+                   ls_errors_[k] = nullptr;
+                   try {
+                     ls_phis_[k] =
+                         forwardPass(problem, ls_alphas_[k], ws, nested);
+                   } catch (...) {
+                     // exceptions must not escape an OpenMP region
+                     ls_errors_[k] = std::current_exception();
+                   }
+                 });
+
+    // a failed candidate is never accepted; as in the serial linesearch, the
+    // error is raised if the smallest step size fails.
+    for (std::size_t k = 0; k < n; k++) {
+      const Scalar a = ls_alphas_[k];
+      if (ls_errors_[k]) {
+        if (a <= ls_params.alpha_min)
+          std::rethrow_exception(ls_errors_[k]);
+        continue;
+      }
+      if ((ls_phis_[k] <= phi0 + ls_params.armijo_c1 * a * dphi0) ||
+          (a <= ls_params.alpha_min)) {
+        alpha_opt = a;
+        if (k > 0)
+          workspace_.swapTrialData(ls_workspaces_[k - 1]);
+        return ls_phis_[k];
+      }
+    }
+  }
 }
 
 template <typename Scalar>
@@ -545,20 +1017,38 @@ bool SolverProxDDPTpl<Scalar>::innerLoop(const Problem &problem) {
     return fpair;
   };
 
+  using DataStatus = typename Workspace::DataStatus;
+  DataStatus &data_status = workspace_.problem_data_status;
+
   std::size_t &iter = results_.num_iters;
-  results_.traj_cost_ = problem.evaluate(results_.xs, results_.us,
-                                         workspace_.problem_data, num_threads_);
+  // the data is current if the previous inner loop ended at this iterate
+  if (data_status == DataStatus::STALE) {
+    if (thread_pool_)
+      problem.evaluate(results_.xs, results_.us, workspace_.problem_data,
+                       *thread_pool_);
+    else
+      problem.evaluate(results_.xs, results_.us, workspace_.problem_data,
+                       num_threads_);
+    data_status = DataStatus::EVALUATED;
+  }
+  results_.traj_cost_ = workspace_.problem_data.cost_;
   computeMultipliers(problem, results_.lams, results_.vs);
   results_.merit_value_ = PDALFunction<Scalar>::evaluate(
       mu(), problem, results_.lams, results_.vs, workspace_);
 
   for (; iter < max_iters; iter++) {
     ZoneNamedN(ZoneIteration, "inner_iteration", true);
-    // ASSUMPTION: last evaluation in previous iterate
-    // was during linesearch, at the current candidate solution (x,u).
-    /// TODO: make this smarter using e.g. some caching mechanism
-    problem.computeDerivatives(results_.xs, results_.us,
-                               workspace_.problem_data, num_threads_);
+    // the function values at the current iterate were computed either above
+    // or during the last linesearch: only the derivatives are missing.
+    if (data_status != DataStatus::DIFFERENTIATED) {
+      if (thread_pool_)
+        problem.computeDerivatives(results_.xs, results_.us,
+                                   workspace_.problem_data, *thread_pool_);
+      else
+        problem.computeDerivatives(results_.xs, results_.us,
+                                   workspace_.problem_data, num_threads_);
+      data_status = DataStatus::DIFFERENTIATED;
+    }
     const Scalar phi0 = results_.merit_value_;
 
     // compute the Lagrangian derivatives to check for convergence
@@ -596,6 +1086,8 @@ bool SolverProxDDPTpl<Scalar>::innerLoop(const Problem &problem) {
     linearSolver_->forward(workspace_.dxs, workspace_.dus, workspace_.dvs,
                            workspace_.dlams);
     updateGains();
+    if (maxRefinementSteps_ > 0)
+      refineLQSolution();
 
     if (force_initial_condition_) {
       workspace_.dxs[0].setZero();
@@ -615,7 +1107,10 @@ bool SolverProxDDPTpl<Scalar>::innerLoop(const Problem &problem) {
 
     switch (sa_strategy) {
     case StepAcceptanceStrategy::LINESEARCH:
-      phi_new = linesearch_.run(merit_eval_fun, phi0, dphi0, alpha_opt);
+      if (ls_workspaces_.empty())
+        phi_new = linesearch_.run(merit_eval_fun, phi0, dphi0, alpha_opt);
+      else
+        phi_new = speculativeLinesearch(problem, phi0, dphi0, alpha_opt);
       break;
     case StepAcceptanceStrategy::FILTER:
       phi_new = filter_.run(pair_eval_fun, alpha_opt);
@@ -625,11 +1120,13 @@ bool SolverProxDDPTpl<Scalar>::innerLoop(const Problem &problem) {
       break;
     }
 
+    // the linesearch may have last evaluated another step size
+    if (workspace_.trial_alpha != alpha_opt)
+      phi_new = forwardPass(problem, alpha_opt);
+
     // accept the step
-    results_.xs = workspace_.trial_xs;
-    results_.us = workspace_.trial_us;
-    results_.vs = workspace_.trial_vs;
-    results_.lams = workspace_.trial_lams;
+    workspace_.acceptTrialIterate(results_);
+    data_status = DataStatus::EVALUATED;
     results_.traj_cost_ = workspace_.problem_data.cost_;
     results_.merit_value_ = phi_new;
     ALIGATOR_RAISE_IF_NAN_NAME(alpha_opt, "alpha_opt");
@@ -745,9 +1242,12 @@ template <typename Scalar> void SolverProxDDPTpl<Scalar>::updateLQSubproblem() {
     uint nu = knot.nu;
     uint nc = knot.nc;
 
+    // the blocks fixed by the structure were set by updateLQStructure()
     knot.A = dd.Jx_;
-    knot.B = dd.Ju_;
-    knot.E = dd.Jy_;
+    if (knot.structure.B_zero_rows < knot.nx2)
+      knot.B = dd.Ju_;
+    if (!knot.structure.E_minus_identity)
+      knot.E = dd.Jy_;
     knot.f = workspace_.Lds[t + 1];
 
     knot.Q = cd.Lxx_;
@@ -764,6 +1264,8 @@ template <typename Scalar> void SolverProxDDPTpl<Scalar>::updateLQSubproblem() {
       knot.Q += dd.Hxx_;
       knot.S += dd.Hxu_;
       knot.R += dd.Huu_;
+      knot.structure.Q_diagonal = false;
+      knot.structure.R_diagonal = false;
     }
 
     // TODO: handle the bloody constraints
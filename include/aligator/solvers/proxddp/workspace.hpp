@@ -6,6 +6,7 @@
 #include "aligator/core/workspace-base.hpp"
 #include "aligator/core/alm-weights.hpp"
 #include "aligator/gar/lqr-problem.hpp"
+#include "aligator/gar/utils.hpp"
 
 #include <proxsuite-nlp/modelling/constraints.hpp>
 
@@ -53,6 +54,8 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
   /// @}
 
   /// @name Trial primal-dual step
+  /// These are the back buffers of the trajectories held in ResultsTpl: an
+  /// accepted trial iterate is swapped in, see acceptTrialIterate().
   /// @{
   using Base::trial_us;
   using Base::trial_xs;
@@ -72,6 +75,8 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
   std::vector<VectorXs> shifted_constraints;
   std::vector<VectorXs> cstr_lx_corr;
   std::vector<VectorXs> cstr_lu_corr;
+  /// Path multiplier gradients, scaled by the inverse constraint weights
+  std::vector<VectorXs> cstr_scaled_Lvs;
   /// Projected path constraint Jacobians (used to symmetrize the LQ subproblem)
   std::vector<BlkJacobianType> cstr_proj_jacs;
   /// Masks for active constraint sets
@@ -87,6 +92,15 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
   std::vector<VectorXs> dlams;
   /// @}
 
+  /// @name Iterative refinement of the primal-dual step
+  /// @{
+  gar::LQRKktResidualTpl<Scalar> lqr_residual; //< KKT residual of the step
+  std::vector<VectorXs> dxs_corr;
+  std::vector<VectorXs> dus_corr;
+  std::vector<VectorXs> dvs_corr;
+  std::vector<VectorXs> dlams_corr;
+  /// @}
+
   /// @name Previous external/proximal iterates
   /// @{
   std::vector<VectorXs> prev_xs;
@@ -108,6 +122,17 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
   /// Overall subproblem termination criterion.
   Scalar inner_criterion = 0.;
 
+  /// @brief Which quantities in problem_data are up-to-date at the current
+  /// iterate (stored in the solver results).
+  enum class DataStatus {
+    STALE,         //< the data was computed at another point
+    EVALUATED,     //< function values are current
+    DIFFERENTIATED //< function values and derivatives are current
+  };
+  DataStatus problem_data_status = DataStatus::STALE;
+  /// Step size of the last trial iterate evaluated into problem_data.
+  Scalar trial_alpha = 0.;
+
   WorkspaceTpl() : Base() {}
   WorkspaceTpl(const TrajOptProblemTpl<Scalar> &problem);
 
@@ -119,6 +144,16 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
 
   void cycleLeft();
 
+  /// @brief Make the trial primal-dual iterate the current one in @p results.
+  /// @details The trajectory buffers are swapped, in constant time. The trial
+  /// buffers then hold the previous iterate and are overwritten by the next
+  /// forward pass; references to the vectors of @p results remain valid.
+  void acceptTrialIterate(ResultsTpl<Scalar> &results);
+
+  /// @brief Swap everything a forward pass computes (trial iterate, problem
+  /// data, multiplier estimates...) with @p other, in constant time.
+  void swapTrialData(WorkspaceTpl &other);
+
   template <typename T>
   friend std::ostream &operator<<(std::ostream &oss,
                                   const WorkspaceTpl<T> &self);
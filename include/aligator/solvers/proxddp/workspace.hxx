@@ -3,6 +3,7 @@
 #pragma once
 
 #include "./workspace.hpp"
+#include "./results.hpp"
 #include "aligator/gar/utils.hpp"
 
 namespace aligator {
@@ -69,15 +70,18 @@ WorkspaceTpl<Scalar>::WorkspaceTpl(const TrajOptProblemTpl<Scalar> &problem)
 
   // initial condition
   long nc0 = (long)problem.init_condition_->nr;
-  lqr_problem = LQRProblemType(knots, nc0);
+  lqr_problem = LQRProblemType(std::move(knots), nc0);
   std::tie(dxs, dus, dvs, dlams) =
       gar::lqrInitializeSolution(lqr_problem); // lqr subproblem variables
+  lqr_residual = gar::LQRKktResidualTpl<Scalar>(lqr_problem);
+  std::tie(dxs_corr, dus_corr, dvs_corr, dlams_corr) = {dxs, dus, dvs, dlams};
   Lxs = dxs;
   Lus = dus;
   Lvs = dvs;
   Lds = dlams;
   cstr_lx_corr = Lxs;
   cstr_lu_corr = Lus;
+  cstr_scaled_Lvs = Lvs;
 
   stage_inner_crits.setZero();
   state_dual_infeas.setZero();
@@ -87,11 +91,16 @@ WorkspaceTpl<Scalar>::WorkspaceTpl(const TrajOptProblemTpl<Scalar> &problem)
 template <typename Scalar> void WorkspaceTpl<Scalar>::cycleLeft() {
   Base::cycleLeft();
 
-  rotate_vec_left(cstr_scalers);
-  rotate_vec_left(Lxs);
-  rotate_vec_left(Lus);
-  rotate_vec_left(Lds);
-  rotate_vec_left(Lvs);
+  // the terminal constraints' scaler, if any, stays in place
+  rotate_vec_left(cstr_scalers, 0, long(cstr_scalers.size() - this->nsteps));
+  // the LQ buffers have a terminal knot, which stays in place
+  rotate_vec_left(Lxs, 0, 1);
+  rotate_vec_left(Lus, 0, long(Lus.size() - this->nsteps));
+  rotate_vec_left(Lds, 1);
+  rotate_vec_left(Lvs, 0, 1);
+  rotate_vec_left(cstr_scaled_Lvs, 0, 1);
+  rotate_vec_left(cstr_lx_corr, 0, 1);
+  rotate_vec_left(cstr_lu_corr, 0, long(cstr_lu_corr.size() - this->nsteps));
 
   rotate_vec_left(trial_lams, 1);
   rotate_vec_left(lams_plus, 1);
@@ -100,10 +109,15 @@ template <typename Scalar> void WorkspaceTpl<Scalar>::cycleLeft() {
   rotate_vec_left(cstr_proj_jacs, 0, 1);
   rotate_vec_left(active_constraints, 0, 1);
 
-  rotate_vec_left(dxs);
-  rotate_vec_left(dus);
+  rotate_vec_left(dxs, 0, 1);
+  rotate_vec_left(dus, 0, long(dus.size() - this->nsteps));
   rotate_vec_left(dvs, 0, 1);
   rotate_vec_left(dlams, 1);
+  lqr_residual.cycleLeft();
+  rotate_vec_left(dxs_corr, 0, 1);
+  rotate_vec_left(dus_corr, 0, long(dus_corr.size() - this->nsteps));
+  rotate_vec_left(dvs_corr, 0, 1);
+  rotate_vec_left(dlams_corr, 1);
 
   rotate_vec_left(prev_xs);
   rotate_vec_left(prev_us);
@@ -113,6 +127,37 @@ template <typename Scalar> void WorkspaceTpl<Scalar>::cycleLeft() {
   rotate_vec_left(stage_infeasibilities, 0, 1);
 }
 
+template <typename Scalar>
+void WorkspaceTpl<Scalar>::acceptTrialIterate(ResultsTpl<Scalar> &results) {
+  results.xs.swap(trial_xs);
+  results.us.swap(trial_us);
+  results.vs.swap(trial_vs);
+  results.lams.swap(trial_lams);
+}
+
+template <typename Scalar>
+void WorkspaceTpl<Scalar>::swapTrialData(WorkspaceTpl &other) {
+  using std::swap;
+  swap(trial_xs, other.trial_xs);
+  swap(trial_us, other.trial_us);
+  swap(trial_vs, other.trial_vs);
+  swap(trial_lams, other.trial_lams);
+  swap(trial_alpha, other.trial_alpha);
+  swap(problem_data, other.problem_data);
+  swap(dyn_slacks, other.dyn_slacks);
+  swap(dxs, other.dxs);
+  swap(dus, other.dus);
+  swap(dvs, other.dvs);
+  swap(dlams, other.dlams);
+  swap(lams_plus, other.lams_plus);
+  swap(lams_pdal, other.lams_pdal);
+  swap(vs_plus, other.vs_plus);
+  swap(Lds, other.Lds);
+  swap(Lvs, other.Lvs);
+  swap(shifted_constraints, other.shifted_constraints);
+  swap(active_constraints, other.active_constraints);
+}
+
 template <typename Scalar>
 std::ostream &operator<<(std::ostream &oss, const WorkspaceTpl<Scalar> &self) {
   oss << "Workspace {" << fmt::format("\n  nsteps:         {:d}", self.nsteps)
@@ -4,6 +4,27 @@
 #include <omp.h>
 #endif
 
+#include <Eigen/Core>
+#include <tracy/Tracy.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace aligator {
 
 /// Utilities to set parallelism options.
@@ -41,4 +62,300 @@ inline void set_default_options(std::size_t, bool = true) {}
 
 } // namespace omp
 
+/// @brief Which threading backend to use for the parallel parts of the
+/// solvers.
+enum class ThreadingBackend {
+  /// Open an OpenMP parallel region on every call.
+  OPENMP,
+  /// Dispatch onto a persistent pool of worker threads (see ThreadPool).
+  THREAD_POOL
+};
+
+namespace internal {
+/// Hint to the CPU that we are in a spin-wait loop.
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+/// Whether the current thread is executing a task for a ThreadPool.
+inline bool &in_thread_pool() {
+  static thread_local bool flag = false;
+  return flag;
+}
+
+/// @brief Keeps Eigen single-threaded while parallel loops are running.
+/// @details Eigen's number of threads is a process-wide setting: it is saved
+/// when the first loop starts, and restored when the last one ends, so that
+/// nested or concurrent loops do not reset it while others still run.
+class EigenThreadsGuard {
+public:
+  EigenThreadsGuard() {
+    std::lock_guard<std::mutex> lock(mutex());
+    if (depth()++ == 0) {
+      saved() = Eigen::nbThreads();
+      Eigen::setNbThreads(1);
+    }
+  }
+  EigenThreadsGuard(const EigenThreadsGuard &) = delete;
+  EigenThreadsGuard &operator=(const EigenThreadsGuard &) = delete;
+  ~EigenThreadsGuard() {
+    std::lock_guard<std::mutex> lock(mutex());
+    if (--depth() == 0)
+      Eigen::setNbThreads(saved());
+  }
+
+private:
+  static std::mutex &mutex() {
+    static std::mutex m;
+    return m;
+  }
+  static std::size_t &depth() {
+    static std::size_t d = 0;
+    return d;
+  }
+  static int &saved() {
+    static int n = 0;
+    return n;
+  }
+};
+} // namespace internal
+
+/// @brief A persistent pool of worker threads for fork-join parallelism.
+///
+/// @details The worker threads are created once, and wait for work by
+/// spinning for a while before parking on a condition variable. Dispatching a
+/// parallel loop hence costs a few atomic operations instead of the creation
+/// of an OpenMP region. The calling thread takes part in the work. Worker
+/// threads can optionally be pinned to the CPU cores the process may run on
+/// (Linux only).
+///
+/// Unlike omp::set_default_options(), nothing here touches the process-wide
+/// OpenMP settings.
+class ThreadPool {
+public:
+  /// @param num_threads  Total number of threads, including the caller.
+  /// @param pin_threads  Pin worker `k` to the `k`-th CPU core of the
+  /// process' affinity mask, modulo its size (the calling thread is left
+  /// alone).
+  explicit ThreadPool(std::size_t num_threads, bool pin_threads = false)
+      : num_threads_(std::max(num_threads, std::size_t(1))),
+        pin_threads_(pin_threads) {
+    const std::size_t num_workers = num_threads_ - 1;
+    workers_.reserve(num_workers);
+    std::vector<int> cpus = availableCpus();
+    // spinning is counter-productive when the machine is oversubscribed
+    if (num_threads_ > cpus.size())
+      spin_count_.store(0, std::memory_order_relaxed);
+    for (std::size_t k = 1; k <= num_workers; k++) {
+      workers_.emplace_back([this, k] { workerLoop(k); });
+#ifdef __linux__
+      if (pin_threads) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpus[k % cpus.size()], &cpuset);
+        pthread_setaffinity_np(workers_.back().native_handle(),
+                               sizeof(cpu_set_t), &cpuset);
+      }
+#else
+      (void)pin_threads;
+#endif
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    stop_.store(true, std::memory_order_relaxed);
+    wakeWorkers();
+    for (auto &w : workers_)
+      w.join();
+  }
+
+  /// Total number of threads in the pool, including the calling thread.
+  std::size_t numThreads() const { return num_threads_; }
+
+  /// Whether the worker threads were pinned to CPU cores.
+  bool pinsThreads() const { return pin_threads_; }
+
+  /// Number of spin iterations before an idle worker parks itself.
+  void setSpinCount(std::size_t count) {
+    spin_count_.store(count, std::memory_order_relaxed);
+  }
+
+  /// @brief Call `f(i)` for all `i` in `[0, n)`, in parallel.
+  /// @details Indices are handed out one at a time to the first available
+  /// thread. This blocks until all the calls have returned; the first
+  /// exception thrown by a call, if any, is rethrown. A nested call from
+  /// inside the pool runs serially.
+  template <typename F> void parallelFor(std::size_t n, F &&f) {
+    using Fn = std::remove_reference_t<F>;
+    if (n == 0)
+      return;
+    if (workers_.empty() || n == 1 || internal::in_thread_pool()) {
+      for (std::size_t i = 0; i < n; i++)
+        f(i);
+      return;
+    }
+
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+    task_ctx_ = const_cast<void *>(static_cast<const void *>(&f));
+    task_fn_ = [](void *ctx, std::size_t i) { (*static_cast<Fn *>(ctx))(i); };
+    task_size_ = n;
+    error_ = nullptr;
+    next_.store(0, std::memory_order_relaxed);
+    pending_.store(workers_.size(), std::memory_order_relaxed);
+    // publish the task
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (num_parked_.load(std::memory_order_seq_cst) > 0)
+      wakeWorkers();
+
+    runTask();
+
+    // wait for the workers to be done
+    const std::size_t spin_count = spin_count_.load(std::memory_order_relaxed);
+    for (std::size_t it = 0; pending_.load(std::memory_order_acquire) > 0;
+         it++) {
+      if (it < spin_count)
+        internal::cpu_relax();
+      else
+        std::this_thread::yield();
+    }
+    if (error_)
+      std::rethrow_exception(error_);
+  }
+
+private:
+  /// The CPU cores the process may run on.
+  static std::vector<int> availableCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+      for (int c = 0; c < CPU_SETSIZE; c++)
+        if (CPU_ISSET(c, &cpuset))
+          cpus.push_back(c);
+    }
+#endif
+    if (cpus.empty()) {
+      const unsigned n = std::max(std::thread::hardware_concurrency(), 1u);
+      for (unsigned c = 0; c < n; c++)
+        cpus.push_back(int(c));
+    }
+    return cpus;
+  }
+
+  void wakeWorkers() {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    park_cv_.notify_all();
+  }
+
+  /// Execute the current task's indices until there are none left.
+  void runTask() {
+    internal::in_thread_pool() = true;
+    std::size_t i;
+    while ((i = next_.fetch_add(1, std::memory_order_relaxed)) < task_size_) {
+      try {
+        task_fn_(task_ctx_, i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (!error_)
+          error_ = std::current_exception();
+      }
+    }
+    internal::in_thread_pool() = false;
+  }
+
+  void workerLoop(std::size_t k) {
+    char thread_name[32];
+    std::snprintf(thread_name, sizeof(thread_name), "aligator_worker%d",
+                  int(k));
+    tracy::SetThreadName(thread_name);
+    std::size_t seen = 0;
+    while (true) {
+      std::size_t epoch = epoch_.load(std::memory_order_acquire);
+      const std::size_t spin_count =
+          spin_count_.load(std::memory_order_relaxed);
+      for (std::size_t it = 0; epoch == seen && it < spin_count; it++) {
+        internal::cpu_relax();
+        epoch = epoch_.load(std::memory_order_acquire);
+      }
+      if (epoch == seen && !stop_.load(std::memory_order_relaxed)) {
+        std::unique_lock<std::mutex> lock(park_mutex_);
+        num_parked_.fetch_add(1, std::memory_order_seq_cst);
+        park_cv_.wait(lock, [&] {
+          epoch = epoch_.load(std::memory_order_seq_cst);
+          return epoch != seen || stop_.load(std::memory_order_relaxed);
+        });
+        num_parked_.fetch_sub(1, std::memory_order_relaxed);
+      }
+      if (stop_.load(std::memory_order_relaxed))
+        return;
+      seen = epoch;
+      runTask();
+      pending_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+
+  std::size_t num_threads_;
+  bool pin_threads_;
+  std::vector<std::thread> workers_;
+
+  // current task
+  void *task_ctx_ = nullptr;
+  void (*task_fn_)(void *, std::size_t) = nullptr;
+  std::size_t task_size_ = 0;
+  std::exception_ptr error_;
+  std::mutex error_mutex_;
+  std::atomic<std::size_t> next_{0};
+  std::atomic<std::size_t> pending_{0};
+
+  // synchronization
+  std::mutex dispatch_mutex_;
+  std::atomic<std::size_t> epoch_{0};
+  std::atomic<std::size_t> num_parked_{0};
+  std::atomic<std::size_t> spin_count_{1u << 16};
+  std::atomic<bool> stop_{false};
+  std::mutex park_mutex_;
+  std::condition_variable park_cv_;
+};
+
+/// @brief Call `f(i)` for all `i` in `[0, n)` in parallel: on @p pool if it
+/// is non-null, otherwise in an OpenMP region with @p num_threads threads.
+/// Eigen runs single-threaded meanwhile, see internal::EigenThreadsGuard.
+/// In both cases, the first exception thrown by a call is rethrown once all
+/// the calls have returned.
+template <typename F>
+void parallel_for(ThreadPool *pool, std::size_t num_threads, std::size_t n,
+                  F &&f) {
+  internal::EigenThreadsGuard eigen_guard;
+  if (pool) {
+    pool->parallelFor(n, f);
+  } else {
+    // exceptions must not escape an OpenMP region
+    std::exception_ptr error;
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+    for (std::size_t i = 0; i < n; i++) {
+      try {
+        f(i);
+      } catch (...) {
+#pragma omp critical(aligator_parallel_for_error)
+        {
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+    }
+    if (error)
+      std::rethrow_exception(error);
+  }
+}
+
 } // namespace aligator
@@ -3,9 +3,9 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <string_view>
 #include <vector>
-#include <map>
 
 namespace aligator {
 using uint = unsigned int;
@@ -34,9 +34,13 @@ static const std::array<LogColumn, 11> BASIC_KEYS = {
      {"mu", dbl_format, 8U}}};
 
 /// @brief  A table logging utility to log the trace of the numerical solvers.
+/// @details Entries are formatted into fixed-size buffers: once the columns
+/// have been added, logging does not allocate memory.
 struct Logger {
   bool active = true;
   static constexpr std::string_view join_str = "｜";
+  /// Maximum size of a formatted entry; longer entries are truncated.
+  static constexpr std::size_t max_entry_size = 32;
 
   Logger();
 
@@ -52,10 +56,18 @@ struct Logger {
   void addEntry(std::string_view name, size_t val);
 
 protected:
-  // sizes and formats
-  std::vector<std::string_view> m_colNames;
-  std::map<std::string_view, std::pair<uint, std::string>> m_colSpecs;
-  std::map<std::string_view, std::string> m_currentLine;
+  struct Column {
+    std::string name;   //< copied when the column is added
+    std::string format; //< copied when the column is added
+    uint width;
+    std::array<char, max_entry_size> value; //< current formatted entry
+    std::size_t size;                       //< size of the current entry
+  };
+  /// Get the column called @p name, or nullptr.
+  Column *findColumn(std::string_view name);
+
+  // names, sizes, formats and current entries
+  std::vector<Column> m_columns;
 };
 
 } // namespace aligator
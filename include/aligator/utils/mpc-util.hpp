@@ -3,6 +3,8 @@
 /// @copyright Copyright (C) 2022 LAAS-CNRS, INRIA
 #pragma once
 
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+
 #include <vector>
 #include <algorithm>
 
@@ -21,4 +23,18 @@ void rotate_vec_left(std::vector<T, Alloc> &v, long n_head = 0,
   std::rotate(beg, beg + 1, end);
 }
 
+/// @brief Set @p x to the neutral element of @p space.
+/// @details For vector spaces, the zero vector is written in place, which does
+/// not allocate if @p x already has the right size.
+template <typename Scalar>
+void set_neutral_element(
+    const proxsuite::nlp::ManifoldAbstractTpl<Scalar> &space,
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1> &x) {
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<Scalar, Eigen::Dynamic>;
+  if (dynamic_cast<const VectorSpace *>(&space))
+    x.setZero(space.nx());
+  else
+    x = space.neutral();
+}
+
 } // namespace aligator
@@ -0,0 +1,8 @@
+#include "aligator/modelling/costs/fused-cost-stack.hpp"
+
+namespace aligator {
+
+template struct FusedCostStackTpl<context::Scalar>;
+template struct FusedCostStackDataTpl<context::Scalar>;
+
+} // namespace aligator
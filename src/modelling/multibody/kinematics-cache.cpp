@@ -0,0 +1,8 @@
+#include "aligator/modelling/multibody/kinematics-cache.hpp"
+
+namespace aligator {
+
+template struct KinematicsCacheModelTpl<context::Scalar>;
+template struct KinematicsCacheDataTpl<context::Scalar>;
+
+} // namespace aligator
@@ -0,0 +1,7 @@
+#include "aligator/solvers/proxddp/batch-solver.hpp"
+
+namespace aligator {
+
+template struct SolverProxDDPBatchTpl<context::Scalar>;
+
+} // namespace aligator
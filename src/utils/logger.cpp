@@ -1,41 +1,37 @@
 #include "aligator/utils/logger.hpp"
 
 #include <fmt/color.h>
-#include <fmt/ranges.h>
-#include <cassert>
+#include <algorithm>
 
 namespace aligator {
-Logger::Logger() {}
+Logger::Logger() { m_columns.reserve(BASIC_KEYS.size()); }
 
 void Logger::printHeadline() {
   if (!active)
     return;
   static constexpr char fstr[] = "{:^{}s}";
-  std::vector<std::string> formattedCols;
-  for (const auto name : m_colNames) {
-    const auto spec = m_colSpecs[name];
-    formattedCols.push_back(fmt::format(fstr, name, spec.first));
+  for (std::size_t i = 0; i < m_columns.size(); i++) {
+    const Column &col = m_columns[i];
+    if (i > 0)
+      fmt::print(fmt::emphasis::bold, "{}", join_str);
+    fmt::print(fmt::emphasis::bold, fstr, col.name, col.width);
   }
-  fmt::print(fmt::emphasis::bold, "{}", fmt::join(formattedCols, join_str));
   fmt::print("\n");
 }
 
 void Logger::log() {
   if (!active)
     return;
-  std::vector<std::string> cols;
-  for (const auto name : m_colNames) {
-    auto line = m_currentLine[name];
-    cols.push_back(line);
+  for (std::size_t i = 0; i < m_columns.size(); i++) {
+    const Column &col = m_columns[i];
+    if (i > 0)
+      fmt::print("{}", join_str);
+    fmt::print("{}", std::string_view(col.value.data(), col.size));
   }
-  fmt::print("{}\n", fmt::join(cols, join_str));
+  fmt::print("\n");
 }
 
-void Logger::reset() {
-  m_colNames.clear();
-  m_colSpecs.clear();
-  m_currentLine.clear();
-}
+void Logger::reset() { m_columns.clear(); }
 
 void Logger::finish(bool conv) {
   if (!active)
@@ -49,18 +45,35 @@ void Logger::finish(bool conv) {
 
 void Logger::addColumn(std::string_view name, uint width,
                        std::string_view format) {
-  m_colNames.push_back(name);
-  m_colSpecs[name] = {width, std::string(format)};
+  // the name and format may not outlive this call: copy them
+  m_columns.push_back(
+      {std::string(name), std::string(format), width, {}, 0});
+}
+
+Logger::Column *Logger::findColumn(std::string_view name) {
+  for (Column &col : m_columns) {
+    if (col.name == name)
+      return &col;
+  }
+  return nullptr;
 }
 
 void Logger::addEntry(std::string_view name, double val) {
-  const auto spec = m_colSpecs[name];
-  m_currentLine[name] = fmt::format(spec.second, val, spec.first);
+  Column *col = findColumn(name);
+  if (!col)
+    return;
+  auto res = fmt::format_to_n(col->value.data(), max_entry_size,
+                              fmt::runtime(col->format), val, col->width);
+  col->size = std::min(res.size, max_entry_size);
 }
 
 void Logger::addEntry(std::string_view name, size_t val) {
-  const auto spec = m_colSpecs[name];
-  m_currentLine[name] = fmt::format(spec.second, val, spec.first);
+  Column *col = findColumn(name);
+  if (!col)
+    return;
+  auto res = fmt::format_to_n(col->value.data(), max_entry_size,
+                              fmt::runtime(col->format), val, col->width);
+  col->size = std::min(res.size, max_entry_size);
 }
 
 } // namespace aligator
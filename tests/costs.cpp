@@ -4,6 +4,10 @@
 #include "aligator/modelling/state-error.hpp"
 
 #include "aligator/modelling/costs/quad-state-cost.hpp"
+#include "aligator/modelling/costs/quad-costs.hpp"
+#include "aligator/modelling/costs/fused-cost-stack.hpp"
+#include "aligator/modelling/linear-function.hpp"
+#include "aligator/modelling/autodiff/forward-autodiff.hpp"
 #include <proxsuite-nlp/modelling/spaces/pinocchio-groups.hpp>
 #include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
 
@@ -102,4 +106,271 @@ BOOST_AUTO_TEST_CASE(quad_state_highdim) {
   }
 }
 
+/// Quadratic residual cost whose value is overridden.
+struct ShiftedQuadraticResidualCost : QuadraticResidualCost {
+  using QuadraticResidualCost::QuadraticResidualCost;
+  void evaluate(const context::ConstVectorRef &x,
+                const context::ConstVectorRef &u,
+                context::CostData &data) const override {
+    QuadraticResidualCost::evaluate(x, u, data);
+    data.value_ += 1.;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(fused_cost_stack) {
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<T>;
+  const int ndx = 8;
+  const int nu = 3;
+  const auto space = std::make_shared<VectorSpace>(ndx);
+
+  auto random_spd = [](int n) -> MatrixXs {
+    MatrixXs A = MatrixXs::Random(n, n);
+    return A * A.transpose() + MatrixXs::Identity(n, n);
+  };
+
+  std::vector<shared_ptr<CostAbstractTpl<T>>> comps;
+  std::vector<T> weights;
+  for (int k = 0; k < 3; k++) {
+    comps.push_back(std::make_shared<QuadraticStateCostTpl<T>>(
+        space, nu, VectorXs::Random(ndx), random_spd(ndx)));
+    weights.push_back(0.5 + k);
+  }
+  comps.push_back(std::make_shared<QuadraticControlCostTpl<T>>(
+      space, VectorXs::Random(nu), random_spd(nu)));
+  weights.push_back(2.);
+  const int nr = 4;
+  auto lin = std::make_shared<LinearFunctionTpl<T>>(
+      MatrixXs::Random(nr, ndx), MatrixXs::Random(nr, nu),
+      MatrixXs::Zero(nr, ndx), VectorXs::Random(nr));
+  comps.push_back(
+      std::make_shared<QuadraticResidualCost>(space, lin, random_spd(nr)));
+  weights.push_back(1.5);
+  // not fused
+  comps.push_back(std::make_shared<QuadraticCostTpl<T>>(random_spd(ndx),
+                                                        random_spd(nu)));
+  weights.push_back(0.1);
+  comps.push_back(std::make_shared<ShiftedQuadraticResidualCost>(
+      space, lin, random_spd(nr)));
+  weights.push_back(0.7);
+
+  CostStackTpl<T> stack(space, nu, comps, weights);
+  FusedCostStackTpl<T> fused(space, nu, comps, weights);
+  auto data = stack.createData();
+  auto fdata = fused.createData();
+  const auto &fd = static_cast<const FusedCostStackDataTpl<T> &>(*fdata);
+  // state-only, control-only and general residuals
+  BOOST_CHECK_EQUAL(fd.groups[0].ids.size(), 3);
+  BOOST_CHECK_EQUAL(fd.groups[1].ids.size(), 1);
+  BOOST_CHECK_EQUAL(fd.groups[2].ids.size(), 1);
+  BOOST_CHECK_EQUAL(fd.groups[0].residuals.size(), 3 * ndx);
+  BOOST_CHECK_EQUAL(fd.other_ids.size(), 2);
+
+  for (int k = 0; k < 10; k++) {
+    const VectorXs x0 = VectorXs::Random(ndx);
+    const VectorXs u0 = VectorXs::Random(nu);
+    stack.evaluate(x0, u0, *data);
+    stack.computeGradients(x0, u0, *data);
+    stack.computeHessians(x0, u0, *data);
+    fused.evaluate(x0, u0, *fdata);
+    fused.computeGradients(x0, u0, *fdata);
+    fused.computeHessians(x0, u0, *fdata);
+    BOOST_CHECK_CLOSE(fdata->value_, data->value_, 1e-10);
+    BOOST_CHECK(fdata->grad_.isApprox(data->grad_));
+    BOOST_CHECK(fdata->hess_.isApprox(data->hess_));
+  }
+}
+
+/// Affine function \f$Ax + Bu + Cy + d\f$, written for any scalar type.
+struct AffineFunctor {
+  MatrixXs A, B, C;
+  VectorXs d;
+
+  template <typename S> using Vec = Eigen::Matrix<S, Eigen::Dynamic, 1>;
+
+  template <typename S>
+  void operator()(const Eigen::Ref<const Vec<S>> &x,
+                  const Eigen::Ref<const Vec<S>> &u,
+                  const Eigen::Ref<const Vec<S>> &y,
+                  Eigen::Ref<Vec<S>> out) const {
+    (*this)(x, u, out);
+    out.noalias() += C.cast<S>() * y;
+  }
+
+  template <typename S>
+  void operator()(const Eigen::Ref<const Vec<S>> &x,
+                  const Eigen::Ref<const Vec<S>> &u,
+                  Eigen::Ref<Vec<S>> out) const {
+    out = d.cast<S>();
+    out.noalias() += A.cast<S>() * x;
+    out.noalias() += B.cast<S>() * u;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(autodiff_function) {
+  const int ndx = 4;
+  const int nu = 2;
+  const int nr = 3;
+  AffineFunctor f{MatrixXs::Random(nr, ndx), MatrixXs::Random(nr, nu),
+                  MatrixXs::Random(nr, ndx), VectorXs::Random(nr)};
+  LinearFunctionTpl<T> lin(f.A, f.B, f.C, f.d);
+  autodiff::AutoDiffFunctionTpl<T, AffineFunctor> ad(ndx, nu, ndx, nr, f);
+  autodiff::AutoDiffFunctionTpl<T, AffineFunctor, 2 * ndx + nu> ad_fixed(
+      ndx, nu, ndx, nr, f);
+  BOOST_CHECK_THROW((autodiff::AutoDiffFunctionTpl<T, AffineFunctor, 3>(
+                        ndx, nu, ndx, nr, f)),
+                    std::domain_error);
+
+  auto ldata = lin.createData();
+  auto data = ad.createData();
+  auto data_fixed = ad_fixed.createData();
+  const VectorXs x0 = VectorXs::Random(ndx);
+  const VectorXs u0 = VectorXs::Random(nu);
+  const VectorXs y0 = VectorXs::Random(ndx);
+  lin.evaluate(x0, u0, y0, *ldata);
+  lin.computeJacobians(x0, u0, y0, *ldata);
+  ad.evaluate(x0, u0, y0, *data);
+  BOOST_CHECK(data->value_.isApprox(ldata->value_));
+  data->value_.setZero();
+  ad.computeJacobians(x0, u0, y0, *data);
+  ad_fixed.computeJacobians(x0, u0, y0, *data_fixed);
+  BOOST_CHECK(data->value_.isApprox(ldata->value_));
+  BOOST_CHECK(data->jac_buffer_.isApprox(ldata->jac_buffer_));
+  BOOST_CHECK(data_fixed->jac_buffer_.isApprox(ldata->jac_buffer_));
+}
+
+/// Nonlinear function of \f$x \in \mathbb{R}^4, u \in \mathbb{R}^2,
+/// y \in \mathbb{R}^4\f$ with 3 outputs, and its analytic Jacobian.
+struct NonlinearFunctor {
+  template <typename S> using Vec = Eigen::Matrix<S, Eigen::Dynamic, 1>;
+
+  template <typename S>
+  void operator()(const Eigen::Ref<const Vec<S>> &x,
+                  const Eigen::Ref<const Vec<S>> &u,
+                  const Eigen::Ref<const Vec<S>> &y,
+                  Eigen::Ref<Vec<S>> out) const {
+    using std::cos;
+    using std::exp;
+    using std::sin;
+    out[0] = sin(x[0]) * u[0] + exp(y[1]);
+    out[1] = x[1] * x[2] * exp(u[1]);
+    out[2] = cos(x[3] * y[0]) + u[0] * u[1] + x[0] * x[0];
+  }
+
+  /// Same as above, with \f$y = (1, 0, 0, 0)\f$.
+  template <typename S>
+  void operator()(const Eigen::Ref<const Vec<S>> &x,
+                  const Eigen::Ref<const Vec<S>> &u,
+                  Eigen::Ref<Vec<S>> out) const {
+    using std::cos;
+    using std::exp;
+    using std::sin;
+    out[0] = sin(x[0]) * u[0] + 1.;
+    out[1] = x[1] * x[2] * exp(u[1]);
+    out[2] = cos(x[3]) + u[0] * u[1] + x[0] * x[0];
+  }
+
+  /// Jacobian with respect to \f$(x, u, y)\f$.
+  static MatrixXs jacobian(const VectorXs &x, const VectorXs &u,
+                           const VectorXs &y) {
+    MatrixXs J = MatrixXs::Zero(3, 10);
+    J(0, 0) = std::cos(x[0]) * u[0];
+    J(0, 4) = std::sin(x[0]);
+    J(0, 7) = std::exp(y[1]);
+    J(1, 1) = x[2] * std::exp(u[1]);
+    J(1, 2) = x[1] * std::exp(u[1]);
+    J(1, 5) = x[1] * x[2] * std::exp(u[1]);
+    J(2, 0) = 2 * x[0];
+    J(2, 3) = -std::sin(x[3] * y[0]) * y[0];
+    J(2, 4) = u[1];
+    J(2, 5) = u[0];
+    J(2, 6) = -std::sin(x[3] * y[0]) * x[3];
+    return J;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(autodiff_nonlinear) {
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<T>;
+  const int ndx = 4;
+  const int nu = 2;
+  const int nr = 3;
+  autodiff::AutoDiffFunctionTpl<T, NonlinearFunctor> ad(ndx, nu, ndx, nr);
+  autodiff::AutoDiffFunctionTpl<T, NonlinearFunctor, 2 * ndx + nu> ad_fixed(
+      ndx, nu, ndx, nr);
+  const auto space = std::make_shared<VectorSpace>(ndx);
+  MatrixXs weights = MatrixXs::Random(nr, nr);
+  weights = weights * weights.transpose();
+  autodiff::AutoDiffResidualCostTpl<T, NonlinearFunctor> cost(space, nu,
+                                                              weights);
+  autodiff::AutoDiffResidualCostTpl<T, NonlinearFunctor, ndx + nu> cost_fixed(
+      space, nu, weights);
+
+  const std::array<const StageFunctionTpl<T> *, 2> funcs{&ad, &ad_fixed};
+  const std::array<const CostAbstractTpl<T> *, 2> costs{&cost, &cost_fixed};
+  for (int k = 0; k < 5; k++) {
+    const VectorXs x0 = VectorXs::Random(ndx);
+    const VectorXs u0 = VectorXs::Random(nu);
+    const VectorXs y0 = VectorXs::Random(ndx);
+    VectorXs r0(nr);
+    NonlinearFunctor{}.operator()<T>(x0, u0, y0, r0);
+    const MatrixXs J = NonlinearFunctor::jacobian(x0, u0, y0);
+    for (const StageFunctionTpl<T> *f : funcs) {
+      auto data = f->createData();
+      f->evaluate(x0, u0, y0, *data);
+      BOOST_CHECK(data->value_.isApprox(r0));
+      data->value_.setZero();
+      f->computeJacobians(x0, u0, y0, *data);
+      BOOST_CHECK(data->value_.isApprox(r0));
+      BOOST_CHECK(data->jac_buffer_.isApprox(J));
+    }
+
+    // the cost residual is the function at y = (1, 0, 0, 0)
+    const VectorXs e0 = VectorXs::Unit(ndx, 0);
+    NonlinearFunctor{}.operator()<T>(x0, u0, e0, r0);
+    const MatrixXs Jc =
+        NonlinearFunctor::jacobian(x0, u0, e0).leftCols(ndx + nu);
+    for (const CostAbstractTpl<T> *c : costs) {
+      auto data = c->createData();
+      c->evaluate(x0, u0, *data);
+      c->computeGradients(x0, u0, *data);
+      c->computeHessians(x0, u0, *data);
+      BOOST_CHECK_CLOSE(data->value_, 0.5 * r0.dot(weights * r0), 1e-10);
+      BOOST_CHECK(data->grad_.isApprox(Jc.transpose() * weights * r0));
+      BOOST_CHECK(data->hess_.isApprox(Jc.transpose() * weights * Jc));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(autodiff_residual_cost) {
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<T>;
+  const int ndx = 5;
+  const int nu = 3;
+  const int nr = 4;
+  const auto space = std::make_shared<VectorSpace>(ndx);
+  AffineFunctor f{MatrixXs::Random(nr, ndx), MatrixXs::Random(nr, nu),
+                  MatrixXs::Zero(nr, ndx), VectorXs::Random(nr)};
+  MatrixXs weights = MatrixXs::Random(nr, nr);
+  weights = weights * weights.transpose();
+
+  QuadraticResidualCost ref(
+      space, std::make_shared<LinearFunctionTpl<T>>(f.A, f.B, f.C, f.d),
+      weights);
+  autodiff::AutoDiffResidualCostTpl<T, AffineFunctor> cost(space, nu, weights,
+                                                           f);
+  auto rdata = ref.createData();
+  auto data = cost.createData();
+  for (int k = 0; k < 5; k++) {
+    const VectorXs x0 = VectorXs::Random(ndx);
+    const VectorXs u0 = VectorXs::Random(nu);
+    ref.evaluate(x0, u0, *rdata);
+    ref.computeGradients(x0, u0, *rdata);
+    ref.computeHessians(x0, u0, *rdata);
+    cost.evaluate(x0, u0, *data);
+    cost.computeGradients(x0, u0, *data);
+    cost.computeHessians(x0, u0, *data);
+    BOOST_CHECK_CLOSE(data->value_, rdata->value_, 1e-10);
+    BOOST_CHECK(data->grad_.isApprox(rdata->grad_));
+    BOOST_CHECK(data->hess_.isApprox(rdata->hess_));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
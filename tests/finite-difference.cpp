@@ -0,0 +1,93 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/modelling/autodiff/finite-difference.hpp"
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+
+BOOST_AUTO_TEST_SUITE(finite_difference)
+
+using namespace aligator;
+using T = double;
+using context::ConstVectorRef;
+using context::MatrixXs;
+using context::VectorXs;
+using StageFunction = StageFunctionTpl<T>;
+using StageFunctionData = StageFunctionDataTpl<T>;
+using FiniteDifferenceHelper = autodiff::FiniteDifferenceHelper<T>;
+using autodiff::FiniteDifferenceScheme;
+
+/// @f$ r_i = \sin(x_i) x_{i+1} + x_i y_i + \exp(u_{i \bmod n_u}) @f$, whose
+/// Jacobian is banded.
+struct BandedFunction : StageFunction {
+  BandedFunction(const int n, const int nu) : StageFunction(n, nu, n, n) {}
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                const ConstVectorRef &y,
+                StageFunctionData &data) const override {
+    for (int i = 0; i < nr; i++) {
+      const T next = i + 1 < nr ? x[i + 1] : 1.;
+      data.value_[i] =
+          std::sin(x[i]) * next + x[i] * y[i] + std::exp(u[i % nu]);
+    }
+  }
+
+  void computeJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
+                        const ConstVectorRef &y,
+                        StageFunctionData &data) const override {
+    data.jac_buffer_.setZero();
+    for (int i = 0; i < nr; i++) {
+      const T next = i + 1 < nr ? x[i + 1] : 1.;
+      data.Jx_(i, i) = std::cos(x[i]) * next + y[i];
+      if (i + 1 < nr)
+        data.Jx_(i, i + 1) = std::sin(x[i]);
+      data.Ju_(i, i % nu) = std::exp(u[i % nu]);
+      data.Jy_(i, i) = x[i];
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(schemes_colors_threads) {
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<T>;
+  const int n = 12;
+  const int nu = 3;
+  const auto space = std::make_shared<VectorSpace>(n);
+  const auto func = std::make_shared<BandedFunction>(n, nu);
+  const auto ref_data = func->createData();
+
+  const VectorXs x0 = VectorXs::Random(n);
+  const VectorXs u0 = VectorXs::Random(nu);
+  const VectorXs y0 = VectorXs::Random(n);
+  func->evaluate(x0, u0, y0, *ref_data);
+  func->computeJacobians(x0, u0, y0, *ref_data);
+  const MatrixXs pattern = ref_data->jac_buffer_;
+
+  ThreadPool pool(3);
+  for (auto scheme :
+       {FiniteDifferenceScheme::FORWARD, FiniteDifferenceScheme::CENTRAL}) {
+    // forward differences are first-order accurate, central ones second-order
+    const T eps = scheme == FiniteDifferenceScheme::FORWARD ? 1e-7 : 1e-5;
+    const T tol = scheme == FiniteDifferenceScheme::FORWARD ? 1e-5 : 1e-8;
+    for (bool colored : {false, true}) {
+      for (std::size_t num_threads : {1, 3}) {
+        for (ThreadPool *p : {(ThreadPool *)nullptr, &pool}) {
+          FiniteDifferenceHelper fd(space, func, eps);
+          fd.scheme = scheme;
+          fd.num_threads = num_threads;
+          fd.setThreadPool(p);
+          if (colored) {
+            fd.setSparsityPattern(pattern);
+            BOOST_CHECK_LT(fd.numColors(), std::size_t(2 * n + nu));
+          }
+          const auto data = fd.createData();
+          fd.evaluate(x0, u0, y0, *data);
+          fd.computeJacobians(x0, u0, y0, *data);
+          BOOST_CHECK(data->value_.isApprox(ref_data->value_));
+          const T err = (data->jac_buffer_ - ref_data->jac_buffer_)
+                            .lpNorm<Eigen::Infinity>();
+          BOOST_CHECK_LE(err, tol);
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
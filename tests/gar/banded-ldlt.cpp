@@ -0,0 +1,118 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#include <boost/test/unit_test.hpp>
+
+#include "./test_util.hpp"
+#include "aligator/gar/banded-ldlt.hpp"
+#include "aligator/gar/utils.hpp"
+
+using namespace aligator::gar;
+
+BOOST_AUTO_TEST_CASE(banded_ldlt_factorization) {
+  const Eigen::Index n = 40;
+  const Eigen::Index kd = 5;
+  // quasi-definite band matrix
+  MatrixXs dense(n, n);
+  dense.setRandom();
+  dense = (dense + dense.transpose()).eval();
+  for (Eigen::Index i = 0; i < n; i++) {
+    dense(i, i) = (i % 3 == 2 ? -1. : 1.) * (2. * kd + 2.);
+    for (Eigen::Index j = 0; j < n; j++) {
+      if (std::abs(i - j) > kd)
+        dense(i, j) = 0.;
+    }
+  }
+
+  BandedLDLT<double> ldlt(n, kd);
+  BOOST_CHECK_EQUAL(ldlt.bandwidth(), kd);
+  for (Eigen::Index j = 0; j < n; j++)
+    for (Eigen::Index i = j; i <= std::min(n - 1, j + kd); i++)
+      ldlt.coeffRef(i, j) = dense(i, j);
+
+  const VectorXs x = VectorXs::NullaryExpr(n, normal_unary_op{});
+  VectorXs y = VectorXs::Zero(n);
+  BandedLDLT<double>::multiply(ldlt.band, x, y);
+  BOOST_CHECK(y.isApprox(dense * x));
+
+  BOOST_CHECK(ldlt.factorize());
+  BOOST_CHECK_EQUAL(ldlt.numPerturbedPivots, 0);
+  ldlt.solveInPlace(y);
+  BOOST_CHECK(y.isApprox(x, 1e-10));
+}
+
+BOOST_AUTO_TEST_CASE(banded_vs_riccati) {
+  const uint nx = 6;
+  const uint nu = 3;
+  const uint horz = 30;
+  const double mu = 1e-8;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu);
+
+  prox_riccati_t refSolver(problem);
+  refSolver.backward(mu, mu);
+  auto [xs_ref, us_ref, vs_ref, lbdas_ref] = lqrInitializeSolution(problem);
+  refSolver.forward(xs_ref, us_ref, vs_ref, lbdas_ref);
+
+  BandedLDLTSolver<double> solver(problem, 2);
+  BOOST_CHECK_LE(solver.bandwidth(), 2 * nx + nu);
+  BOOST_CHECK(solver.backward(mu, mu));
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  BOOST_CHECK(solver.forward(xs, us, vs, lbdas));
+  BOOST_CHECK_LE(solver.computeResidual(), 1e-10);
+
+  KktError err = computeKktError(problem, xs, us, vs, lbdas, mu, mu);
+  printKktError(err);
+  BOOST_CHECK_LE(err.max, 1e-9);
+  for (uint t = 0; t <= horz; t++) {
+    BOOST_CHECK(xs[t].isApprox(xs_ref[t], 1e-6));
+    BOOST_CHECK(lbdas[t].isApprox(lbdas_ref[t], 1e-6));
+    if (t < horz) {
+      BOOST_CHECK(us[t].isApprox(us_ref[t], 1e-6));
+      BOOST_CHECK(solver.getFeedforward(t).head(nu).isApprox(us[t]));
+      BOOST_CHECK(solver.getFeedback(t).isZero());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(banded_rank_deficient_dynamics) {
+  const uint nx = 4;
+  const uint nu = 2;
+  const uint horz = 10;
+  const double mu = 1e-6;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu);
+  // singular E, and redundant path constraints
+  for (uint t = 0; t < horz; t++) {
+    knot_t &kn = problem.stages[t];
+    knot_t ck(kn.nx, kn.nu, 2, kn.nx2);
+    ck.Q = kn.Q;
+    ck.S = kn.S;
+    ck.R = kn.R;
+    ck.q = kn.q;
+    ck.r = kn.r;
+    ck.A = kn.A;
+    ck.B = kn.B;
+    ck.E = kn.E;
+    ck.E.col(0).setZero();
+    ck.f = kn.f;
+    ck.C.setRandom();
+    ck.C.row(1) = ck.C.row(0);
+    ck.D.setRandom();
+    ck.D.row(1) = ck.D.row(0);
+    ck.d.setRandom();
+    ck.d[1] = ck.d[0];
+    problem.stages[t] = std::move(ck);
+  }
+
+  BandedLDLTSolver<double> solver(problem, 2);
+  BOOST_CHECK(solver.backward(mu, mu));
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  BOOST_CHECK(solver.forward(xs, us, vs, lbdas));
+  BOOST_CHECK_EQUAL(solver.ldlt.numPerturbedPivots, 0);
+
+  auto [kktDense, rhsDense] = lqrDenseMatrix(problem, mu, mu);
+  const VectorXs solDense = kktDense.lu().solve(-rhsDense);
+  BOOST_CHECK(solver.kktSol.isApprox(solDense, 1e-8));
+  KktError err = computeKktError(problem, xs, us, vs, lbdas, mu, mu);
+  printKktError(err);
+  BOOST_CHECK_LE(err.max, 1e-9);
+}
@@ -0,0 +1,95 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#include <boost/test/unit_test.hpp>
+
+#include "./test_util.hpp"
+#include "aligator/gar/batched-riccati.hpp"
+#include "aligator/gar/proximal-riccati.hpp"
+#include "aligator/gar/utils.hpp"
+
+using namespace aligator::gar;
+
+/// Random problem with dynamics E = -I, and constraints on the first half of
+/// the knots.
+static problem_t generate_batch_problem(uint horz, uint nx, uint nu, uint nc) {
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu);
+  for (uint t = 0; t <= horz; t++) {
+    const knot_t &kn = problem.stages[t];
+    knot_t ck(kn.nx, kn.nu, t < horz / 2 ? nc : 0, kn.nx2);
+    ck.Q = kn.Q;
+    ck.S = kn.S;
+    ck.R = kn.R;
+    ck.q = kn.q;
+    ck.r = kn.r;
+    ck.A = kn.A;
+    ck.B = kn.B;
+    ck.E.setIdentity();
+    ck.E *= -1;
+    ck.f = kn.f;
+    ck.C.setRandom();
+    ck.D.setRandom();
+    ck.d.setRandom();
+    problem.stages[t] = std::move(ck);
+  }
+  problem.makeContiguous();
+  return problem;
+}
+
+BOOST_AUTO_TEST_CASE(batched_vs_serial) {
+  const uint nx = 6;
+  const uint nu = 3;
+  const uint nc = 2;
+  const uint horz = 20;
+  // not a multiple of the SIMD width, to exercise the padding lanes
+  const size_t num_problems = 7;
+  const double mu = 1e-8;
+
+  std::vector<problem_t> problems;
+  for (size_t i = 0; i < num_problems; i++)
+    problems.push_back(generate_batch_problem(horz, nx, nu, nc));
+  std::vector<const problem_t *> ptrs;
+  for (const problem_t &problem : problems)
+    ptrs.push_back(&problem);
+
+  BatchedRiccatiSolver<double, 4> solver(ptrs, 2);
+  BOOST_CHECK_EQUAL(solver.numGroups(), 2);
+  BOOST_CHECK(solver.backward(mu, mu));
+  BOOST_CHECK(solver.forward());
+
+  for (size_t i = 0; i < num_problems; i++) {
+    const problem_t &problem = problems[i];
+    prox_riccati_t refSolver(problem);
+    refSolver.backward(mu, mu);
+    auto [xs_ref, us_ref, vs_ref, lbdas_ref] = lqrInitializeSolution(problem);
+    refSolver.forward(xs_ref, us_ref, vs_ref, lbdas_ref);
+    KktError refErr =
+        computeKktError(problem, xs_ref, us_ref, vs_ref, lbdas_ref, mu, mu);
+
+    auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+    solver.getSolution(i, xs, us, vs, lbdas);
+    KktError err = computeKktError(problem, xs, us, vs, lbdas, mu, mu);
+    printKktError(err);
+    // as accurate as the pivoted factorizations of the serial solver
+    BOOST_CHECK_LE(err.max, std::max(1e-10, 10 * refErr.max));
+
+    auto relerr = [](const VectorXs &a, const VectorXs &b) {
+      return infty_norm(a - b) / (1. + infty_norm(b));
+    };
+    for (uint t = 0; t <= horz; t++) {
+      BOOST_CHECK_SMALL(relerr(xs[t], xs_ref[t]), 1e-8);
+      BOOST_CHECK_SMALL(relerr(vs[t], vs_ref[t]), 1e-8);
+      BOOST_CHECK_SMALL(relerr(lbdas[t], lbdas_ref[t]), 1e-8);
+      if (t < horz)
+        BOOST_CHECK_SMALL(relerr(us[t], us_ref[t]), 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batched_requires_identity_dynamics) {
+  VectorXs x0 = VectorXs::NullaryExpr(4, normal_unary_op{});
+  // generate_problem() samples a random E
+  problem_t problem = generate_problem(x0, 5, 4, 2);
+  std::vector<const problem_t *> ptrs{&problem};
+  BOOST_CHECK_THROW((BatchedRiccatiSolver<double, 4>(ptrs)),
+                    aligator::RuntimeError);
+}
@@ -131,3 +131,25 @@ BOOST_FIXTURE_TEST_CASE(block_tridiag_solve_down_looking, BTAG_Fixture) {
     BOOST_CHECK(vec.matrix().isApprox(rhs.matrix(), 1e-12));
   }
 }
+
+BOOST_FIXTURE_TEST_CASE(block_tridiag_cyclic_reduction, BTAG_Fixture) {
+  std::vector<long> dims(N + 1, nx);
+  gar::BlockTridiagCyclicReduction<MatrixXs, Eigen::LDLT<MatrixXs>> solver(
+      dims);
+  aligator::ThreadPool pool(4);
+
+  bool ret = solver.factorize(diagonal, sup, &pool, 4);
+  BOOST_CHECK(ret);
+  solver.solveInPlace(vec, &pool, 4);
+
+  Eigen::LDLT<MatrixXs> ldlt(densemat);
+  ldlt.solveInPlace(rhs.matrix());
+  BOOST_CHECK(vec.matrix().isApprox(rhs.matrix(), 1e-12));
+
+  // several right-hand sides, solved without the thread pool
+  BlkMatrix<MatrixXs, -1, 1> mrhs(dims, {3});
+  mrhs.matrix().setRandom();
+  MatrixXs msol = ldlt.solve(mrhs.matrix());
+  solver.solveInPlace(mrhs);
+  BOOST_CHECK(mrhs.matrix().isApprox(msol, 1e-12));
+}
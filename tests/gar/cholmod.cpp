@@ -155,3 +155,76 @@ BOOST_AUTO_TEST_CASE(cholmod_short_horz) {
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE(cholmod_update_values) {
+  uint nx = 4, nu = 3, nc = 2;
+  uint horz = 8;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = short_problem(x0, horz, nx, nu, nc);
+  gar::CholmodLqSolver<double> solver{problem};
+  gar::CholmodLqSolver<double> condSolver{
+      problem, 2, gar::CholmodFactorization::SUPERNODAL_LLT};
+  const auto nnz = solver.kktMatrix.nonZeros();
+  const auto condNnz = condSolver.condensedMatrix.nonZeros();
+
+  // new values and regularization, with the same sparsity pattern
+  problem.g0.setRandom();
+  for (uint t = 0; t <= horz; t++) {
+    problem.stages[t].Q = sampleWishartDistributedMatrix(nx, nx + 1);
+    problem.stages[t].R = sampleWishartDistributedMatrix(nu, nu + 1);
+    problem.stages[t].C.setRandom();
+    problem.stages[t].d.setRandom();
+  }
+  for (double mu : {1e-4, 1e-8}) {
+    BOOST_CHECK(solver.backward(mu, 0.1 * mu));
+    Eigen::SparseMatrix<double> kktMat;
+    VectorXs kktRhs;
+    gar::lqrCreateSparseMatrix<false>(problem, mu, 0.1 * mu, kktMat, kktRhs);
+    BOOST_CHECK_EQUAL(solver.kktMatrix.nonZeros(), nnz);
+    BOOST_CHECK(solver.kktMatrix.toDense().isApprox(kktMat.toDense()));
+    BOOST_CHECK(solver.kktRhs.isApprox(kktRhs));
+
+    // the condensed matrix is updated in place, too
+    BOOST_CHECK(condSolver.backward(mu, 0.1 * mu));
+    BOOST_CHECK_EQUAL(condSolver.condensedMatrix.nonZeros(), condNnz);
+    auto [xs, us, vs, lbdas] = gar::lqrInitializeSolution(problem);
+    solver.forward(xs, us, vs, lbdas);
+    condSolver.forward(xs, us, vs, lbdas);
+    BOOST_CHECK(condSolver.kktSol.isApprox(solver.kktSol, 1e-6));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cholmod_factorizations) {
+  uint nx = 6, nu = 3;
+  uint horz = 20;
+  const double mu = 1e-8;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu);
+
+  gar::ProximalRiccatiSolver<double> refSolver{problem};
+  refSolver.backward(mu, mu);
+  auto [xs_ref, us_ref, vs_ref, lbdas_ref] = gar::lqrInitializeSolution(problem);
+  refSolver.forward(xs_ref, us_ref, vs_ref, lbdas_ref);
+
+  for (auto fact : {gar::CholmodFactorization::SIMPLICIAL_LDLT,
+                    gar::CholmodFactorization::SUPERNODAL_LLT}) {
+    gar::CholmodLqSolver<double> solver{problem, 2, fact};
+    BOOST_CHECK(solver.backward(mu, mu));
+    auto [xs, us, vs, lbdas] = gar::lqrInitializeSolution(problem);
+    BOOST_CHECK(solver.forward(xs, us, vs, lbdas));
+    KktError err = computeKktError(problem, xs, us, vs, lbdas, mu, mu);
+    printKktError(err);
+    BOOST_CHECK_LE(err.max, 1e-9);
+
+    for (uint t = 0; t <= horz; t++) {
+      BOOST_CHECK(xs[t].isApprox(xs_ref[t], 1e-6));
+      BOOST_CHECK(lbdas[t].isApprox(lbdas_ref[t], 1e-6));
+      if (t < horz) {
+        BOOST_CHECK(us[t].isApprox(us_ref[t], 1e-6));
+        // the feedforward gains hold the solution
+        BOOST_CHECK(solver.getFeedforward(t).head(nu).isApprox(us[t]));
+        BOOST_CHECK(solver.getFeedback(t).isZero());
+      }
+    }
+  }
+}
@@ -8,6 +8,7 @@
 #include "aligator/gar/parallel-solver.hpp"
 #include "aligator/gar/utils.hpp"
 #include <Eigen/Cholesky>
+#include <numeric>
 
 using namespace aligator::gar;
 
@@ -270,3 +271,163 @@ BOOST_AUTO_TEST_CASE(parallel_solver_class) {
     BOOST_CHECK_LE(e.max, tol);
   }
 }
+
+BOOST_AUTO_TEST_CASE(parallel_solver_thread_pool) {
+  uint nx = 16;
+  uint nu = 8;
+  VectorXs x0 = VectorXs::Zero(nx);
+  uint horizon = 50;
+  const double tol = 1e-10;
+  const double mu = 1e-9;
+
+  problem_t problem = generate_problem(x0, horizon, nx, nu);
+  problem_t problemRef = problem;
+
+  auto [xs_ref, us_ref, vs_ref, lbdas_ref] = lqrInitializeSolution(problemRef);
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problemRef);
+
+  ProximalRiccatiSolver<double> refSolver{problemRef};
+  refSolver.backward(mu, mu);
+  refSolver.forward(xs_ref, us_ref, vs_ref, lbdas_ref);
+
+  // fewer pool threads than legs
+  aligator::ThreadPool pool(num_threads / 2);
+  ParallelRiccatiSolver<double> parSolver(problem, num_threads, &pool);
+  for (size_t k = 0; k < 4; k++) {
+    parSolver.backward(mu, mu);
+    parSolver.forward(xs, us, vs, lbdas);
+    KktError err = computeKktError(problem, xs, us, vs, lbdas, mu, mu);
+    BOOST_CHECK_LE(err.max, tol);
+  }
+  for (uint i = 0; i <= horizon; i++) {
+    BOOST_CHECK_LE(infty_norm(xs[i] - xs_ref[i]), tol);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_solver_num_legs) {
+  uint nx = 16;
+  uint nu = 8;
+  VectorXs x0 = VectorXs::Zero(nx);
+  uint horizon = 50;
+  const double tol = 1e-10;
+  const double mu = 1e-9;
+
+  problem_t problemRef = generate_problem(x0, horizon, nx, nu);
+  auto [xs_ref, us_ref, vs_ref, lbdas_ref] = lqrInitializeSolution(problemRef);
+  ProximalRiccatiSolver<double> refSolver{problemRef};
+  refSolver.backward(mu, mu);
+  refSolver.forward(xs_ref, us_ref, vs_ref, lbdas_ref);
+
+  // more legs than threads, then fewer
+  for (auto [nthreads, nlegs] : {std::pair{2u, 7u}, std::pair{6u, 3u}}) {
+    problem_t problem = problemRef;
+    auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+    ParallelRiccatiSolver<double> parSolver(problem, nthreads, nullptr, nlegs);
+    BOOST_CHECK_EQUAL(parSolver.numLegs, nlegs);
+    BOOST_CHECK_EQUAL(parSolver.legs.size(), nlegs);
+    parSolver.backward(mu, mu);
+    parSolver.forward(xs, us, vs, lbdas);
+    KktError err = computeKktError(problem, xs, us, vs, lbdas, mu, mu);
+    BOOST_CHECK_LE(err.max, tol);
+    for (uint i = 0; i <= horizon; i++) {
+      BOOST_CHECK_LE(infty_norm(xs[i] - xs_ref[i]), tol);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_solver_collapse_feedback) {
+  uint nx = 12;
+  uint nu = 6;
+  VectorXs x0 = VectorXs::Zero(nx);
+  uint horizon = 40;
+  const double tol = 1e-8;
+  const double mu = 1e-11;
+
+  problem_t problemRef = generate_problem(x0, horizon, nx, nu);
+  ProximalRiccatiSolver<double> refSolver{problemRef};
+  refSolver.backward(mu, mu);
+
+  for (bool useCR : {false, true}) {
+    problem_t problem = problemRef;
+    auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+    ParallelRiccatiSolver<double> parSolver(problem, num_threads);
+    parSolver.useCyclicReduction = useCR;
+    parSolver.backward(mu, mu);
+    parSolver.forward(xs, us, vs, lbdas);
+    parSolver.collapseFeedback();
+
+    // the collapsed gains (used by the nonlinear rollout) reproduce the
+    // solution, and match the gains of the serial solver
+    for (uint t = 0; t <= horizon; t++) {
+      const auto &d = parSolver.datas[t];
+      BOOST_CHECK_LE(infty_norm(d.fth.matrix()), 0.);
+      BOOST_CHECK_LE(infty_norm(us[t] - d.ff[0] - d.fb.blockRow(0) * xs[t]),
+                     tol);
+      BOOST_CHECK_LE(infty_norm(vs[t] - d.ff[1] - d.fb.blockRow(1) * xs[t]),
+                     tol);
+      BOOST_CHECK_LE(
+          infty_norm(d.fb.blockRow(0) - refSolver.datas[t].fb.blockRow(0)),
+          tol);
+      if (t < horizon) {
+        BOOST_CHECK_LE(
+            infty_norm(lbdas[t + 1] - d.ff[2] - d.fb.blockRow(2) * xs[t]),
+            tol);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(balanced_work) {
+  // expensive knots at the start of the horizon
+  std::vector<double> costs(60, 1.);
+  std::fill_n(costs.begin(), 20, 4.);
+  const uint num_legs = 4;
+  std::vector<workrange_t> legs = get_balanced_work(costs, num_legs);
+
+  BOOST_CHECK_EQUAL(legs.size(), num_legs);
+  BOOST_CHECK_EQUAL(legs.front().beg, 0u);
+  BOOST_CHECK_EQUAL(legs.back().end, costs.size());
+  for (uint i = 0; i < num_legs; i++) {
+    BOOST_CHECK_LT(legs[i].beg, legs[i].end);
+    if (i > 0)
+      BOOST_CHECK_EQUAL(legs[i].beg, legs[i - 1].end);
+    const double c = std::accumulate(costs.begin() + legs[i].beg,
+                                     costs.begin() + legs[i].end, 0.);
+    // mean cost per leg is 30
+    BOOST_CHECK_LE(c, 34.);
+  }
+
+  // as many legs as knots
+  legs = get_balanced_work(costs, uint(costs.size()));
+  for (uint i = 0; i < costs.size(); i++)
+    BOOST_CHECK_EQUAL(legs[i].end, i + 1);
+
+  // legs of the parallel solver: all but the last one are parameterized
+  VectorXs x0 = VectorXs::Zero(8);
+  problem_t problem = generate_problem(x0, 60, 8, 4);
+  ParallelRiccatiSolver<double> parSolver(problem, num_legs);
+  std::vector<double> leg_costs;
+  double max_knot_cost = 0.;
+  for (const workrange_t &leg : parSolver.legs) {
+    double c = 0.;
+    for (uint t = leg.beg; t < leg.end; t++) {
+      // cost of the knots as they are solved
+      const double ct = estimate_knot_cost(problem.stages[t]);
+      max_knot_cost = std::max(max_knot_cost, ct);
+      c += ct;
+    }
+    leg_costs.push_back(c);
+  }
+  const double mean_cost =
+      std::accumulate(leg_costs.begin(), leg_costs.end(), 0.) / num_legs;
+  for (uint i = 0; i < num_legs; i++) {
+    BOOST_TEST_MESSAGE(fmt::format("leg {:d}: [{:d}, {:d}), cost {:.0f}", i,
+                                   parSolver.legs[i].beg,
+                                   parSolver.legs[i].end, leg_costs[i]));
+    BOOST_CHECK_LE(std::abs(leg_costs[i] - mean_cost), max_knot_cost);
+  }
+  // the knots of the last leg are cheaper
+  const workrange_t &first = parSolver.legs.front();
+  const workrange_t &last = parSolver.legs.back();
+  BOOST_CHECK_GT(last.end - last.beg, first.end - first.beg);
+}
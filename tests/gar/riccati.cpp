@@ -9,6 +9,8 @@
 #include "./test_util.hpp"
 #include "aligator/gar/utils.hpp"
 #include "aligator/gar/dense-riccati.hpp"
+#include "aligator/gar/fixed-size-riccati.hpp"
+#include "aligator/gar/mixed-precision-riccati.hpp"
 
 using namespace aligator::gar;
 
@@ -198,3 +200,306 @@ BOOST_AUTO_TEST_CASE(parametric) {
   RiccatiSolverDense<double> denseSolver(problem);
   testfn(denseSolver);
 }
+
+BOOST_AUTO_TEST_CASE(fixed_size) {
+  BOOST_TEST_MESSAGE("Fixed-size kernel");
+  Eigen::Vector4d x0 = Eigen::Vector4d::NullaryExpr(normal_unary_op{});
+  uint nx = 4;
+  uint nu = 2;
+  uint horz = 50;
+  auto problem = generate_problem(x0, horz, nx, nu);
+  // other control dimension: the fixed-size solver is not applicable
+  auto problem_cstr = generate_problem(x0, horz, nx, nu + 1);
+
+  using fixed_solver_t = ProximalRiccatiSolverFixed<double, 4, 2, 0>;
+  BOOST_CHECK(fixed_solver_t::supportsProblem(problem));
+  BOOST_CHECK(!fixed_solver_t::supportsProblem(problem_cstr));
+
+  auto solver = createProximalRiccatiSolver(problem);
+  BOOST_CHECK(dynamic_cast<fixed_solver_t *>(solver.get()) != nullptr);
+  auto solver_cstr = createProximalRiccatiSolver(problem_cstr);
+  BOOST_CHECK(dynamic_cast<prox_riccati_t *>(solver_cstr.get()) != nullptr);
+
+  const double mu = 1e-12;
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  BOOST_CHECK(solver->backward(mu, mu));
+  BOOST_CHECK(solver->forward(xs, us, vs, lbdas));
+  KktError err = computeKktError(problem, xs, us, vs, lbdas);
+  printKktError(err);
+  BOOST_CHECK_LE(err.max, 1e-9);
+
+  prox_riccati_t refSolver(problem);
+  auto [xsr, usr, vsr, lbdasr] = lqrInitializeSolution(problem);
+  refSolver.backward(mu, mu);
+  refSolver.forward(xsr, usr, vsr, lbdasr);
+  for (size_t i = 0; i <= horz; i++) {
+    BOOST_CHECK_SMALL(infty_norm(xs[i] - xsr[i]), 1e-8);
+    BOOST_CHECK_SMALL(infty_norm(lbdas[i] - lbdasr[i]), 1e-8);
+  }
+  for (size_t i = 0; i < horz; i++) {
+    BOOST_CHECK_SMALL(infty_norm(us[i] - usr[i]), 1e-8);
+    BOOST_CHECK_SMALL(infty_norm(solver->getFeedback(i) -
+                                 refSolver.getFeedback(i)),
+                      1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fixed_size_constrained) {
+  BOOST_TEST_MESSAGE("Fixed-size kernel with path constraints");
+  uint nx = 4;
+  uint nu = 2;
+  uint nc = 2;
+  uint horz = 30;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu);
+  for (uint t = 0; t < horz; t++) {
+    const knot_t &kn = problem.stages[t];
+    knot_t ck(kn.nx, kn.nu, nc, kn.nx2);
+    ck.Q = kn.Q;
+    ck.S = kn.S;
+    ck.R = kn.R;
+    ck.q = kn.q;
+    ck.r = kn.r;
+    ck.A = kn.A;
+    ck.B = kn.B;
+    ck.E = kn.E;
+    ck.f = kn.f;
+    ck.C.setRandom();
+    ck.D.setRandom();
+    ck.d.setRandom();
+    problem.stages[t] = std::move(ck);
+  }
+  problem.makeContiguous();
+
+  using fixed_solver_t = ProximalRiccatiSolverFixed<double, 4, 2, 2>;
+  auto solver = createProximalRiccatiSolver(problem);
+  BOOST_CHECK(dynamic_cast<fixed_solver_t *>(solver.get()) != nullptr);
+
+  const double mu = 1e-10;
+  prox_riccati_t refSolver(problem);
+  auto check_solution = [&] {
+    auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+    auto [xsr, usr, vsr, lbdasr] = lqrInitializeSolution(problem);
+    BOOST_CHECK(solver->forward(xs, us, vs, lbdas));
+    refSolver.forward(xsr, usr, vsr, lbdasr);
+    for (size_t i = 0; i <= horz; i++) {
+      BOOST_CHECK_SMALL(infty_norm(xs[i] - xsr[i]), 1e-8);
+      BOOST_CHECK_SMALL(infty_norm(lbdas[i] - lbdasr[i]), 1e-8);
+    }
+    for (size_t i = 0; i < horz; i++) {
+      BOOST_CHECK_SMALL(infty_norm(us[i] - usr[i]), 1e-8);
+      BOOST_CHECK_SMALL(infty_norm(vs[i] - vsr[i]), 1e-8);
+    }
+  };
+  BOOST_CHECK(solver->backward(mu, mu));
+  refSolver.backward(mu, mu);
+  check_solution();
+
+  // new vectors: same solution as a full backward pass
+  for (knot_t &knot : problem.stages) {
+    knot.q.setRandom();
+    knot.f.setRandom();
+    knot.d.setRandom();
+  }
+  BOOST_CHECK(solver->backwardRhs(mu, mu));
+  refSolver.backward(mu, mu);
+  check_solution();
+
+  // the problem is not parameterized
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  VectorXs theta = VectorXs::Ones(2);
+  BOOST_CHECK_THROW(solver->forward(xs, us, vs, lbdas, theta),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(problem_arena) {
+  BOOST_TEST_MESSAGE("Contiguous knot storage");
+  uint nx = 4;
+  uint nu = 2;
+  uint horz = 20;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu);
+  BOOST_CHECK(problem.isContiguous());
+  for (uint t = 0; t < horz; t++) {
+    BOOST_CHECK(problem.stages[t].Q.data() < problem.stages[t + 1].Q.data());
+  }
+
+  // copies do not share storage
+  problem_t copy = problem;
+  BOOST_CHECK(copy.isContiguous());
+  BOOST_CHECK(copy.stages[0].A.data() != problem.stages[0].A.data());
+  BOOST_CHECK(copy.stages[0].A.isApprox(problem.stages[0].A));
+  copy.stages[0].A.setZero();
+  BOOST_CHECK(!problem.stages[0].A.isZero());
+
+  // assigning a knot with the same dimensions keeps it in the arena
+  const knot_t knot = problem.stages[3];
+  BOOST_CHECK(!knot.isArenaBacked());
+  copy.stages[1] = knot;
+  BOOST_CHECK(copy.stages[1].isArenaBacked());
+  BOOST_CHECK(copy.stages[1].Q.isApprox(knot.Q));
+
+  // rotating the knots swaps their views
+  MatrixXs Q1 = problem.stages[1].Q;
+  std::rotate(problem.stages.begin(), problem.stages.begin() + 1,
+              problem.stages.end());
+  BOOST_CHECK(problem.isContiguous());
+  BOOST_CHECK(problem.stages[0].Q.isApprox(Q1));
+
+  problem.addParameterization(2);
+  BOOST_CHECK(problem.isContiguous());
+  BOOST_CHECK_EQUAL(problem.ntheta(), 2);
+  BOOST_CHECK(problem.stages[0].Q.isApprox(Q1));
+  BOOST_CHECK(problem.stages[0].Gx.isZero());
+}
+
+BOOST_AUTO_TEST_CASE(structured_knots) {
+  BOOST_TEST_MESSAGE("Structured knots");
+  uint nx = 4;
+  uint nu = 2;
+  uint nth = 2;
+  uint horz = 30;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu, nth);
+  for (knot_t &knot : problem.stages) {
+    knot.E.setIdentity();
+    knot.E *= -1;
+    knot.Q = MatrixXs(knot.Q.diagonal().asDiagonal());
+    knot.R = MatrixXs(knot.R.diagonal().asDiagonal());
+    knot.B.topRows(nx / 2).setZero();
+  }
+  // reference: no structure assumed
+  problem_t problemRef = problem;
+  for (knot_t &knot : problem.stages) {
+    knot.updateStructure();
+    BOOST_CHECK(knot.structure.E_minus_identity);
+    BOOST_CHECK(knot.structure.Q_diagonal);
+    BOOST_CHECK(knot.structure.R_diagonal);
+    BOOST_CHECK_EQUAL(knot.structure.B_zero_rows, knot.nu > 0 ? nx / 2 : nx);
+  }
+  BOOST_CHECK(!problemRef.stages[0].structure.E_minus_identity);
+
+  const double mu = 1e-11;
+  VectorXs theta = VectorXs::NullaryExpr(nth, normal_unary_op{});
+  auto testfn = [&](auto &&solver, auto &&refSolver) {
+    auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+    auto [xsr, usr, vsr, lbdasr] = lqrInitializeSolution(problem);
+    solver.backward(mu, mu);
+    solver.forward(xs, us, vs, lbdas, theta);
+    refSolver.backward(mu, mu);
+    refSolver.forward(xsr, usr, vsr, lbdasr, theta);
+    for (uint i = 0; i <= horz; i++) {
+      BOOST_CHECK_SMALL(infty_norm(xs[i] - xsr[i]), 1e-10);
+      BOOST_CHECK_SMALL(infty_norm(lbdas[i] - lbdasr[i]), 1e-10);
+      BOOST_CHECK_SMALL(infty_norm(us[i] - usr[i]), 1e-10);
+      BOOST_CHECK_SMALL(
+          infty_norm(solver.getFeedback(i) - refSolver.getFeedback(i)), 1e-10);
+    }
+  };
+  testfn(ProximalRiccatiSolver<double>(problem),
+         ProximalRiccatiSolver<double>(problemRef));
+
+  // the fixed-size kernel does not support parameterized problems
+  problem = generate_problem(x0, horz, nx, nu);
+  for (knot_t &knot : problem.stages) {
+    knot.E.setIdentity();
+    knot.E *= -1;
+  }
+  problemRef = problem;
+  for (knot_t &knot : problem.stages)
+    knot.updateStructure();
+  theta.resize(0);
+  using fixed_solver_t = ProximalRiccatiSolverFixed<double, 4, 2, 0>;
+  testfn(fixed_solver_t(problem), fixed_solver_t(problemRef));
+}
+
+BOOST_AUTO_TEST_CASE(kkt_refinement) {
+  BOOST_TEST_MESSAGE("KKT residual and iterative refinement");
+  uint nx = 6;
+  uint nu = 3;
+  uint horz = 40;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu);
+  const double mu = 1e-10;
+  ProximalRiccatiSolver<double> solver(problem);
+  solver.backward(mu, mu);
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  solver.forward(xs, us, vs, lbdas);
+
+  LQRKktResidualTpl<double> res(problem);
+  double err = res.compute(problem, xs, us, vs, lbdas, mu, mu);
+  KktError kktErr = computeKktError(problem, xs, us, vs, lbdas, mu, mu);
+  BOOST_CHECK_CLOSE(err, kktErr.max, 1e-8);
+
+  // perturb the solution: one refinement step recovers it
+  for (uint t = 0; t <= horz; t++)
+    xs[t] += VectorXs::NullaryExpr(nx, normal_unary_op{});
+  err = res.compute(problem, xs, us, vs, lbdas, mu, mu);
+  BOOST_CHECK_GT(err, 1e-2);
+
+  auto [dxs, dus, dvs, dlbdas] = lqrInitializeSolution(problem);
+  res.swapVectors(problem);
+  BOOST_CHECK(solver.backwardRhs(mu, mu));
+  solver.forward(dxs, dus, dvs, dlbdas);
+  // same as a full backward pass
+  prox_riccati_t refSolver(problem);
+  refSolver.backward(mu, mu);
+  for (uint t = 0; t <= horz; t++) {
+    BOOST_CHECK_SMALL(
+        infty_norm(solver.getFeedforward(t) - refSolver.getFeedforward(t)),
+        1e-10);
+  }
+  res.swapVectors(problem);
+
+  for (uint t = 0; t <= horz; t++) {
+    xs[t] += dxs[t];
+    vs[t] += dvs[t];
+    lbdas[t] += dlbdas[t];
+    if (t < horz)
+      us[t] += dus[t];
+  }
+  err = res.compute(problem, xs, us, vs, lbdas, mu, mu);
+  BOOST_CHECK_LE(err, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(mixed_precision) {
+  BOOST_TEST_MESSAGE("Mixed-precision Riccati solver");
+  uint nx = 6;
+  uint nu = 3;
+  uint horz = 40;
+  VectorXs x0 = VectorXs::NullaryExpr(nx, normal_unary_op{});
+  problem_t problem = generate_problem(x0, horz, nx, nu);
+  const double mu = 1e-10;
+
+  prox_riccati_t refSolver(problem);
+  refSolver.backward(mu, mu);
+  auto [xs_ref, us_ref, vs_ref, lbdas_ref] = lqrInitializeSolution(problem);
+  refSolver.forward(xs_ref, us_ref, vs_ref, lbdas_ref);
+  KktError refErr =
+      computeKktError(problem, xs_ref, us_ref, vs_ref, lbdas_ref, mu, mu);
+
+  MixedPrecisionRiccatiSolver<double, float> solver(problem);
+  solver.refinementThreshold = std::max(1e-11, 2 * refErr.max);
+  solver.backward(mu, mu);
+  auto [xs, us, vs, lbdas] = lqrInitializeSolution(problem);
+  // run twice: the second call restores the rhs of the low-precision problem
+  for (int i = 0; i < 2; i++) {
+    solver.forward(xs, us, vs, lbdas);
+    BOOST_TEST_MESSAGE(fmt::format("refinement steps: {:d}, residual: {:.3e}",
+                                   solver.numRefinementSteps,
+                                   solver.kktResidual));
+    BOOST_CHECK_GT(solver.numRefinementSteps, 0);
+    BOOST_CHECK_LE(solver.kktResidual, solver.refinementThreshold);
+    KktError err = computeKktError(problem, xs, us, vs, lbdas, mu, mu);
+    BOOST_CHECK_CLOSE(err.max, solver.kktResidual, 1e-6);
+
+    for (uint t = 0; t <= horz; t++) {
+      BOOST_CHECK_SMALL(infty_norm(xs[t] - xs_ref[t]), 1e-8);
+      BOOST_CHECK_SMALL(infty_norm(lbdas[t] - lbdas_ref[t]), 1e-8);
+      // the feedback gains are not refined
+      BOOST_CHECK_SMALL(infty_norm(solver.getFeedback(t) -
+                                   refSolver.getFeedback(t)),
+                        1e-2);
+    }
+  }
+}
@@ -0,0 +1,150 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/core/stage-model.hpp"
+#include "aligator/core/stage-data.hpp"
+#include "aligator/modelling/costs/quad-residual-cost.hpp"
+#include "aligator/modelling/costs/sum-of-costs.hpp"
+#include "aligator/modelling/dynamics/multibody-free-fwd.hpp"
+#include "aligator/modelling/dynamics/integrator-semi-euler.hpp"
+#include "aligator/modelling/multibody/center-of-mass-translation.hpp"
+#include "aligator/modelling/multibody/frame-placement.hpp"
+#include "aligator/modelling/multibody/frame-translation.hpp"
+#include "aligator/modelling/multibody/frame-velocity.hpp"
+#include "aligator/modelling/multibody/kinematics-cache.hpp"
+
+#include <proxsuite-nlp/modelling/constraints/equality-constraint.hpp>
+#include <proxsuite-nlp/modelling/spaces/multibody.hpp>
+#include <pinocchio/parsers/sample-models.hpp>
+
+BOOST_AUTO_TEST_SUITE(kinematics_cache)
+
+using namespace aligator;
+using T = double;
+using context::MatrixXs;
+using context::VectorXs;
+using Model = pinocchio::ModelTpl<T>;
+using PhaseSpace = proxsuite::nlp::MultibodyPhaseSpace<T>;
+using StageModel = StageModelTpl<T>;
+using StageData = StageDataTpl<T>;
+using KinematicsCacheModel = KinematicsCacheModelTpl<T>;
+using KinematicsCacheData = KinematicsCacheDataTpl<T>;
+using EqualityConstraint = proxsuite::nlp::EqualityConstraintTpl<T>;
+
+constexpr T TOL = 1e-12;
+
+struct stage_fixture {
+  shared_ptr<Model> model;
+  shared_ptr<PhaseSpace> space;
+  shared_ptr<StageModel> stage;
+  VectorXs u0;
+
+  stage_fixture() : model(std::make_shared<Model>()) {
+    pinocchio::buildModels::humanoidRandom(*model, true);
+    space = std::make_shared<PhaseSpace>(*model);
+    const int ndx = space->ndx();
+    const int nu = model->nv - 6;
+    MatrixXs actuation = MatrixXs::Zero(model->nv, nu);
+    actuation.bottomRows(nu).setIdentity();
+    u0 = VectorXs::Random(nu);
+
+    auto ode = std::make_shared<dynamics::MultibodyFreeFwdDynamicsTpl<T>>(
+        space, actuation);
+    auto dyn =
+        std::make_shared<dynamics::IntegratorSemiImplEulerTpl<T>>(ode, 0.01);
+
+    const auto fr_id1 = model->getFrameId("larm_shoulder2_body");
+    const auto fr_id2 = model->getFrameId("rleg_elbow_body");
+    auto plc = std::make_shared<FramePlacementResidualTpl<T>>(
+        ndx, nu, model, pinocchio::SE3::Random(), fr_id1);
+    auto cost = std::make_shared<CostStackTpl<T>>(space, nu);
+    cost->addCost(std::make_shared<QuadraticResidualCostTpl<T>>(
+        space, plc, MatrixXs::Identity(6, 6)));
+
+    stage = std::make_shared<StageModel>(cost, dyn);
+    auto trans = std::make_shared<FrameTranslationResidualTpl<T>>(
+        ndx, nu, model, Eigen::Vector3d::Random(), fr_id2);
+    auto vel = std::make_shared<FrameVelocityResidualTpl<T>>(
+        ndx, nu, model, pinocchio::Motion::Random(), fr_id2, pinocchio::LOCAL);
+    auto com = std::make_shared<CenterOfMassTranslationResidualTpl<T>>(
+        ndx, nu, model, Eigen::Vector3d::Random());
+    for (const auto &func : {shared_ptr<StageFunctionTpl<T>>(trans),
+                             shared_ptr<StageFunctionTpl<T>>(vel),
+                             shared_ptr<StageFunctionTpl<T>>(com)})
+      stage->addConstraint(func, std::make_shared<EqualityConstraint>());
+  }
+
+  void check_equal(const StageData &data, const StageData &data_ref) const {
+    BOOST_CHECK_CLOSE(data.cost_data->value_, data_ref.cost_data->value_,
+                      1e-10);
+    BOOST_CHECK(data.cost_data->grad_.isApprox(data_ref.cost_data->grad_));
+    for (std::size_t j = 0; j < stage->numConstraints(); j++) {
+      const auto &cd = *data.constraint_data[j];
+      const auto &cd_ref = *data_ref.constraint_data[j];
+      BOOST_CHECK(cd.value_.isApprox(cd_ref.value_, TOL));
+      BOOST_CHECK(cd.Jx_.isApprox(cd_ref.Jx_, TOL));
+    }
+  }
+};
+
+BOOST_FIXTURE_TEST_CASE(shared_kinematics, stage_fixture) {
+  const auto data_ref = stage->createData();
+  BOOST_CHECK(data_ref->cache_data == nullptr);
+
+  stage->cache_model_ = std::make_shared<KinematicsCacheModel>(model, true);
+  const auto data = stage->createData();
+  BOOST_CHECK(std::dynamic_pointer_cast<KinematicsCacheData>(
+                  data->cache_data) != nullptr);
+
+  for (int i = 0; i < 10; i++) {
+    VectorXs x0 = space->rand();
+    for (StageData *d : {data_ref.get(), data.get()}) {
+      stage->evaluate(x0, u0, x0, *d);
+      stage->computeFirstOrderDerivatives(x0, u0, x0, *d);
+    }
+    check_equal(*data, *data_ref);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(stale_kinematics, stage_fixture) {
+  const auto data_ref = stage->createData();
+  stage->cache_model_ = std::make_shared<KinematicsCacheModel>(model, true);
+  const auto data = stage->createData();
+  auto &cache = static_cast<KinematicsCacheData &>(*data->cache_data);
+
+  // the stage is evaluated, but not differentiated, at x0
+  VectorXs x0 = space->rand();
+  stage->evaluate(x0, u0, x0, *data);
+  BOOST_CHECK(cache.isValidAt(x0, false));
+  BOOST_CHECK(!cache.isValidAt(x0, true));
+
+  // the residuals are differentiated outside of the stage, at x0 then x1
+  VectorXs x1 = space->rand();
+  for (const VectorXs &x : {x0, x1}) {
+    stage->evaluate(x, u0, x, *data_ref);
+    stage->computeFirstOrderDerivatives(x, u0, x, *data_ref);
+    for (std::size_t j = 0; j < stage->numConstraints(); j++) {
+      const auto &func = *stage->constraints_[j].func;
+      func.evaluate(x, u0, x, *data->constraint_data[j]);
+      func.computeJacobians(x, u0, x, *data->constraint_data[j]);
+    }
+    stage->cost_->evaluate(x, u0, *data->cost_data);
+    stage->cost_->computeGradients(x, u0, *data->cost_data);
+    check_equal(*data, *data_ref);
+  }
+  // the shared kinematics were left untouched
+  BOOST_CHECK(cache.isValidAt(x0, false));
+}
+
+BOOST_AUTO_TEST_CASE(model_by_address) {
+  auto model = std::make_shared<Model>();
+  pinocchio::buildModels::humanoidRandom(*model, true);
+  auto model_copy = std::make_shared<Model>(*model);
+
+  KinematicsCacheModel cache_model(model, false);
+  const auto cache = cache_model.createData();
+  BOOST_CHECK(getSharedKinematics(cache, *model, false) != nullptr);
+  BOOST_CHECK(getSharedKinematics(cache, *model, true) == nullptr);
+  BOOST_CHECK(getSharedKinematics(cache, *model_copy, false) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
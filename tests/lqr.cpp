@@ -3,6 +3,8 @@
 #include "aligator/modelling/costs/quad-costs.hpp"
 #include "aligator/modelling/state-error.hpp"
 #include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/proxddp/batch-solver.hpp"
+#include "aligator/solvers/fddp/solver-fddp.hpp"
 
 #include <proxsuite-nlp/modelling/constraints.hpp>
 
@@ -16,6 +18,8 @@ using LinearDynamics = dynamics::LinearDiscreteDynamicsTpl<double>;
 using QuadraticCost = QuadraticCostTpl<double>;
 using context::CostAbstract;
 using context::SolverProxDDP;
+using context::SolverProxDDPBatch;
+using context::SolverFDDP;
 using context::StageModel;
 using context::TrajOptProblem;
 
@@ -78,3 +82,385 @@ BOOST_AUTO_TEST_CASE(lqr_proxddp) {
 
   std::cout << ddp.results_ << std::endl;
 }
+
+BOOST_AUTO_TEST_CASE(lqr_proxddp_nonlinear_rollout_next_state_constraint) {
+  const size_t nsteps = 20;
+  const auto nx = 4;
+  const auto nu = 2;
+
+  NormalGen norm_gen;
+  MatrixXd A;
+  A.setIdentity(nx, nx);
+  A.bottomRightCorner<2, 2>() = MatrixXd::NullaryExpr(2, 2, norm_gen);
+  MatrixXd B = MatrixXd::NullaryExpr(nx, nu, norm_gen);
+
+  auto dyn_model = std::make_shared<LinearDynamics>(A, B, VectorXd::Zero(nx));
+  MatrixXd Q = MatrixXd::Identity(nx, nx);
+  VectorXd q = VectorXd::NullaryExpr(nx, norm_gen);
+  MatrixXd R = MatrixXd::Identity(nu, nu);
+  VectorXd r = VectorXd::Zero(nu);
+
+  auto cost = std::make_shared<QuadraticCost>(Q, R, q, r);
+  auto term_cost = std::make_shared<QuadraticCost>(Q, MatrixXd());
+  auto stage = std::make_shared<StageModel>(cost, dyn_model);
+
+  // constrain the first coordinate of the next state: y[0] = 0.5
+  MatrixXd C = MatrixXd::Zero(1, nx);
+  C(0, 0) = 1.;
+  VectorXd d = VectorXd::Constant(1, -0.5);
+  auto func = std::make_shared<LinearFunctionTpl<double>>(
+      MatrixXd::Zero(1, nx), MatrixXd::Zero(1, nu), C, d);
+  auto cstr_stage = std::make_shared<StageModel>(cost, dyn_model);
+  cstr_stage->addConstraint(
+      func, std::make_shared<proxsuite::nlp::EqualityConstraintTpl<double>>());
+
+  std::vector<decltype(stage)> stages(nsteps, stage);
+  stages[nsteps / 2] = cstr_stage;
+  VectorXd x0 = VectorXd::NullaryExpr(nx, norm_gen);
+  TrajOptProblem problem(x0, stages, term_cost);
+
+  double tol = 1e-6;
+  double mu_init = 1e-6;
+  SolverProxDDP ddp(tol, mu_init);
+  ddp.rollout_type_ = RolloutType::NONLINEAR;
+  ddp.max_iters = 40;
+  ddp.setup(problem);
+  BOOST_CHECK(ddp.run(problem));
+
+  const auto &xs = ddp.results_.xs;
+  BOOST_CHECK_SMALL(xs[nsteps / 2 + 1][0] - 0.5, 1e-5);
+
+  // the constraint values kept by the solver are those at the accepted
+  // iterate, not at the next state before the rollout
+  const auto &cdata =
+      *ddp.workspace_.problem_data.stage_data[nsteps / 2]->constraint_data[0];
+  auto fdata = func->createData();
+  func->evaluate(xs[nsteps / 2], ddp.results_.us[nsteps / 2],
+                 xs[nsteps / 2 + 1], *fdata);
+  BOOST_CHECK_SMALL((cdata.value_ - fdata->value_).norm(), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(lqr_proxddp_refinement_nonlinear_rollout) {
+  const size_t nsteps = 30;
+  const auto nx = 4;
+  const auto nu = 2;
+
+  NormalGen norm_gen;
+  MatrixXd A;
+  A.setIdentity(nx, nx);
+  A.bottomRightCorner<2, 2>() = MatrixXd::NullaryExpr(2, 2, norm_gen);
+  MatrixXd B = MatrixXd::NullaryExpr(nx, nu, norm_gen);
+
+  auto dyn_model = std::make_shared<LinearDynamics>(A, B, VectorXd::Zero(nx));
+  MatrixXd Q = MatrixXd::NullaryExpr(nx, nx, norm_gen);
+  Q = Q.transpose() * Q;
+  VectorXd q = VectorXd::NullaryExpr(nx, norm_gen);
+  MatrixXd R = MatrixXd::Identity(nu, nu);
+  VectorXd r = VectorXd::Zero(nu);
+
+  auto cost = std::make_shared<QuadraticCost>(Q, R, q, r);
+  auto term_cost = std::make_shared<QuadraticCost>(Q * 10., MatrixXd());
+  auto stage = std::make_shared<StageModel>(cost, dyn_model);
+  std::vector<decltype(stage)> stages(nsteps, stage);
+  VectorXd x0 = VectorXd::NullaryExpr(nx, norm_gen);
+  TrajOptProblem problem(x0, stages, term_cost);
+
+  double tol = 1e-6;
+  double mu_init = 1e-8;
+  SolverProxDDP ddp_ref(tol, mu_init);
+  ddp_ref.rollout_type_ = RolloutType::NONLINEAR;
+  ddp_ref.max_iters = 10;
+  ddp_ref.setup(problem);
+  BOOST_CHECK(ddp_ref.run(problem));
+
+  // a zero threshold forces the refinement steps: the rollout must follow
+  // the refined direction, not the last correction
+  SolverProxDDP ddp(tol, mu_init);
+  ddp.rollout_type_ = RolloutType::NONLINEAR;
+  ddp.max_iters = 10;
+  ddp.maxRefinementSteps_ = 2;
+  ddp.refinementThreshold_ = 0.;
+  ddp.setup(problem);
+  BOOST_CHECK(ddp.run(problem));
+
+  BOOST_CHECK_EQUAL(ddp.results_.num_iters, ddp_ref.results_.num_iters);
+  for (std::size_t t = 0; t <= nsteps; t++) {
+    BOOST_CHECK_SMALL((ddp.results_.xs[t] - ddp_ref.results_.xs[t]).norm(),
+                      1e-8);
+  }
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK_SMALL((ddp.results_.us[t] - ddp_ref.results_.us[t]).norm(),
+                      1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lqr_proxddp_batch) {
+  const size_t nsteps = 50;
+  const auto nx = 4;
+  const auto nu = 2;
+  const auto space = std::make_shared<Space>(nx);
+
+  NormalGen norm_gen;
+  MatrixXd A;
+  A.setIdentity(nx, nx);
+  A.bottomRightCorner<2, 2>() = MatrixXd::NullaryExpr(2, 2, norm_gen);
+  MatrixXd B = MatrixXd::NullaryExpr(nx, nu, norm_gen);
+
+  auto dyn_model = std::make_shared<LinearDynamics>(A, B, VectorXd::Zero(nx));
+  MatrixXd Q = MatrixXd::NullaryExpr(nx, nx, norm_gen);
+  Q = Q.transpose() * Q;
+  VectorXd q = VectorXd::NullaryExpr(nx, norm_gen);
+  MatrixXd R = MatrixXd::Identity(nu, nu);
+  VectorXd r = VectorXd::Zero(nu);
+
+  auto cost = std::make_shared<QuadraticCost>(Q, R, q, r);
+  auto term_cost = std::make_shared<QuadraticCost>(Q * 10., MatrixXd());
+  auto stage = std::make_shared<StageModel>(cost, dyn_model);
+  std::vector<decltype(stage)> stages(nsteps, stage);
+  TrajOptProblem problem(VectorXd::Zero(nx), stages, term_cost);
+
+  const std::size_t batch_size = 6;
+  std::vector<VectorXd> x0s;
+  for (std::size_t i = 0; i < batch_size; i++) {
+    x0s.push_back(VectorXd::NullaryExpr(nx, norm_gen));
+  }
+
+  double tol = 1e-6;
+  double mu_init = 1e-8;
+  const std::size_t max_iters = 10;
+  SolverProxDDPBatch batch(batch_size, tol, mu_init);
+  batch.setNumThreads(3);
+  for (std::size_t i = 0; i < batch_size; i++) {
+    batch.getSolver(i).rollout_type_ = RolloutType::LINEAR;
+    batch.getSolver(i).max_iters = max_iters;
+  }
+  batch.setup(problem);
+  BOOST_CHECK(batch.run(x0s));
+
+  // compare to independent serial solves
+  for (std::size_t i = 0; i < batch_size; i++) {
+    SolverProxDDP ddp(tol, mu_init);
+    ddp.rollout_type_ = RolloutType::LINEAR;
+    ddp.max_iters = max_iters;
+    problem.setInitState(x0s[i]);
+    ddp.setup(problem);
+    BOOST_CHECK(ddp.run(problem));
+
+    const auto &res = batch.getResults(i);
+    BOOST_CHECK(res.conv);
+    BOOST_CHECK_EQUAL(res.num_iters, ddp.results_.num_iters);
+    BOOST_CHECK(res.xs[0].isApprox(x0s[i]));
+    for (std::size_t t = 0; t <= nsteps; t++) {
+      BOOST_CHECK(res.xs[t].isApprox(ddp.results_.xs[t], 1e-8));
+    }
+    for (std::size_t t = 0; t < nsteps; t++) {
+      BOOST_CHECK(res.us[t].isApprox(ddp.results_.us[t], 1e-8));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lqr_proxddp_shift) {
+  const size_t nsteps = 40;
+  const auto nx = 4;
+  const auto nu = 2;
+
+  NormalGen norm_gen;
+  MatrixXd A;
+  A.setIdentity(nx, nx);
+  A.bottomRightCorner<2, 2>() = MatrixXd::NullaryExpr(2, 2, norm_gen);
+  MatrixXd B = MatrixXd::NullaryExpr(nx, nu, norm_gen);
+
+  auto dyn_model = std::make_shared<LinearDynamics>(A, B, VectorXd::Zero(nx));
+  MatrixXd Q = MatrixXd::NullaryExpr(nx, nx, norm_gen);
+  Q = Q.transpose() * Q;
+  VectorXd q = VectorXd::NullaryExpr(nx, norm_gen);
+  MatrixXd R = MatrixXd::Identity(nu, nu);
+  VectorXd r = VectorXd::Zero(nu);
+
+  auto cost = std::make_shared<QuadraticCost>(Q, R, q, r);
+  auto term_cost = std::make_shared<QuadraticCost>(Q * 10., MatrixXd());
+  auto stage = std::make_shared<StageModel>(cost, dyn_model);
+  std::vector<decltype(stage)> stages(nsteps, stage);
+  VectorXd x0 = VectorXd::NullaryExpr(nx, norm_gen);
+  TrajOptProblem problem(x0, stages, term_cost);
+
+  double tol = 1e-6;
+  double mu_init = 1e-8;
+  SolverProxDDP ddp(tol, mu_init);
+  ddp.rollout_type_ = RolloutType::LINEAR;
+  ddp.max_iters = 4;
+  ddp.setup(problem);
+  // the structure of the LQ knots is derived from the models
+  {
+    const auto &s = ddp.workspace_.lqr_problem.stages[1].structure;
+    BOOST_CHECK(s.E_minus_identity);
+    BOOST_CHECK(!s.Q_diagonal);
+    BOOST_CHECK(s.R_diagonal);
+    BOOST_CHECK_EQUAL(s.B_zero_rows, 0);
+  }
+  BOOST_CHECK(ddp.run(problem));
+
+  SolverProxDDP ddp_ref(tol, mu_init);
+  ddp_ref.rollout_type_ = RolloutType::LINEAR;
+  ddp_ref.max_iters = 4;
+
+  for (int k = 0; k < 4; k++) {
+    // alternate between reusing the dropped stage and appending a new one
+    auto new_stage =
+        k % 2 == 0 ? stage : std::make_shared<StageModel>(cost, dyn_model);
+    x0 = ddp.results_.xs[1];
+    problem.setInitState(x0);
+    BOOST_CHECK(ddp.shiftAndResume(problem, new_stage));
+    BOOST_CHECK(problem.stages_.back() == new_stage);
+    BOOST_CHECK(ddp.results_.xs[0].isApprox(x0));
+
+    ddp_ref.setup(problem);
+    for (std::size_t t = 0; t <= nsteps; t++) {
+      const auto &s = ddp.workspace_.lqr_problem.stages[t].structure;
+      const auto &s_ref = ddp_ref.workspace_.lqr_problem.stages[t].structure;
+      BOOST_CHECK_EQUAL(s.E_minus_identity, s_ref.E_minus_identity);
+      BOOST_CHECK_EQUAL(s.Q_diagonal, s_ref.Q_diagonal);
+      BOOST_CHECK_EQUAL(s.R_diagonal, s_ref.R_diagonal);
+      BOOST_CHECK_EQUAL(s.B_zero_rows, s_ref.B_zero_rows);
+    }
+    BOOST_CHECK(ddp_ref.run(problem));
+    for (std::size_t t = 0; t <= nsteps; t++) {
+      BOOST_CHECK_SMALL((ddp.results_.xs[t] - ddp_ref.results_.xs[t]).norm(),
+                        1e-5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lqr_fddp_shift) {
+  const size_t nsteps = 40;
+  const auto nx = 4;
+
+  NormalGen norm_gen;
+  MatrixXd A;
+  A.setIdentity(nx, nx);
+  A.bottomRightCorner<2, 2>() = MatrixXd::NullaryExpr(2, 2, norm_gen);
+  MatrixXd Q = MatrixXd::NullaryExpr(nx, nx, norm_gen);
+  Q = Q.transpose() * Q;
+  VectorXd q = VectorXd::NullaryExpr(nx, norm_gen);
+
+  // alternate the control dimension, so that misplaced buffers are caught
+  auto make_stage = [&](int nu) {
+    MatrixXd B = MatrixXd::NullaryExpr(nx, nu, norm_gen);
+    auto dyn_model =
+        std::make_shared<LinearDynamics>(A, B, VectorXd::Zero(nx));
+    MatrixXd R = MatrixXd::Identity(nu, nu);
+    VectorXd r = VectorXd::NullaryExpr(nu, norm_gen);
+    auto cost = std::make_shared<QuadraticCost>(Q, R, q, r);
+    return std::make_shared<StageModel>(cost, dyn_model);
+  };
+  std::vector<shared_ptr<StageModel>> stages;
+  for (size_t t = 0; t < nsteps; t++)
+    stages.push_back(make_stage(t % 2 == 0 ? 2 : 3));
+  auto term_cost = std::make_shared<QuadraticCost>(Q * 10., MatrixXd());
+  VectorXd x0 = VectorXd::NullaryExpr(nx, norm_gen);
+  TrajOptProblem problem(x0, stages, term_cost);
+
+  double tol = 1e-8;
+  SolverFDDP fddp(tol);
+  fddp.max_iters = 10;
+  fddp.setup(problem);
+  BOOST_CHECK(fddp.run(problem));
+
+  SolverFDDP fddp_ref(tol);
+  fddp_ref.max_iters = 10;
+
+  for (int k = 0; k < 4; k++) {
+    // alternate between reusing the dropped stage and appending a new one
+    auto new_stage = k % 2 == 0 ? problem.stages_[0]
+                                : make_stage(problem.stages_[0]->nu());
+    x0 = fddp.results_.xs[1];
+    problem.setInitState(x0);
+    BOOST_CHECK(fddp.shiftAndResume(problem, new_stage));
+    BOOST_CHECK(problem.stages_.back() == new_stage);
+    BOOST_CHECK(fddp.results_.xs[0].isApprox(x0));
+
+    const auto &ws = fddp.workspace_;
+    for (std::size_t t = 0; t < nsteps; t++) {
+      const int nu = problem.stages_[t]->nu();
+      BOOST_CHECK_EQUAL(ws.kktRhs[t].rows(), nu);
+      BOOST_CHECK_EQUAL(ws.JtH_temp_[t].rows(), nx + nu);
+      BOOST_CHECK_EQUAL(ws.q_params[t].Qu.size(), nu);
+      BOOST_CHECK_EQUAL(fddp.results_.us[t].size(), nu);
+    }
+
+    // cold solve of the shifted problem
+    fddp_ref.setup(problem);
+    BOOST_CHECK(fddp_ref.run(problem));
+    BOOST_CHECK_CLOSE(fddp.results_.traj_cost_, fddp_ref.results_.traj_cost_,
+                      1e-6);
+    for (std::size_t t = 0; t <= nsteps; t++) {
+      BOOST_CHECK_SMALL(
+          (fddp.results_.xs[t] - fddp_ref.results_.xs[t]).norm(), 1e-6);
+      if (t < nsteps) {
+        BOOST_CHECK_SMALL(
+            (fddp.results_.us[t] - fddp_ref.results_.us[t]).norm(), 1e-6);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lqr_proxddp_rti) {
+  const size_t nsteps = 40;
+  const auto nx = 4;
+  const auto nu = 2;
+
+  NormalGen norm_gen;
+  MatrixXd A;
+  A.setIdentity(nx, nx);
+  A.bottomRightCorner<2, 2>() = MatrixXd::NullaryExpr(2, 2, norm_gen);
+  MatrixXd B = MatrixXd::NullaryExpr(nx, nu, norm_gen);
+
+  auto dyn_model = std::make_shared<LinearDynamics>(A, B, VectorXd::Zero(nx));
+  MatrixXd Q = MatrixXd::NullaryExpr(nx, nx, norm_gen);
+  Q = Q.transpose() * Q;
+  VectorXd q = VectorXd::NullaryExpr(nx, norm_gen);
+  MatrixXd R = MatrixXd::Identity(nu, nu);
+  VectorXd r = VectorXd::Zero(nu);
+
+  auto cost = std::make_shared<QuadraticCost>(Q, R, q, r);
+  auto term_cost = std::make_shared<QuadraticCost>(Q * 10., MatrixXd());
+  auto stage = std::make_shared<StageModel>(cost, dyn_model);
+  std::vector<decltype(stage)> stages(nsteps, stage);
+  VectorXd x0 = VectorXd::NullaryExpr(nx, norm_gen);
+  TrajOptProblem problem(x0, stages, term_cost);
+
+  double tol = 1e-6;
+  double mu_init = 1e-8;
+  SolverProxDDP ddp(tol, mu_init);
+  ddp.rollout_type_ = RolloutType::LINEAR;
+  ddp.max_iters = 4;
+  ddp.setup(problem);
+  BOOST_CHECK(ddp.run(problem));
+
+  SolverProxDDP ddp_ref(tol, mu_init);
+  ddp_ref.rollout_type_ = RolloutType::LINEAR;
+  ddp_ref.max_iters = 4;
+
+  for (int k = 0; k < 4; k++) {
+    if (k > 0)
+      ddp.shiftHorizon(problem, stage);
+    ddp.rtiPreparation(problem);
+    // the problem is linear-quadratic: a single step gives the solution
+    x0 = ddp.results_.xs[0] + 0.1 * VectorXd::NullaryExpr(nx, norm_gen);
+    ddp.rtiFeedback(problem, x0);
+    BOOST_CHECK(problem.getInitState().isApprox(x0));
+    BOOST_CHECK(ddp.results_.xs[0].isApprox(x0));
+    BOOST_CHECK_GE(ddp.rti_feedback_time_, 0.);
+
+    ddp_ref.setup(problem);
+    BOOST_CHECK(ddp_ref.run(problem));
+    for (std::size_t t = 0; t <= nsteps; t++) {
+      BOOST_CHECK_SMALL((ddp.results_.xs[t] - ddp_ref.results_.xs[t]).norm(),
+                        1e-5);
+    }
+    for (std::size_t t = 0; t < nsteps; t++) {
+      BOOST_CHECK_SMALL((ddp.results_.us[t] - ddp_ref.results_.us[t]).norm(),
+                        1e-5);
+    }
+  }
+}
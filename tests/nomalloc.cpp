@@ -5,6 +5,15 @@
 #include <aligator/math.hpp>
 #include <aligator/eigen-macros.hpp>
 
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/linear-function.hpp"
+#include "aligator/modelling/costs/quad-costs.hpp"
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/fddp/solver-fddp.hpp"
+#include "aligator/core/solver-util.hpp"
+
+#include <proxsuite-nlp/modelling/constraints.hpp>
+
 BOOST_AUTO_TEST_CASE(begin_end_basic) {
   ALIGATOR_NOMALLOC_BEGIN;
   BOOST_CHECK(!Eigen::internal::is_malloc_allowed());
@@ -43,3 +52,113 @@ BOOST_AUTO_TEST_CASE(nested) {
   ALIGATOR_NOMALLOC_END;
   BOOST_CHECK(Eigen::internal::is_malloc_allowed());
 }
+
+namespace {
+using namespace aligator;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+/// Random LQ problem, with a bound on the controls if @p constrained.
+context::TrajOptProblem createLqrProblem(bool constrained) {
+  const size_t nsteps = 50;
+  const int nx = 4;
+  const int nu = 2;
+  using Space = proxsuite::nlp::VectorSpaceTpl<double>;
+  const auto space = std::make_shared<Space>(nx);
+
+  MatrixXd A = MatrixXd::Identity(nx, nx);
+  A.topRightCorner(nx / 2, nx / 2).setIdentity() *= 0.1;
+  MatrixXd B = MatrixXd::Random(nx, nu);
+  auto dyn = std::make_shared<dynamics::LinearDiscreteDynamicsTpl<double>>(
+      A, B, VectorXd::Zero(nx));
+  MatrixXd Q = MatrixXd::Identity(nx, nx);
+  MatrixXd R = 0.1 * MatrixXd::Identity(nu, nu);
+  VectorXd q = VectorXd::Ones(nx);
+  auto cost = std::make_shared<QuadraticCostTpl<double>>(Q, R, q,
+                                                         VectorXd::Zero(nu));
+  auto term_cost = std::make_shared<QuadraticCostTpl<double>>(
+      10. * Q, MatrixXd(), q, VectorXd());
+
+  auto stage = std::make_shared<context::StageModel>(cost, dyn);
+  if (constrained) {
+    // u - 0.5 <= 0
+    auto func = std::make_shared<LinearFunctionTpl<double>>(
+        MatrixXd::Zero(nu, nx), MatrixXd::Identity(nu, nu),
+        VectorXd::Constant(nu, -0.5));
+    stage->addConstraint(
+        func, std::make_shared<proxsuite::nlp::NegativeOrthantTpl<double>>());
+  }
+  VectorXd x0 = VectorXd::Ones(nx);
+  std::vector<shared_ptr<context::StageModel>> stages(nsteps, stage);
+  return context::TrajOptProblem(x0, stages, term_cost);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(proxddp_run) {
+  for (bool constrained : {false, true}) {
+    auto problem = createLqrProblem(constrained);
+    SolverProxDDPTpl<double> solver(1e-6, 1e-6);
+    solver.verbose_ = QUIET;
+    solver.max_iters = 20;
+    solver.setup(problem);
+    // default-initializing the trajectory allocates: pass an initial guess
+    auto [xs, us, vs, lams] = problemInitializeSolution(problem);
+
+    ALIGATOR_NOMALLOC_BEGIN;
+    bool conv = solver.run(problem, xs, us);
+    ALIGATOR_NOMALLOC_END;
+    BOOST_CHECK(conv);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fddp_run) {
+  auto problem = createLqrProblem(false);
+  SolverFDDPTpl<double> solver(1e-6);
+  solver.verbose_ = QUIET;
+  solver.max_iters = 20;
+  solver.setup(problem);
+  auto [xs, us, vs, lams] = problemInitializeSolution(problem);
+
+  ALIGATOR_NOMALLOC_BEGIN;
+  bool conv = solver.run(problem, xs, us);
+  ALIGATOR_NOMALLOC_END;
+  BOOST_CHECK(conv);
+}
+
+BOOST_AUTO_TEST_CASE(proxddp_run_verbose) {
+  // the logger rows are preallocated: printing them must not allocate either.
+  // A single short solve keeps the test log readable.
+  auto problem = createLqrProblem(false);
+  SolverProxDDPTpl<double> solver(1e-6, 1e-6);
+  solver.verbose_ = VERBOSE;
+  solver.max_iters = 5;
+  solver.setup(problem);
+  auto [xs, us, vs, lams] = problemInitializeSolution(problem);
+
+  ALIGATOR_NOMALLOC_BEGIN;
+  solver.run(problem, xs, us);
+  ALIGATOR_NOMALLOC_END;
+}
+
+BOOST_AUTO_TEST_CASE(shift_and_resume) {
+  auto problem = createLqrProblem(true);
+  SolverProxDDPTpl<double> solver(1e-6, 1e-6);
+  solver.max_iters = 20;
+  solver.setup(problem);
+  auto [xs, us, vs, lams] = problemInitializeSolution(problem);
+  BOOST_CHECK(solver.run(problem, xs, us));
+
+  auto problem2 = createLqrProblem(false);
+  SolverFDDPTpl<double> fddp(1e-6);
+  fddp.max_iters = 20;
+  fddp.setup(problem2);
+  BOOST_CHECK(fddp.run(problem2, xs, us));
+
+  // reusing the dropped stage does not allocate
+  for (int k = 0; k < 3; k++) {
+    ALIGATOR_NOMALLOC_BEGIN;
+    BOOST_CHECK(solver.shiftAndResume(problem, problem.stages_[0]));
+    BOOST_CHECK(fddp.shiftAndResume(problem2, problem2.stages_[0]));
+    ALIGATOR_NOMALLOC_END;
+  }
+}
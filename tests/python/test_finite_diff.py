@@ -1,5 +1,6 @@
 from aligator import (
     FiniteDifferenceHelper,
+    FiniteDifferenceScheme,
     CostFiniteDifference,
     QuadraticStateCost,
     ControlBoxFunction,
@@ -79,6 +80,32 @@ def test_compute_cost_se3():
         assert np.allclose(data.Lu, data_fd.Lu, 1e-2)
 
 
+def test_compute_jac_central_colored():
+    nx = 6
+    nu = 3
+    space = manifolds.VectorSpace(nx)
+    x_tar = space.rand()
+    fun = StateErrorResidual(space, nu, x_tar)
+    fdata = fun.createData()
+    fun_fd = FiniteDifferenceHelper(space, fun, 1e-5)
+    fun_fd.scheme = FiniteDifferenceScheme.CENTRAL
+    fun_fd.num_threads = 2
+    x0 = space.rand()
+    u0 = np.zeros(nu)
+    fun.evaluate(x0, u0, x0, fdata)
+    fun.computeJacobians(x0, u0, x0, fdata)
+    # the state error Jacobian is diagonal: a single evaluation pair
+    fun_fd.setSparsityPattern(fdata.jac_buffer)
+    assert fun_fd.numColors() == 1
+    fdata_fd = fun_fd.createData()
+    fun_fd.evaluate(x0, u0, x0, fdata_fd)
+    fun_fd.computeJacobians(x0, u0, x0, fdata_fd)
+    assert np.allclose(fdata.jac_buffer, fdata_fd.jac_buffer, atol=1e-8)
+
+    fun_fd.clearSparsityPattern()
+    assert fun_fd.numColors() == 2 * nx + nu
+
+
 if __name__ == "__main__":
     import pytest
     import sys
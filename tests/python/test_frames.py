@@ -189,6 +189,49 @@ def test_fly_high():
         assert np.allclose(data.Jx, Jx_nd, THRESH)
 
 
+def test_shared_kinematics():
+    from aligator import dynamics
+
+    fr_id1 = model.getFrameId("larm_shoulder2_body")
+    fr_id2 = model.getFrameId("rleg_elbow_body")
+    space = manifolds.MultibodyPhaseSpace(model)
+    ndx = space.ndx
+    x0 = sample_gauss(space)
+    u0 = np.zeros(nu)
+
+    ode = dynamics.MultibodyFreeFwdDynamics(space, np.eye(nu))
+    dyn = dynamics.IntegratorSemiImplEuler(ode, 0.01)
+    cost = aligator.CostStack(space, nu)
+    plc = aligator.FramePlacementResidual(ndx, nu, model, pin.SE3.Random(), fr_id1)
+    vel = aligator.FrameVelocityResidual(
+        ndx, nu, model, pin.Motion.Random(), fr_id2, pin.LOCAL
+    )
+    fly = aligator.FlyHighResidual(space, fr_id2, 0.1, nu)
+    for fun in (plc, vel, fly):
+        cost.addCost(aligator.QuadraticResidualCost(space, fun, np.eye(fun.nr)))
+    trans = aligator.FrameTranslationResidual(ndx, nu, model, np.zeros(3), fr_id2)
+
+    stage = aligator.StageModel(cost, dyn)
+    stage.addConstraint(trans, aligator.constraints.EqualityConstraintSet())
+    data_ref = stage.createData()
+    assert data_ref.cache_data is None
+
+    stage.cache_model = aligator.KinematicsCacheModel(model, True)
+    data = stage.createData()
+    assert isinstance(data.cache_data, aligator.KinematicsCacheData)
+
+    for _ in range(10):
+        x0 = sample_gauss(space)
+        for d in (data_ref, data):
+            stage.evaluate(x0, u0, x0, d)
+            stage.computeFirstOrderDerivatives(x0, u0, x0, d)
+        assert np.isclose(data.cost_data.value, data_ref.cost_data.value)
+        assert np.allclose(data.cost_data.grad, data_ref.cost_data.grad)
+        cd, cd_ref = data.constraint_data[0], data_ref.constraint_data[0]
+        assert np.allclose(cd.value, cd_ref.value)
+        assert np.allclose(cd.Jx, cd_ref.Jx)
+
+
 if __name__ == "__main__":
     import sys
     import pytest
@@ -85,6 +85,35 @@ def test_slicing():
     assert fs3.indices.tolist() == [1]
 
 
+def test_jacobian_structure():
+    space = manifolds.VectorSpace(4)
+    nu = 2
+    BlockType = aligator.JacobianBlockType
+    fn = aligator.StateErrorResidual(space, nu, space.neutral())
+    js = fn.jac_structure
+    assert js.x.type == BlockType.DIAGONAL
+    assert js.u.isZero()
+    assert js.y.isZero()
+
+    fu = aligator.ControlErrorResidual(space.ndx, np.zeros(nu))
+    assert fu.jac_structure.x.isZero()
+    assert fu.jac_structure.u.type == BlockType.DIAGONAL
+    fs = fu[[1]]
+    assert fs.jac_structure.u.type == BlockType.SELECTION
+    assert fs.jac_structure.u.indices.tolist() == [1]
+
+    A = np.random.randn(3, space.ndx)
+    fl = aligator.LinearFunction(A, np.zeros((3, nu)), np.zeros(3))
+    assert fl.jac_structure.x.type == BlockType.DENSE
+    assert fl.jac_structure.u.isZero()
+    # the structure follows the matrices
+    fl.B = np.ones((3, nu))
+    assert fl.jac_structure.u.type == BlockType.DENSE
+    fl.A = np.zeros((3, space.ndx))
+    assert fl.jac_structure.x.isZero()
+    assert np.allclose(fl.B, 1.0)
+
+
 if __name__ == "__main__":
     import sys
 
@@ -0,0 +1,43 @@
+import numpy as np
+import pytest
+
+from aligator import gar
+
+
+def test_knot_data_views():
+    nx, nu = 3, 2
+    knots = []
+    for _ in range(4):
+        knot = gar.LQRKnot(nx, nu, 0)
+        knot.Q = np.eye(nx)
+        knot.A = 2.0 * np.eye(nx)
+        knot.E = -np.eye(nx)
+        knots.append(knot)
+    prob = gar.LQRProblem(knots, 0)
+
+    # the data are views into the problem arena: in-place writes go through
+    Q = prob.stages[1].Q
+    assert np.allclose(Q, np.eye(nx))
+    Q[0, 0] = -1.0
+    assert prob.stages[1].Q[0, 0] == -1.0
+    prob.stages[1].q[:] = 1.0
+    assert np.allclose(prob.stages[1].q, 1.0)
+    with pytest.raises(RuntimeError):
+        prob.stages[1].Q = np.eye(nx + 1)
+
+    # the views are invalidated by a reallocation of the arena: fetch them again
+    prob.addParameterization(nx)
+    prob.makeContiguous()
+    assert prob.stages[1].Q[0, 0] == -1.0
+    assert np.allclose(prob.stages[1].q, 1.0)
+
+    prob.stages[1].Q = 3.0 * np.eye(nx)
+    assert np.allclose(prob.stages[1].Q, 3.0 * np.eye(nx))
+    assert np.allclose(prob.stages[1].A, 2.0 * np.eye(nx))
+    prob.stages[1].Gx[:] = np.eye(nx)
+    assert np.allclose(prob.stages[1].Gx, np.eye(nx))
+
+if __name__ == "__main__":
+    import sys
+
+    sys.exit(pytest.main(sys.argv))
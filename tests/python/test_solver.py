@@ -61,7 +61,9 @@ def test_no_node():
 
 
 @pytest.mark.parametrize("strategy", [aligator.SA_FILTER, aligator.SA_LINESEARCH])
-def test_proxddp_lqr(strategy):
+@pytest.mark.parametrize("ls_num_candidates", [1, 3])
+@pytest.mark.parametrize("max_refinement_steps", [0, 2])
+def test_proxddp_lqr(strategy, ls_num_candidates, max_refinement_steps):
     nx = 3
     nu = 3
     space = VectorSpace(nx)
@@ -101,6 +103,8 @@ def test_proxddp_lqr(strategy):
     tol = 1e-6
     mu_init = 1e-4
     solver = aligator.SolverProxDDP(tol, mu_init, 0.0, verbose=aligator.VERBOSE)
+    solver.ls_num_candidates = ls_num_candidates
+    solver.max_refinement_steps = max_refinement_steps
     solver.setup(problem)
     solver.sa_strategy = strategy
     solver.max_iters = 3
@@ -112,5 +116,71 @@ def test_proxddp_lqr(strategy):
     assert conv
 
 
+class StepSizeCallback(aligator.BaseCallback):
+    def __init__(self):
+        super().__init__()
+        self.alphas = []
+        self.xs = []
+
+    def call(self, workspace, results):
+        self.alphas.append(workspace.trial_alpha)
+        self.xs.append([x.copy() for x in results.xs])
+
+
+def test_proxddp_speculative_linesearch():
+    """The speculative linesearch must take the same steps as the serial one,
+    on a problem where the full step gets rejected."""
+    nx = 9
+    space = VectorSpace(nx)
+    contact_poses = [
+        np.array([0.0, 0.1, 0.0]),
+        np.array([0.1, -0.1, 0.0]),
+        np.array([0.1, 0.2, 0.0]),
+    ]
+    contact_map = aligator.ContactMap([True] * 3, contact_poses)
+    nu = 3 * contact_map.size
+    # bilinear dynamics: the torques are cross products of the CoM position
+    # and of the contact forces
+    ode = aligator.dynamics.CentroidalFwdDynamics(
+        space, 10.5, np.array([0, 0, -9.81]), contact_map, 3
+    )
+    dyn = aligator.dynamics.IntegratorEuler(ode, 0.02)
+
+    x0 = space.neutral()
+    x0[2] = 0.5
+    xf = space.neutral()
+    xf[:3] = (0.3, 0.2, 1.0)
+    xf[6:] = (1.0, -1.0, 0.5)
+    run_cost = aligator.CostStack(space, nu)
+    run_cost.addCost(aligator.QuadraticCost(np.zeros((nx, nx)), 1e-3 * np.eye(nu)))
+    run_cost.addCost(aligator.QuadraticStateCost(space, nu, xf, np.eye(nx)))
+    term_cost = aligator.QuadraticStateCost(space, nu, xf, 10 * np.eye(nx))
+
+    nsteps = 20
+    stages = [aligator.StageModel(run_cost, dyn)] * nsteps
+    problem = aligator.TrajOptProblem(x0, stages, term_cost)
+
+    runs = []
+    for ls_num_candidates in (1, 3):
+        solver = aligator.SolverProxDDP(1e-6, 1e-4, max_iters=10)
+        solver.rollout_type = aligator.ROLLOUT_LINEAR
+        solver.ls_params.interp_type = aligator.LSInterpolation.BISECTION
+        solver.ls_params.contraction_min = 0.5
+        solver.ls_num_candidates = ls_num_candidates
+        solver.setNumThreads(ls_num_candidates)
+        cb = StepSizeCallback()
+        solver.registerCallback("steps", cb)
+        solver.setup(problem)
+        solver.run(problem)
+        runs.append(cb)
+
+    serial, speculative = runs
+    assert min(serial.alphas) < 1.0
+    assert serial.alphas == speculative.alphas
+    for xs_ser, xs_spec in zip(serial.xs, speculative.xs):
+        for x_ser, x_spec in zip(xs_ser, xs_spec):
+            assert np.allclose(x_ser, x_spec)
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main(sys.argv))
@@ -1,4 +1,8 @@
 #include "aligator/utils/newton-raphson.hpp"
+#include "aligator/modelling/state-error.hpp"
+#include "aligator/modelling/function-xpr-slice.hpp"
+#include "aligator/modelling/linear-function.hpp"
+#include "aligator/threads.hpp"
 
 #include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
 
@@ -51,4 +55,105 @@ BOOST_AUTO_TEST_CASE(newton_raphson) {
   BOOST_TEST_CHECK(xout.isApprox(xans, eps));
 }
 
+BOOST_AUTO_TEST_CASE(jacobian_structure) {
+  const int ndx = 5;
+  const int nu = 3;
+  using ControlError = ControlErrorResidualTpl<Scalar>;
+  using StateError = StateErrorResidualTpl<Scalar>;
+  using Slice = FunctionSliceXprTpl<Scalar>;
+  using UnarySlice = FunctionSliceXprTpl<Scalar, UnaryFunctionTpl<Scalar>>;
+  auto space = std::make_shared<proxsuite::nlp::VectorSpaceTpl<Scalar>>(ndx);
+  const VectorXs x0 = space->rand();
+  const VectorXs u0 = VectorXs::Random(nu);
+
+  auto fu = std::make_shared<ControlError>(ndx, VectorXs::Random(nu));
+  auto fx = std::make_shared<StateError>(space, nu, space->rand());
+  const std::vector<int> rows{2, 0};
+  std::vector<shared_ptr<StageFunctionTpl<Scalar>>> funcs{
+      fu, fx, std::make_shared<Slice>(fu, rows),
+      std::make_shared<UnarySlice>(fx, rows)};
+
+  BOOST_CHECK(fu->jac_structure_.x.isZero());
+  BOOST_CHECK(fu->jac_structure_.u.type == JacobianBlockType::DIAGONAL);
+  BOOST_CHECK(fx->jac_structure_.x.type == JacobianBlockType::DIAGONAL);
+  BOOST_CHECK(fx->jac_structure_.u.isZero());
+  BOOST_CHECK(funcs[2]->jac_structure_.u.indices == rows);
+  BOOST_CHECK(funcs[3]->jac_structure_.x.indices == rows);
+
+  for (const auto &f : funcs) {
+    auto data = f->createData();
+    f->evaluate(x0, u0, x0, *data);
+    f->computeJacobians(x0, u0, x0, *data);
+    const VectorXs v = VectorXs::Random(f->nr);
+    VectorXs outx = VectorXs::Ones(ndx);
+    VectorXs outu = VectorXs::Ones(nu);
+    jacobianTransposeMultiplyAdd(f->jac_structure_.x, data->Jx_, v, outx);
+    jacobianTransposeMultiplyAdd(f->jac_structure_.u, data->Ju_, v, outu);
+    BOOST_CHECK(outx.isApprox(VectorXs::Ones(ndx) + data->Jx_.transpose() * v));
+    BOOST_CHECK(outu.isApprox(VectorXs::Ones(nu) + data->Ju_.transpose() * v));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(linear_function_structure) {
+  const int ndx = 4;
+  const int nu = 2;
+  const int nr = 3;
+  LinearFunctionTpl<Scalar> f(ndx, nu, ndx, nr);
+  BOOST_CHECK(f.jac_structure_.x.isZero());
+  BOOST_CHECK(f.jac_structure_.u.isZero());
+  BOOST_CHECK(f.jac_structure_.y.isZero());
+
+  // the structure follows the matrices
+  f.setA(MatrixXs::Random(nr, ndx));
+  f.setC(MatrixXs::Random(nr, ndx));
+  BOOST_CHECK(f.jac_structure_.x.type == JacobianBlockType::DENSE);
+  BOOST_CHECK(f.jac_structure_.y.type == JacobianBlockType::DENSE);
+  f.setC(MatrixXs::Zero(nr, ndx));
+  BOOST_CHECK(f.jac_structure_.y.isZero());
+  BOOST_CHECK(f.jac_structure_.u.isZero());
+  BOOST_CHECK_THROW(f.setB(MatrixXs::Random(nr, nu + 1)), std::domain_error);
+
+  const VectorXs x0 = VectorXs::Random(ndx);
+  const VectorXs u0 = VectorXs::Random(nu);
+  auto data = f.createData();
+  f.computeJacobians(x0, u0, x0, *data);
+  BOOST_CHECK(data->Jx_.isApprox(f.getA()));
+  BOOST_CHECK(data->Jy_.isZero());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_eigen_threads) {
+  // pinned within the affinity mask of the process
+  ThreadPool pool(3, true);
+  const int nb_threads = Eigen::nbThreads();
+  Eigen::setNbThreads(2);
+  std::vector<int> inner(8, -1);
+  parallel_for(&pool, 3, 4, [&](std::size_t i) {
+    parallel_for(nullptr, 2, 2, [&](std::size_t j) {
+      inner[2 * i + j] = Eigen::nbThreads();
+    });
+  });
+  for (int n : inner)
+    BOOST_CHECK_EQUAL(n, 1);
+  // restored once the outermost loop is done
+  BOOST_CHECK_EQUAL(Eigen::nbThreads(), 2);
+  Eigen::setNbThreads(nb_threads);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_exceptions) {
+  ThreadPool pool(3, true);
+  BOOST_CHECK(pool.pinsThreads());
+  // both backends rethrow after running every index
+  for (ThreadPool *p : {(ThreadPool *)nullptr, &pool}) {
+    std::atomic<int> count{0};
+    BOOST_CHECK_THROW(parallel_for(p, 3, 8,
+                                   [&](std::size_t i) {
+                                     count++;
+                                     if (i % 3 == 1)
+                                       throw std::runtime_error("fail");
+                                   }),
+                      std::runtime_error);
+    BOOST_CHECK_EQUAL(count.load(), 8);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()